@@ -0,0 +1,32 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "types.h"
+#include "game/terrain.h"
+#include "core/rng.h"
+
+// Shared fixtures for the benchmark runner. The runner links only the
+// headless simulation library, so benchmarks never need a window or GPU.
+
+// Wall clock in seconds
+double bench_now(void);
+
+// Map of the given size filled with plains
+Map *bench_create_map(int width, int height, Terrain *terrains);
+
+// Heap allocations made so far by this process, or -1 when the build does
+// not count them (see bench_alloc.c)
+long long bench_alloc_count(void);
+
+// Individual benchmarks: return 0 on success, non-zero on a result mismatch
+int bench_spatial(int argc, char **argv);
+int bench_generation(int argc, char **argv);
+int bench_deep_terrain(int argc, char **argv);
+int bench_pipeline(int argc, char **argv);
+int bench_noise(int argc, char **argv);
+int bench_suite(int argc, char **argv);
+
+// Compares two suite JSON files; returns non-zero when a case regressed
+int bench_compare(int argc, char **argv);
+
+#endif
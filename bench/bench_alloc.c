@@ -0,0 +1,42 @@
+#include "bench.h"
+#include <stddef.h>
+
+// Heap allocation counter. With BENCH_COUNT_ALLOCS the premake linux build
+// links with --wrap=malloc,--wrap=calloc,--wrap=realloc, which routes every
+// allocation made by the simulation library and the benchmarks through the
+// wrappers below. Elsewhere counting is unavailable.
+
+#if defined(BENCH_COUNT_ALLOCS)
+
+static long long alloc_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    __atomic_fetch_add(&alloc_count, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&alloc_count, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    __atomic_fetch_add(&alloc_count, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+long long bench_alloc_count(void) {
+    return __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+}
+
+#else
+
+long long bench_alloc_count(void) {
+    return -1;
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "bench.h"
+#include "game/map.h"
+#include "game/biome_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int SIDES[][2] = {{30, 20}, {256, 256}, {1024, 1024}};
+static const int REPEATS = 5;
+
+// Forward declarations for internal helper functions
+static void legacy_generate_deep_ter(Map *map);
+static void generate_biomes(Map *map, unsigned seed);
+
+int bench_deep_terrain(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    int status = 0;
+
+    Terrain terrains[TERRAIN_COUNT];
+    terrain_init_all(terrains);
+
+    printf("%11s %12s %12s %9s\n", "map", "per-cell ms", "kernel ms", "speedup");
+
+    for (size_t i = 0; i < sizeof(SIDES) / sizeof(SIDES[0]); i++) {
+        int width = SIDES[i][0];
+        int height = SIDES[i][1];
+        Map *kernel = bench_create_map(width, height, terrains);
+        Map *legacy = bench_create_map(width, height, terrains);
+        if (kernel == NULL || legacy == NULL) return 1;
+
+        double kernel_time = 0.0;
+        double legacy_time = 0.0;
+
+        for (int r = 0; r < REPEATS; r++) {
+            unsigned seed = 2000u + (unsigned)r;
+            generate_biomes(kernel, seed);
+            generate_biomes(legacy, seed);
+
+            double t0 = bench_now();
+            legacy_generate_deep_ter(legacy);
+            double t1 = bench_now();
+            map_generate_deep_ter_threads(kernel, 1);
+            double t2 = bench_now();
+
+            legacy_time += t1 - t0;
+            kernel_time += t2 - t1;
+
+            if (memcmp(kernel->terrain, legacy->terrain, kernel->cell_count) != 0) {
+                fprintf(stderr, "Error: deep terrain differs (%dx%d, seed %u)\n", width, height, seed);
+                status = 1;
+            }
+        }
+
+        char map_name[16];
+        snprintf(map_name, sizeof(map_name), "%dx%d", width, height);
+        double legacy_ms = legacy_time * 1e3 / REPEATS;
+        double kernel_ms = kernel_time * 1e3 / REPEATS;
+        printf("%11s %12.3f %12.3f %8.1fx\n", map_name, legacy_ms, kernel_ms, legacy_ms / kernel_ms);
+
+        map_free(kernel);
+        map_free(legacy);
+    }
+    return status;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// The original in-place pass, kept as the reference implementation
+static void legacy_generate_deep_ter(Map *map) {
+    for (int cell = 0; cell < map->cell_count; cell++) {
+        if (!map_is_valid_cell(map, cell)) continue;
+        if (map_all_8_neighs_terrain(map, cell)) {
+            map_set_terrain(map, cell, map_get_terrain(map, cell)->deep_version);
+        }
+    }
+}
+
+// Biomes dense enough that large areas qualify for deep terrain
+static void generate_biomes(Map *map, unsigned seed) {
+    BiomeConfig configs[3];
+    int num_biomes = biome_config_get_default(configs, 3);
+    int layers = map->width * map->height / 200 + 1;
+
+    map_init_cells(map, TERRAIN_PLAINS);
+    Rng rng;
+    rng_seed(&rng, seed, RNG_STREAM_MAP);
+    map_generate_all_biomes(map, &rng, configs, num_biomes, layers);
+}
@@ -0,0 +1,161 @@
+#include "bench.h"
+#include "game/map.h"
+#include "game/biome_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct GenerationCase {
+    int width;
+    int height;
+    int layers;
+    int max_range;
+} GenerationCase;
+
+static const GenerationCase CASES[] = {
+    {30, 20, 3, 5},     // what main.c generates today
+    {30, 20, 8, 5},
+    {64, 64, 3, 8},
+    {64, 64, 8, 8},
+    {128, 128, 4, 10},
+    {128, 128, 16, 10},
+    {256, 256, 8, 24},  // continent sized: only feasible without the recursion
+};
+
+// Above this range the recursive flood takes far too long to be worth timing
+static const int LEGACY_MAX_RANGE = 10;
+static const int REPEATS = 5;
+
+// Forward declarations for internal helper functions
+static void legacy_spread_terrain(Map *map, int start_cell, int range, int terrain_type,
+                                  long long *writes);
+static void legacy_generate_all_biomes(Map *map, Rng *rng, BiomeConfig *configs, int num_biomes,
+                                       int layers, long long *writes);
+static int apply_max_range(BiomeConfig *configs, int max_range);
+
+int bench_generation(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    int status = 0;
+
+    Terrain terrains[TERRAIN_COUNT];
+    terrain_init_all(terrains);
+
+    printf("%9s %6s %5s %12s %14s %12s %9s\n", "map", "layers", "range",
+           "legacy ms", "legacy writes", "stamp ms", "speedup");
+
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        const GenerationCase *gc = &CASES[i];
+        BiomeConfig configs[3];
+        int num_biomes = apply_max_range(configs, gc->max_range);
+
+        Map *stamp = bench_create_map(gc->width, gc->height, terrains);
+        Map *legacy = bench_create_map(gc->width, gc->height, terrains);
+        if (stamp == NULL || legacy == NULL) return 1;
+
+        double stamp_time = 0.0;
+        double legacy_time = 0.0;
+        long long writes = 0;
+        bool run_legacy = gc->max_range <= LEGACY_MAX_RANGE;
+
+        for (int r = 0; r < REPEATS; r++) {
+            unsigned seed = 1000u + (unsigned)r;
+
+            Rng rng;
+            map_init_cells(stamp, TERRAIN_PLAINS);
+            rng_seed(&rng, seed, RNG_STREAM_MAP);
+            double t0 = bench_now();
+            map_generate_all_biomes(stamp, &rng, configs, num_biomes, gc->layers);
+            stamp_time += bench_now() - t0;
+
+            if (!run_legacy) continue;
+
+            map_init_cells(legacy, TERRAIN_PLAINS);
+            rng_seed(&rng, seed, RNG_STREAM_MAP);
+            t0 = bench_now();
+            legacy_generate_all_biomes(legacy, &rng, configs, num_biomes, gc->layers, &writes);
+            legacy_time += bench_now() - t0;
+
+            // Same seed must give the same map
+            if (memcmp(stamp->terrain, legacy->terrain, stamp->cell_count) != 0) {
+                fprintf(stderr, "Error: stamp and legacy maps differ (%dx%d, seed %u)\n",
+                        gc->width, gc->height, seed);
+                status = 1;
+            }
+        }
+
+        char map_name[16];
+        snprintf(map_name, sizeof(map_name), "%dx%d", gc->width, gc->height);
+        double stamp_ms = stamp_time * 1e3 / REPEATS;
+        if (run_legacy) {
+            double legacy_ms = legacy_time * 1e3 / REPEATS;
+            printf("%9s %6d %5d %12.3f %14lld %12.3f %8.1fx\n", map_name, gc->layers, gc->max_range,
+                   legacy_ms, writes / REPEATS, stamp_ms, legacy_ms / stamp_ms);
+        } else {
+            printf("%9s %6d %5d %12s %14s %12.3f %9s\n", map_name, gc->layers, gc->max_range,
+                   "-", "-", stamp_ms, "-");
+        }
+
+        map_free(stamp);
+        map_free(legacy);
+    }
+    return status;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// The original recursive four-way flood, kept as the reference implementation
+static void legacy_spread_terrain(Map *map, int start_cell, int range, int terrain_type,
+                                  long long *writes) {
+    map_set_terrain(map, start_cell, terrain_type);
+    (*writes)++;
+    if (range == 0) return;
+
+    int x = map_cell_x(map, start_cell);
+    int y = map_cell_y(map, start_cell);
+    int neighbor;
+
+    if ((neighbor = map_get_cell(map, x, y - 1)) != MAP_NO_CELL) {
+        legacy_spread_terrain(map, neighbor, range - 1, terrain_type, writes);
+    }
+    if ((neighbor = map_get_cell(map, x, y + 1)) != MAP_NO_CELL) {
+        legacy_spread_terrain(map, neighbor, range - 1, terrain_type, writes);
+    }
+    if ((neighbor = map_get_cell(map, x - 1, y)) != MAP_NO_CELL) {
+        legacy_spread_terrain(map, neighbor, range - 1, terrain_type, writes);
+    }
+    if ((neighbor = map_get_cell(map, x + 1, y)) != MAP_NO_CELL) {
+        legacy_spread_terrain(map, neighbor, range - 1, terrain_type, writes);
+    }
+}
+
+// Mirrors map_generate_all_biomes so both consume the stream identically
+static void legacy_generate_all_biomes(Map *map, Rng *rng, BiomeConfig *configs, int num_biomes,
+                                       int layers, long long *writes) {
+    for (int layer = 0; layer < layers; layer++) {
+        for (int i = 0; i < num_biomes; i++) {
+            int num_cores = rng_range(rng, configs[i].max_cores + 1);
+            for (int c = 0; c < num_cores; c++) {
+                int core = map_get_random_cell(map, rng);
+                int range = rng_range(rng, configs[i].max_range) + 1;
+                legacy_spread_terrain(map, core, range, configs[i].terrain, writes);
+            }
+        }
+    }
+}
+
+// Default biomes with their ranges scaled so the largest equals max_range
+static int apply_max_range(BiomeConfig *configs, int max_range) {
+    int count = biome_config_get_default(configs, 3);
+    int largest = 1;
+    for (int i = 0; i < count; i++) {
+        if (configs[i].max_range > largest) largest = configs[i].max_range;
+    }
+    for (int i = 0; i < count; i++) {
+        int scaled = configs[i].max_range * max_range / largest;
+        configs[i].max_range = (scaled < 1) ? 1 : scaled;
+    }
+    return count;
+}
@@ -0,0 +1,79 @@
+#include "bench.h"
+#include "game/map.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct BenchEntry {
+    const char *name;
+    int (*run)(int argc, char **argv);
+    const char *description;
+} BenchEntry;
+
+static const BenchEntry BENCHES[] = {
+    {"spatial", bench_spatial, "nearest-enemy / enemies-in-range: spatial index vs full scans"},
+    {"generation", bench_generation, "biome spreading: diamond stamp vs recursive flood"},
+    {"deep", bench_deep_terrain, "deep terrain pass: 3x3 kernel vs per-cell neighbour checks"},
+    {"pipeline", bench_pipeline, "threaded map generation: scaling from 1 to N threads"},
+    {"noise", bench_noise, "terrain backends: noise fields vs biome cores"},
+    {"suite", bench_suite, "engine hot paths: ns/op, allocations, cells visited [--json file]"},
+};
+
+static const int BENCH_COUNT = sizeof(BENCHES) / sizeof(BENCHES[0]);
+
+static void print_usage(const char *program) {
+    printf("Usage: %s <benchmark|all> [options]\n\nBenchmarks:\n", program);
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        printf("  %-12s %s\n", BENCHES[i].name, BENCHES[i].description);
+    }
+    printf("\n  %s compare <baseline.json> <current.json> [--threshold PCT]\n", program);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Not a benchmark: diffs two `suite --json` result files
+    if (strcmp(argv[1], "compare") == 0) {
+        return bench_compare(argc - 1, argv + 1);
+    }
+
+    bool run_all = (strcmp(argv[1], "all") == 0);
+    int status = 0;
+    bool matched = false;
+
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        if (!run_all && strcmp(argv[1], BENCHES[i].name) != 0) continue;
+        matched = true;
+        printf("=== %s ===\n", BENCHES[i].name);
+        if (BENCHES[i].run(argc - 1, argv + 1) != 0) {
+            status = 1;
+        }
+    }
+
+    if (!matched) {
+        fprintf(stderr, "Error: Unknown benchmark '%s'\n", argv[1]);
+        print_usage(argv[0]);
+        return 1;
+    }
+    return status;
+}
+
+// ============================================================================
+// Shared Fixtures
+// ============================================================================
+
+double bench_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+Map *bench_create_map(int width, int height, Terrain *terrains) {
+    GridConfig grid = {0};
+    grid.max_grid_cells_x = width;
+    grid.max_grid_cells_y = height;
+    return map_create(&grid, terrains, TERRAIN_PLAINS);
+}
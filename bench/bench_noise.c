@@ -0,0 +1,95 @@
+#include "bench.h"
+#include "game/map.h"
+#include "game/map_generation.h"
+#include "game/biome_config.h"
+#include "core/parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int SIDES[][2] = {{256, 256}, {1024, 1024}, {4096, 4096}};
+static const int REPEATS = 3;
+static const uint64_t SEED = 777;
+
+// Single-core budget for a 1024x1024 noise map
+static const double NOISE_BUDGET_MS = 100.0;
+
+// Forward declarations for internal helper functions
+static double time_generation(Map *map, MapGenSettings *settings, uint64_t *out_hash);
+
+// Usage: bench noise [max_threads]. Compares the noise backend with the
+// cores backend on one thread, then runs noise on max_threads (default: one
+// per core) and checks it produced the same map.
+int bench_noise(int argc, char **argv) {
+    int max_threads = (argc > 1) ? atoi(argv[1]) : parallel_cpu_count();
+    if (max_threads < 1) max_threads = 1;
+    int status = 0;
+
+    Terrain terrains[TERRAIN_COUNT];
+    terrain_init_all(terrains);
+
+    BiomeConfig configs[3];
+    int num_biomes = biome_config_get_default(configs, 3);
+
+    printf("%11s %10s %10s %14s %9s\n", "map", "cores ms", "noise ms", "noise N thr ms", "speedup");
+
+    for (size_t i = 0; i < sizeof(SIDES) / sizeof(SIDES[0]); i++) {
+        int width = SIDES[i][0];
+        int height = SIDES[i][1];
+        Map *map = bench_create_map(width, height, terrains);
+        if (map == NULL) return 1;
+
+        MapGenSettings settings = {0};
+        settings.seed = SEED;
+        settings.biomes = configs;
+        settings.num_biomes = num_biomes;
+        settings.layers = (int)(7LL * width * height / 600);
+        settings.threads = 1;
+
+        uint64_t serial_hash, threaded_hash, unused;
+        settings.generator = MAP_GENERATOR_CORES;
+        double cores_ms = time_generation(map, &settings, &unused);
+        settings.generator = MAP_GENERATOR_NOISE;
+        double noise_ms = time_generation(map, &settings, &serial_hash);
+        settings.threads = max_threads;
+        double threaded_ms = time_generation(map, &settings, &threaded_hash);
+
+        char map_name[16];
+        snprintf(map_name, sizeof(map_name), "%dx%d", width, height);
+        printf("%11s %10.2f %10.2f %14.2f %8.1fx\n", map_name, cores_ms, noise_ms, threaded_ms,
+               cores_ms / noise_ms);
+
+        if (threaded_hash != serial_hash) {
+            fprintf(stderr, "Error: %s noise map differs with %d threads\n", map_name, max_threads);
+            status = 1;
+        }
+        if (width == 1024 && height == 1024 && noise_ms > NOISE_BUDGET_MS) {
+            fprintf(stderr, "Error: 1024x1024 noise map took %.2f ms on one thread (budget %.0f ms)\n",
+                    noise_ms, NOISE_BUDGET_MS);
+            status = 1;
+        }
+        map_free(map);
+    }
+    return status;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Average milliseconds per run; hashes the map of the last run
+static double time_generation(Map *map, MapGenSettings *settings, uint64_t *out_hash) {
+    double total = 0.0;
+    for (int r = 0; r < REPEATS; r++) {
+        map_init_cells(map, TERRAIN_PLAINS);
+        double t0 = bench_now();
+        map_generation_run(map, settings);
+        total += bench_now() - t0;
+    }
+
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (int cell = 0; cell < map->cell_count; cell++) {
+        hash = (hash ^ map->terrain[cell]) * 0x100000001B3ULL;
+    }
+    *out_hash = hash;
+    return total * 1e3 / REPEATS;
+}
@@ -0,0 +1,101 @@
+#include "bench.h"
+#include "game/map.h"
+#include "game/map_generation.h"
+#include "game/biome_config.h"
+#include "core/parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int SIDES[][2] = {{1024, 1024}, {2048, 2048}, {4096, 4096}};
+static const int REPEATS = 3;
+static const uint64_t SEED = 4242;
+
+// Forward declarations for internal helper functions
+static uint64_t hash_terrain(Map *map);
+
+// Usage: bench pipeline [max_threads]. Thread counts double from 1 up to
+// max_threads (default: one per core), and every run must produce the
+// same map as the single-threaded one.
+int bench_pipeline(int argc, char **argv) {
+    int max_threads = (argc > 1) ? atoi(argv[1]) : parallel_cpu_count();
+    if (max_threads < 1) max_threads = 1;
+    int status = 0;
+
+    Terrain terrains[TERRAIN_COUNT];
+    terrain_init_all(terrains);
+
+    BiomeConfig configs[3];
+    int num_biomes = biome_config_get_default(configs, 3);
+
+    printf("%11s %8s %11s %11s %11s %9s\n", "map", "threads", "biomes ms", "deep ms", "total ms",
+           "speedup");
+
+    for (size_t i = 0; i < sizeof(SIDES) / sizeof(SIDES[0]); i++) {
+        int width = SIDES[i][0];
+        int height = SIDES[i][1];
+        Map *map = bench_create_map(width, height, terrains);
+        if (map == NULL) return 1;
+
+        MapGenSettings settings = {0};
+        settings.seed = SEED;
+        settings.biomes = configs;
+        settings.num_biomes = num_biomes;
+        // Same density as a default match: 7 layers per 30x20 cells
+        settings.layers = (int)(7LL * width * height / 600);
+
+        char map_name[16];
+        snprintf(map_name, sizeof(map_name), "%dx%d", width, height);
+        uint64_t reference = 0;
+        double serial_ms = 0.0;
+
+        for (int threads = 1; ; threads = (threads * 2 > max_threads) ? max_threads : threads * 2) {
+            settings.threads = threads;
+            double biome_time = 0.0;
+            double deep_time = 0.0;
+
+            for (int r = 0; r < REPEATS; r++) {
+                map_init_cells(map, TERRAIN_PLAINS);
+                double t0 = bench_now();
+                map_generation_biomes(map, &settings);
+                double t1 = bench_now();
+                map_generation_deep_terrain(map, &settings);
+                double t2 = bench_now();
+                biome_time += t1 - t0;
+                deep_time += t2 - t1;
+            }
+
+            // Thread count must never change the result
+            uint64_t hash = hash_terrain(map);
+            if (threads == 1) {
+                reference = hash;
+            } else if (hash != reference) {
+                fprintf(stderr, "Error: %s map differs with %d threads\n", map_name, threads);
+                status = 1;
+            }
+
+            double biome_ms = biome_time * 1e3 / REPEATS;
+            double deep_ms = deep_time * 1e3 / REPEATS;
+            double total_ms = biome_ms + deep_ms;
+            if (threads == 1) serial_ms = total_ms;
+            printf("%11s %8d %11.2f %11.2f %11.2f %8.2fx\n", map_name, threads, biome_ms, deep_ms,
+                   total_ms, serial_ms / total_ms);
+
+            if (threads == max_threads) break;
+        }
+        map_free(map);
+    }
+    return status;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// FNV-1a over every terrain slot (padding slots are always TERRAIN_NONE)
+static uint64_t hash_terrain(Map *map) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (int cell = 0; cell < map->cell_count; cell++) {
+        hash = (hash ^ map->terrain[cell]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,203 @@
+#include "bench.h"
+#include "game/map.h"
+#include "game/actor.h"
+#include "game/spatial_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Total units, split over two factions on a map sized for ~10% occupancy
+static const int UNIT_COUNTS[] = {100, 1000, 10000};
+static const int QUERY_RANGE = 3;
+static const int MAX_QUERIES = 1000;
+
+typedef struct SpatialFixture {
+    Terrain terrains[TERRAIN_COUNT];
+    Faction factions[2];
+    Map *map;
+    Rng rng;
+} SpatialFixture;
+
+// Forward declarations for internal helper functions
+static bool fixture_create(SpatialFixture *fx, int units);
+static void fixture_free(SpatialFixture *fx);
+static int scan_nearest_enemy(Map *map, Actor *actor, int max_dist);
+static int scan_enemies_within(Map *map, int cell, int faction_id, int range);
+static int verify_queries(SpatialFixture *fx, int *out_buffer);
+static void churn(SpatialFixture *fx, int moves, int deaths);
+
+int bench_spatial(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    int status = 0;
+
+    printf("%8s %8s %12s %12s %12s %12s\n", "units", "map",
+           "scan ns/q", "index ns/q", "scan r3 ns", "index r3 ns");
+
+    for (size_t u = 0; u < sizeof(UNIT_COUNTS) / sizeof(UNIT_COUNTS[0]); u++) {
+        SpatialFixture fx;
+        int units = UNIT_COUNTS[u] / 2;
+        if (!fixture_create(&fx, units)) return 1;
+
+        Faction *attackers = &fx.factions[0];
+        int queries = (attackers->actor_count < MAX_QUERIES) ? attackers->actor_count : MAX_QUERIES;
+        int *buffer = malloc(sizeof(int) * units * 2);
+        long long sink = 0;
+
+        double t0 = bench_now();
+        for (int q = 0; q < queries; q++) {
+            sink += scan_nearest_enemy(fx.map, &attackers->actors[q], -1);
+        }
+        double t1 = bench_now();
+        for (int q = 0; q < queries; q++) {
+            sink += spatial_index_nearest_enemy(fx.map->spatial, fx.map, &attackers->actors[q], -1);
+        }
+        double t2 = bench_now();
+        for (int q = 0; q < queries; q++) {
+            sink += scan_enemies_within(fx.map, attackers->actors[q].cell, 0, QUERY_RANGE);
+        }
+        double t3 = bench_now();
+        for (int q = 0; q < queries; q++) {
+            sink += spatial_index_enemies_within(fx.map->spatial, fx.map, attackers->actors[q].cell,
+                                                 0, QUERY_RANGE, buffer, units * 2);
+        }
+        double t4 = bench_now();
+
+        printf("%8d %4dx%-4d %12.0f %12.0f %12.0f %12.0f\n", units * 2, fx.map->width, fx.map->height,
+               (t1 - t0) * 1e9 / queries, (t2 - t1) * 1e9 / queries,
+               (t3 - t2) * 1e9 / queries, (t4 - t3) * 1e9 / queries);
+
+        // The index must agree with the full scans, also after moves and deaths
+        int mismatches = verify_queries(&fx, buffer);
+        churn(&fx, units, units / 4);
+        mismatches += verify_queries(&fx, buffer);
+        if (mismatches > 0) {
+            fprintf(stderr, "Error: %d spatial index mismatches at %d units\n", mismatches, units * 2);
+            status = 1;
+        }
+
+        if (sink == 42) printf(" ");
+        free(buffer);
+        fixture_free(&fx);
+    }
+    return status;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static bool fixture_create(SpatialFixture *fx, int units) {
+    rng_seed(&fx->rng, 1234, RNG_STREAM_SPAWNING);
+    terrain_init_all(fx->terrains);
+
+    int side = (int)ceil(sqrt(units * 2 * 10.0));
+    fx->map = bench_create_map(side, side, fx->terrains);
+    if (fx->map == NULL) return false;
+
+    for (int f = 0; f < 2; f++) {
+        Faction *faction = &fx->factions[f];
+        *faction = (Faction){0};
+        faction->id = f;
+        faction->actor_count = units;
+        faction->actors = calloc(units, sizeof(Actor));
+        if (faction->actors == NULL) {
+            fprintf(stderr, "Error: Failed to allocate benchmark actors\n");
+            return false;
+        }
+        for (int i = 0; i < units; i++) {
+            Actor *actor = &faction->actors[i];
+            militia_init(actor, faction, SPRITE_NONE);
+            int cell;
+            do {
+                cell = map_get_random_cell(fx->map, &fx->rng);
+            } while (map_is_cell_occupied(fx->map, cell));
+            map_move_actor(fx->map, actor, cell);
+        }
+    }
+    return true;
+}
+
+static void fixture_free(SpatialFixture *fx) {
+    map_free(fx->map);
+    for (int f = 0; f < 2; f++) {
+        free(fx->factions[f].actors);
+    }
+}
+
+// Reference implementation: the row-major cell scan the AI used to run
+static int scan_nearest_enemy(Map *map, Actor *actor, int max_dist) {
+    int ax = map_cell_x(map, actor->cell);
+    int ay = map_cell_y(map, actor->cell);
+    int best = MAP_NO_CELL;
+    int best_dist = 999999;
+    for (int c = 0; c < map->cell_count; c++) {
+        Actor *other = map_get_occupant(map, c);
+        if (other == NULL || !actor_is_enemy(actor, other)) continue;
+        int d = abs(map_cell_x(map, c) - ax) + abs(map_cell_y(map, c) - ay);
+        if (max_dist >= 0 && d > max_dist) continue;
+        if (d < best_dist) {
+            best_dist = d;
+            best = c;
+        }
+    }
+    return best;
+}
+
+static int scan_enemies_within(Map *map, int cell, int faction_id, int range) {
+    int ax = map_cell_x(map, cell);
+    int ay = map_cell_y(map, cell);
+    int count = 0;
+    for (int c = 0; c < map->cell_count; c++) {
+        Actor *other = map_get_occupant(map, c);
+        if (other == NULL || other->owner->id == faction_id) continue;
+        if (abs(map_cell_x(map, c) - ax) + abs(map_cell_y(map, c) - ay) <= range) count++;
+    }
+    return count;
+}
+
+static int verify_queries(SpatialFixture *fx, int *out_buffer) {
+    int mismatches = 0;
+    Faction *attackers = &fx->factions[0];
+    int queries = (attackers->actor_count < MAX_QUERIES) ? attackers->actor_count : MAX_QUERIES;
+
+    for (int q = 0; q < queries; q++) {
+        Actor *actor = &attackers->actors[q];
+        if (actor->cell == MAP_NO_CELL) continue;
+
+        if (scan_nearest_enemy(fx->map, actor, -1) !=
+            spatial_index_nearest_enemy(fx->map->spatial, fx->map, actor, -1)) mismatches++;
+        if (scan_nearest_enemy(fx->map, actor, QUERY_RANGE) !=
+            spatial_index_nearest_enemy(fx->map->spatial, fx->map, actor, QUERY_RANGE)) mismatches++;
+        if (scan_enemies_within(fx->map, actor->cell, 0, QUERY_RANGE) !=
+            spatial_index_enemies_within(fx->map->spatial, fx->map, actor->cell, 0, QUERY_RANGE,
+                                         out_buffer, fx->map->cell_count)) mismatches++;
+
+        // k-nearest must be sorted and start with the nearest enemy
+        int k = spatial_index_k_nearest_enemies(fx->map->spatial, fx->map, actor, 4, -1, out_buffer);
+        if (k > 0 && out_buffer[0] != scan_nearest_enemy(fx->map, actor, -1)) mismatches++;
+        for (int i = 1; i < k; i++) {
+            int prev = abs(map_cell_x(fx->map, out_buffer[i - 1]) - map_cell_x(fx->map, actor->cell)) +
+                       abs(map_cell_y(fx->map, out_buffer[i - 1]) - map_cell_y(fx->map, actor->cell));
+            int curr = abs(map_cell_x(fx->map, out_buffer[i]) - map_cell_x(fx->map, actor->cell)) +
+                       abs(map_cell_y(fx->map, out_buffer[i]) - map_cell_y(fx->map, actor->cell));
+            if (curr < prev) mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void churn(SpatialFixture *fx, int moves, int deaths) {
+    for (int i = 0; i < moves; i++) {
+        Faction *faction = &fx->factions[rng_range(&fx->rng, 2)];
+        Actor *actor = &faction->actors[rng_range(&fx->rng, faction->actor_count)];
+        if (actor->cell == MAP_NO_CELL) continue;
+        map_move_actor(fx->map, actor, map_get_random_cell(fx->map, &fx->rng));
+    }
+    for (int i = 0; i < deaths; i++) {
+        Faction *faction = &fx->factions[1];
+        Actor *actor = &faction->actors[rng_range(&fx->rng, faction->actor_count)];
+        actor->curr_health = 0;
+        map_remove_actor(fx->map, actor);
+    }
+}
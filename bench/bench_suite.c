@@ -0,0 +1,740 @@
+#include "bench.h"
+#include "game/map.h"
+#include "game/actor.h"
+#include "game/combat.h"
+#include "game/game_logic.h"
+#include "game/faction_init.h"
+#include "game/map_generation.h"
+#include "game/biome_config.h"
+#include "game/reachability.h"
+#include "game/pathfinding.h"
+#include "game/flow_field.h"
+#include "game/influence_map.h"
+#include "game/compact_state.h"
+#include "game/mcts.h"
+#include "game/alphabeta.h"
+#include "game/match.h"
+#include "core/log.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Engine hot-path suite: seeded fixtures, ns/op, allocations and cells
+// visited per op, with JSON output that `bench compare` can diff.
+
+#define SUITE_NAME_LEN 48
+#define SUITE_MAX_RESULTS 64
+#define SUITE_ORIGINS 256
+#define SUITE_MOVE_RANGE 6
+#define SUITE_SPREAD_RANGE 8
+#define SUITE_PATH_EXPANSIONS 4096  // same limit the AI uses per query
+#define SUITE_PATH_CELLS 64
+#define SUITE_AI_TURNS 8
+#define SUITE_FLOW_MOVES 256
+#define SUITE_STRIKE_QUERIES 256
+#define SUITE_COMBAT_OPS 100000
+#define SUITE_CLONE_OPS 1000000
+#define SUITE_CLONE_TROOPS 15 // per player faction, 30 militia plus the wargs
+#define SUITE_MCTS_OPS 20
+#define SUITE_MCTS_PLAYOUTS 200 // per searched decision, one search thread
+#define SUITE_MCTS_TURNS 14      // greedy turns played first, so the armies meet
+#define SUITE_ALPHABETA_OPS 20
+#define SUITE_ALPHABETA_DEPTH 4  // plies per searched decision
+#define SUITE_DEFAULT_REPEATS 5
+#define SUITE_DEFAULT_THRESHOLD 10.0 // percent
+
+static const uint64_t SUITE_SEED = 20240601;
+static const int MAP_SIDES[][2] = {{30, 20}, {256, 256}, {1024, 1024}};
+static const int UNIT_COUNTS[] = {10, 100, 1000, 10000};
+
+typedef struct SuiteResult {
+    char name[SUITE_NAME_LEN];
+    long long ops;
+    double ns_per_op;
+    double allocs_per_op;   // -1 when the build does not count allocations
+    double cells_per_op;    // cells the op walked; 0 for ops without a cell walk
+} SuiteResult;
+
+typedef struct SuiteCase {
+    void *fixture;
+    void (*reset)(void *fixture);           // before every repeat, untimed; may be NULL
+    long long (*op)(void *fixture, int i);  // one operation; returns cells visited
+    int ops;                                // operations per repeat
+} SuiteCase;
+
+// A generated map plus the passable cells the ops start from
+typedef struct MapFixture {
+    Terrain terrains[TERRAIN_COUNT];
+    Map *map;
+    uint8_t *snapshot;                  // generated terrain, restored before each repeat
+    int origins[SUITE_ORIGINS];
+    int spread_cells[SUITE_ORIGINS];    // cells map_spread_terrain paints from each origin
+} MapFixture;
+
+// Two AI factions on a map sized for ~10% occupancy
+typedef struct AiFixture {
+    Terrain terrains[TERRAIN_COUNT];
+    Faction factions[3];
+    Map *map;
+    GameState *state;
+    int units;
+} AiFixture;
+
+// Two adjacent militia; the defender cannot die
+typedef struct CombatFixture {
+    Terrain terrains[TERRAIN_COUNT];
+    Faction factions[3];
+    Actor actors[2];
+    Map *map;
+    int attacker_cell;
+    int defender_cell;
+} CombatFixture;
+
+// A default match captured as a compact state, and a buffer to clone into
+typedef struct CloneFixture {
+    Match *match;
+    CompactState *source;
+    CompactState *copy;
+} CloneFixture;
+
+// Forward declarations for internal helper functions
+static void suite_measure(SuiteResult *result, const char *name, const SuiteCase *c, int repeats);
+static bool write_json(const char *path, const SuiteResult *results, int count, int repeats);
+static int load_json(const char *path, SuiteResult *out, int max);
+static const SuiteResult *find_result(const SuiteResult *results, int count, const char *name);
+static Map *generate_map(Terrain *terrains, int width, int height);
+static bool map_fixture_create(MapFixture *fx, int width, int height);
+static void map_fixture_free(MapFixture *fx);
+static void map_fixture_reset(void *fixture);
+static long long op_movement_range(void *fixture, int i);
+static long long op_path_query(void *fixture, int i);
+static long long op_spread_terrain(void *fixture, int i);
+static long long op_deep_terrain(void *fixture, int i);
+static bool ai_fixture_create(AiFixture *fx, int units);
+static void ai_fixture_free(AiFixture *fx);
+static void ai_fixture_reset(void *fixture);
+static long long op_ai_turn(void *fixture, int i);
+static long long op_flow_update(void *fixture, int i);
+static long long op_influence_update(void *fixture, int i);
+static long long op_strike_targets(void *fixture, int i);
+static long long op_strike_scan(void *fixture, int i);
+static void step_enemy_aside(AiFixture *fx, int i);
+static bool combat_fixture_create(CombatFixture *fx);
+static void combat_fixture_free(CombatFixture *fx);
+static long long op_combat(void *fixture, int i);
+static bool clone_fixture_create(CloneFixture *fx);
+static void clone_fixture_free(CloneFixture *fx);
+static long long op_compact_clone(void *fixture, int i);
+static long long op_mcts_decision(void *fixture, int i);
+static long long op_alphabeta_decision(void *fixture, int i);
+
+// Usage: bench suite [--json file] [--repeats N]. Each case keeps the best
+// of N repeats; fixtures are reset between repeats so every repeat does
+// the same work.
+int bench_suite(int argc, char **argv) {
+    const char *json_path = NULL;
+    int repeats = SUITE_DEFAULT_REPEATS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+            if (repeats < 1) repeats = 1;
+        }
+    }
+
+    bool narrate = log_is_enabled();
+    log_set_enabled(false);
+
+    SuiteResult results[SUITE_MAX_RESULTS];
+    int count = 0;
+    char name[SUITE_NAME_LEN];
+
+    printf("%-24s %10s %12s %12s %12s\n", "case", "ops", "ns/op", "allocs/op", "cells/op");
+
+    for (size_t s = 0; s < sizeof(MAP_SIDES) / sizeof(MAP_SIDES[0]); s++) {
+        int width = MAP_SIDES[s][0];
+        int height = MAP_SIDES[s][1];
+        MapFixture fx;
+        if (!map_fixture_create(&fx, width, height)) return 1;
+
+        SuiteCase range = {&fx, map_fixture_reset, op_movement_range, 2 * SUITE_ORIGINS};
+        snprintf(name, sizeof(name), "movement_range/%dx%d", width, height);
+        suite_measure(&results[count++], name, &range, repeats);
+
+        SuiteCase path = {&fx, map_fixture_reset, op_path_query, SUITE_ORIGINS};
+        snprintf(name, sizeof(name), "path_query/%dx%d", width, height);
+        suite_measure(&results[count++], name, &path, repeats);
+
+        SuiteCase spread = {&fx, map_fixture_reset, op_spread_terrain, SUITE_ORIGINS};
+        snprintf(name, sizeof(name), "spread_terrain/%dx%d", width, height);
+        suite_measure(&results[count++], name, &spread, repeats);
+
+        SuiteCase deep = {&fx, map_fixture_reset, op_deep_terrain, 1};
+        snprintf(name, sizeof(name), "deep_terrain/%dx%d", width, height);
+        suite_measure(&results[count++], name, &deep, repeats);
+
+        map_fixture_free(&fx);
+    }
+
+    for (size_t u = 0; u < sizeof(UNIT_COUNTS) / sizeof(UNIT_COUNTS[0]); u++) {
+        AiFixture fx = {0};
+        fx.units = UNIT_COUNTS[u];
+        SuiteCase ai = {&fx, ai_fixture_reset, op_ai_turn, SUITE_AI_TURNS};
+        snprintf(name, sizeof(name), "ai_turn/%d", fx.units);
+        suite_measure(&results[count++], name, &ai, repeats);
+
+        SuiteCase flow = {&fx, ai_fixture_reset, op_flow_update, SUITE_FLOW_MOVES};
+        snprintf(name, sizeof(name), "flow_update/%d", fx.units);
+        suite_measure(&results[count++], name, &flow, repeats);
+
+        SuiteCase influence = {&fx, ai_fixture_reset, op_influence_update, SUITE_FLOW_MOVES};
+        snprintf(name, sizeof(name), "influence_update/%d", fx.units);
+        suite_measure(&results[count++], name, &influence, repeats);
+
+        SuiteCase strike_targets = {&fx, ai_fixture_reset, op_strike_targets, SUITE_STRIKE_QUERIES};
+        snprintf(name, sizeof(name), "strike_targets/%d", fx.units);
+        suite_measure(&results[count++], name, &strike_targets, repeats);
+
+        SuiteCase strike_scan = {&fx, ai_fixture_reset, op_strike_scan, SUITE_STRIKE_QUERIES};
+        snprintf(name, sizeof(name), "strike_scan/%d", fx.units);
+        suite_measure(&results[count++], name, &strike_scan, repeats);
+        ai_fixture_free(&fx);
+    }
+
+    CombatFixture combat;
+    if (!combat_fixture_create(&combat)) return 1;
+    SuiteCase strike = {&combat, NULL, op_combat, SUITE_COMBAT_OPS};
+    suite_measure(&results[count++], "combat_execute", &strike, repeats);
+    combat_fixture_free(&combat);
+
+    CloneFixture clone;
+    if (!clone_fixture_create(&clone)) return 1;
+    SuiteCase copy = {&clone, NULL, op_compact_clone, SUITE_CLONE_OPS};
+    suite_measure(&results[count++], "compact_clone", &copy, repeats);
+    clone_fixture_free(&clone);
+
+    if (!clone_fixture_create(&clone)) return 1;
+    match_set_all_ai(clone.match);
+    match_play_ai(clone.match, SUITE_MCTS_TURNS);
+    if (!compact_state_capture(clone.source, clone.match->state, clone.match->map)) return 1;
+    SuiteCase decide = {&clone, NULL, op_mcts_decision, SUITE_MCTS_OPS};
+    snprintf(name, sizeof(name), "mcts_decision/%d", SUITE_MCTS_PLAYOUTS);
+    suite_measure(&results[count++], name, &decide, repeats);
+    SuiteCase prune = {&clone, NULL, op_alphabeta_decision, SUITE_ALPHABETA_OPS};
+    snprintf(name, sizeof(name), "alphabeta_decision/depth%d", SUITE_ALPHABETA_DEPTH);
+    suite_measure(&results[count++], name, &prune, repeats);
+    clone_fixture_free(&clone);
+
+    log_set_enabled(narrate);
+
+    if (json_path != NULL && !write_json(json_path, results, count, repeats)) {
+        return 1;
+    }
+    return 0;
+}
+
+// Usage: bench compare <baseline.json> <current.json> [--threshold PCT].
+// A case regresses when its ns/op grows by more than PCT percent (default
+// 10) or it makes at least one more allocation per op.
+int bench_compare(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: bench compare <baseline.json> <current.json> [--threshold PCT]\n");
+        return 1;
+    }
+    double threshold = SUITE_DEFAULT_THRESHOLD;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        }
+    }
+
+    SuiteResult base[SUITE_MAX_RESULTS];
+    SuiteResult current[SUITE_MAX_RESULTS];
+    int base_count = load_json(argv[1], base, SUITE_MAX_RESULTS);
+    int current_count = load_json(argv[2], current, SUITE_MAX_RESULTS);
+    if (base_count < 0 || current_count < 0) return 1;
+
+    printf("%-24s %12s %12s %9s %10s %10s\n", "case", "base ns/op", "ns/op", "delta",
+           "base alloc", "alloc");
+    int regressions = 0;
+    for (int i = 0; i < current_count; i++) {
+        const SuiteResult *now = &current[i];
+        const SuiteResult *was = find_result(base, base_count, now->name);
+        if (was == NULL) {
+            printf("%-24s %12s %12.1f %9s %10s %10.2f  new\n", now->name, "-", now->ns_per_op, "-",
+                   "-", now->allocs_per_op);
+            continue;
+        }
+
+        double delta = (was->ns_per_op > 0.0)
+                           ? 100.0 * (now->ns_per_op - was->ns_per_op) / was->ns_per_op : 0.0;
+        bool slower = delta > threshold;
+        bool more_allocs = was->allocs_per_op >= 0.0 && now->allocs_per_op >= 0.0 &&
+                           now->allocs_per_op >= was->allocs_per_op + 1.0;
+        if (slower || more_allocs) regressions++;
+
+        printf("%-24s %12.1f %12.1f %+8.1f%% %10.2f %10.2f%s\n", now->name, was->ns_per_op,
+               now->ns_per_op, delta, was->allocs_per_op, now->allocs_per_op,
+               (slower || more_allocs) ? "  REGRESSION" : "");
+    }
+    for (int i = 0; i < base_count; i++) {
+        if (find_result(current, current_count, base[i].name) == NULL) {
+            printf("%-24s missing from %s\n", base[i].name, argv[2]);
+        }
+    }
+
+    printf("%d regression%s above %.1f%%\n", regressions, (regressions == 1) ? "" : "s", threshold);
+    return (regressions > 0) ? 1 : 0;
+}
+
+// ============================================================================
+// Measurement and JSON
+// ============================================================================
+
+static void suite_measure(SuiteResult *result, const char *name, const SuiteCase *c, int repeats) {
+    double best = 0.0;
+    long long cells = 0;
+    long long allocs = 0;
+
+    for (int r = 0; r < repeats; r++) {
+        if (c->reset != NULL) c->reset(c->fixture);
+
+        long long allocs_before = bench_alloc_count();
+        long long visited = 0;
+        double t0 = bench_now();
+        for (int i = 0; i < c->ops; i++) {
+            visited += c->op(c->fixture, i);
+        }
+        double elapsed = bench_now() - t0;
+        long long allocs_after = bench_alloc_count();
+
+        if (r == 0 || elapsed < best) best = elapsed;
+        cells = visited;
+        allocs = (allocs_before < 0) ? -1 : allocs_after - allocs_before;
+    }
+
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->ops = c->ops;
+    result->ns_per_op = best * 1e9 / c->ops;
+    result->allocs_per_op = (allocs < 0) ? -1.0 : (double)allocs / c->ops;
+    result->cells_per_op = (double)cells / c->ops;
+
+    char alloc_text[16];
+    if (allocs < 0) {
+        snprintf(alloc_text, sizeof(alloc_text), "-");
+    } else {
+        snprintf(alloc_text, sizeof(alloc_text), "%.2f", result->allocs_per_op);
+    }
+    printf("%-24s %10lld %12.1f %12s %12.1f\n", result->name, result->ops, result->ns_per_op,
+           alloc_text, result->cells_per_op);
+}
+
+// One case per line, so two result files diff cleanly
+static bool write_json(const char *path, const SuiteResult *results, int count, int repeats) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open %s for writing\n", path);
+        return false;
+    }
+    fprintf(file, "{\n  \"suite\": \"engine\",\n  \"repeats\": %d,\n  \"benchmarks\": [\n", repeats);
+    for (int i = 0; i < count; i++) {
+        const SuiteResult *r = &results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"ops\": %lld, \"ns_per_op\": %.1f, "
+                "\"allocs_per_op\": %.3f, \"cells_per_op\": %.1f}%s\n",
+                r->name, r->ops, r->ns_per_op, r->allocs_per_op, r->cells_per_op,
+                (i + 1 < count) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    if (fclose(file) != 0) {
+        fprintf(stderr, "Error: Failed to write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Reads the files write_json produces. Returns the case count or -1.
+static int load_json(const char *path, SuiteResult *out, int max) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open %s for reading\n", path);
+        return -1;
+    }
+    int count = 0;
+    char line[512];
+    while (count < max && fgets(line, sizeof(line), file) != NULL) {
+        SuiteResult *r = &out[count];
+        if (sscanf(line,
+                   " {\"name\": \"%47[^\"]\", \"ops\": %lld, \"ns_per_op\": %lf, "
+                   "\"allocs_per_op\": %lf, \"cells_per_op\": %lf}",
+                   r->name, &r->ops, &r->ns_per_op, &r->allocs_per_op, &r->cells_per_op) == 5) {
+            count++;
+        }
+    }
+    fclose(file);
+    if (count == 0) {
+        fprintf(stderr, "Error: No benchmark results in %s\n", path);
+        return -1;
+    }
+    return count;
+}
+
+static const SuiteResult *find_result(const SuiteResult *results, int count, const char *name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(results[i].name, name) == 0) return &results[i];
+    }
+    return NULL;
+}
+
+// ============================================================================
+// Map Fixtures
+// ============================================================================
+
+// Seeded like a default match: biome cores plus the deep pass, one thread
+static Map *generate_map(Terrain *terrains, int width, int height) {
+    terrain_init_all(terrains);
+    Map *map = bench_create_map(width, height, terrains);
+    if (map == NULL) return NULL;
+
+    BiomeConfig configs[3];
+    MapGenSettings settings = {0};
+    settings.generator = MAP_GENERATOR_CORES;
+    settings.seed = SUITE_SEED;
+    settings.biomes = configs;
+    settings.num_biomes = biome_config_get_default(configs, 3);
+    settings.layers = (int)(7LL * width * height / 600);
+    if (settings.layers < 7) settings.layers = 7;
+    settings.threads = 1;
+    map_generation_run(map, &settings);
+    return map;
+}
+
+static bool map_fixture_create(MapFixture *fx, int width, int height) {
+    fx->map = generate_map(fx->terrains, width, height);
+    if (fx->map == NULL) return false;
+    fx->snapshot = malloc((size_t)fx->map->cell_count);
+    if (fx->snapshot == NULL) {
+        fprintf(stderr, "Error: Failed to allocate benchmark terrain snapshot\n");
+        map_free(fx->map);
+        return false;
+    }
+    memcpy(fx->snapshot, fx->map->terrain, (size_t)fx->map->cell_count);
+
+    Rng rng;
+    rng_seed(&rng, SUITE_SEED, RNG_STREAM_SPAWNING);
+    for (int i = 0; i < SUITE_ORIGINS; i++) {
+        int cell = map_get_random_cell(fx->map, &rng);
+        for (int attempt = 0; attempt < 1000 && !map_can_unit_enter_cell(fx->map, cell, NULL); attempt++) {
+            cell = map_get_random_cell(fx->map, &rng);
+        }
+        fx->origins[i] = cell;
+
+        // Diamond of radius SUITE_SPREAD_RANGE clipped to the map
+        int x = map_cell_x(fx->map, cell);
+        int y = map_cell_y(fx->map, cell);
+        int painted = 0;
+        for (int dy = -SUITE_SPREAD_RANGE; dy <= SUITE_SPREAD_RANGE; dy++) {
+            if (y + dy < 0 || y + dy >= fx->map->height) continue;
+            int span = SUITE_SPREAD_RANGE - abs(dy);
+            int x0 = (x - span < 0) ? 0 : x - span;
+            int x1 = (x + span >= fx->map->width) ? fx->map->width - 1 : x + span;
+            painted += x1 - x0 + 1;
+        }
+        fx->spread_cells[i] = painted;
+    }
+    return true;
+}
+
+static void map_fixture_free(MapFixture *fx) {
+    map_free(fx->map);
+    free(fx->snapshot);
+}
+
+static void map_fixture_reset(void *fixture) {
+    MapFixture *fx = fixture;
+    memcpy(fx->map->terrain, fx->snapshot, (size_t)fx->map->cell_count);
+    for (int chunk = 0; chunk < fx->map->chunk_count; chunk++) {
+        map_refresh_chunk(fx->map, chunk);
+    }
+    map_clear_range_flags(fx->map);
+}
+
+// Even ops light up a unit's movement range, odd ops clear it again; both
+// run the full search
+static long long op_movement_range(void *fixture, int i) {
+    MapFixture *fx = fixture;
+    int origin = fx->origins[(i / 2) % SUITE_ORIGINS];
+    map_calculate_movement_range(fx->map, origin, SUITE_MOVE_RANGE, (i % 2) == 0);
+    return fx->map->reach->reached_count;
+}
+
+// A* between consecutive origins, capped like the AI's queries
+static long long op_path_query(void *fixture, int i) {
+    MapFixture *fx = fixture;
+    int path[SUITE_PATH_CELLS];
+    pathfinder_find(fx->map->paths, fx->map, fx->origins[i % SUITE_ORIGINS],
+                    fx->origins[(i + 1) % SUITE_ORIGINS], SUITE_PATH_EXPANSIONS,
+                    path, SUITE_PATH_CELLS);
+    return fx->map->paths->expanded;
+}
+
+static long long op_spread_terrain(void *fixture, int i) {
+    MapFixture *fx = fixture;
+    int terrain = (i % 2 == 0) ? TERRAIN_FOREST : TERRAIN_SEA;
+    map_spread_terrain(fx->map, fx->origins[i % SUITE_ORIGINS], SUITE_SPREAD_RANGE, terrain);
+    return fx->spread_cells[i % SUITE_ORIGINS];
+}
+
+// The 3x3 kernel reads every map cell once
+static long long op_deep_terrain(void *fixture, int i) {
+    (void)i;
+    MapFixture *fx = fixture;
+    map_generate_deep_ter_threads(fx->map, 1);
+    return (long long)fx->map->width * fx->map->height;
+}
+
+// ============================================================================
+// AI and Combat Fixtures
+// ============================================================================
+
+static bool ai_fixture_create(AiFixture *fx, int units) {
+    fx->units = units;
+    int side = (int)ceil(sqrt(units * 10.0));
+    fx->map = generate_map(fx->terrains, side, side);
+    if (fx->map == NULL) return false;
+
+    faction_init_default(fx->factions, 3);
+    ActorTemplate militia;
+    actor_get_default_militia_template(&militia);
+
+    Rng rng;
+    rng_seed(&rng, SUITE_SEED, RNG_STREAM_SPAWNING);
+    for (int f = DARKUS; f <= VENTUS; f++) {
+        Faction *faction = &fx->factions[f];
+        int count = units / 2;
+        faction->actors = actor_array_create_from_template(count, faction, SPRITE_NONE, &militia);
+        if (faction->actors == NULL) return false;
+        faction->actor_count = count;
+        for (int i = 0; i < count; i++) {
+            int cell = map_get_random_cell(fx->map, &rng);
+            for (int attempt = 0; attempt < 1000 && !map_can_unit_enter_cell(fx->map, cell, NULL); attempt++) {
+                cell = map_get_random_cell(fx->map, &rng);
+            }
+            map_move_actor(fx->map, &faction->actors[i], cell);
+        }
+        faction->playable = false;
+    }
+
+    // Build the distance fields and influence map a running game already
+    // holds, so ops time their per-turn repairs rather than the first build
+    for (int f = DARKUS; f <= VENTUS; f++) {
+        if (flow_field_for_faction(fx->map, f) == NULL) return false;
+    }
+    if (influence_map_current(fx->map) == NULL) return false;
+
+    // Gaia stays out of the rotation so every op is a full faction turn
+    fx->state = game_state_create(fx->factions, 2, SUITE_SEED);
+    if (fx->state == NULL) return false;
+    game_start_faction_turn(fx->state);
+    return true;
+}
+
+static void ai_fixture_free(AiFixture *fx) {
+    map_free(fx->map);
+    factions_free_actors(fx->factions, 2);
+    game_state_free(fx->state);
+    fx->map = NULL;
+    fx->state = NULL;
+}
+
+static void ai_fixture_reset(void *fixture) {
+    AiFixture *fx = fixture;
+    int units = fx->units;
+    ai_fixture_free(fx);
+    if (!ai_fixture_create(fx, units)) {
+        fprintf(stderr, "Error: Failed to create AI benchmark fixture\n");
+        exit(1);
+    }
+}
+
+// One faction's turn: scans, moves and attacks for every living unit
+static long long op_ai_turn(void *fixture, int i) {
+    (void)i;
+    AiFixture *fx = fixture;
+    game_process_ai_turn(fx->state, fx->map);
+    return 0;
+}
+
+// One enemy unit steps aside, then the field towards it is repaired
+static long long op_flow_update(void *fixture, int i) {
+    AiFixture *fx = fixture;
+    step_enemy_aside(fx, i);
+
+    FlowField *field = fx->map->flow[DARKUS];
+    flow_field_update(field, fx->map);
+    return field->last_settled;
+}
+
+// One enemy unit steps aside, then its strike zone is restamped
+static long long op_influence_update(void *fixture, int i) {
+    AiFixture *fx = fixture;
+    step_enemy_aside(fx, i);
+
+    influence_map_update(fx->map->influence, fx->map);
+    return fx->map->influence->last_cells;
+}
+
+// A unit is selected: its movement range, then the enemies it can strike
+// from there with the bitboard layers
+static long long op_strike_targets(void *fixture, int i) {
+    AiFixture *fx = fixture;
+    Faction *own = &fx->factions[DARKUS];
+    Actor *actor = &own->actors[i % own->actor_count];
+    map_clear_range_flags(fx->map);
+    map_calculate_movement_range(fx->map, actor->cell, actor->movement, true);
+    map_calculate_strike_targets(fx->map, actor->cell, actor->attack_range, DARKUS);
+    return fx->map->reach->reached_count;
+}
+
+// The same query cell by cell, as a reference: every enemy looks for a
+// cell of the movement range within its attacker's reach
+static long long op_strike_scan(void *fixture, int i) {
+    AiFixture *fx = fixture;
+    Faction *own = &fx->factions[DARKUS];
+    Faction *enemy = &fx->factions[VENTUS];
+    Actor *actor = &own->actors[i % own->actor_count];
+    map_clear_range_flags(fx->map);
+    map_calculate_movement_range(fx->map, actor->cell, actor->movement, true);
+
+    int reach = actor->attack_range;
+    int targets = 0;
+    for (int e = 0; e < enemy->actor_count; e++) {
+        int cell = enemy->actors[e].cell;
+        bool found = false;
+        for (int dy = -reach; dy <= reach && !found; dy++) {
+            int span = reach - abs(dy);
+            for (int dx = -span; dx <= span && !found; dx++) {
+                int from = map_get_neighbor(fx->map, cell, dx, dy);
+                found = from != MAP_NO_CELL && (from == actor->cell || map_is_in_range(fx->map, from));
+            }
+        }
+        if (found) targets++;
+    }
+    (void)targets; // the map calls above keep the scan from being optimised away
+    return fx->map->reach->reached_count;
+}
+
+static void step_enemy_aside(AiFixture *fx, int i) {
+    Faction *enemy = &fx->factions[VENTUS];
+    Actor *actor = &enemy->actors[i % enemy->actor_count];
+    static const int STEPS[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    for (int d = 0; d < 4; d++) {
+        int dest = map_get_neighbor(fx->map, actor->cell, STEPS[d][0], STEPS[d][1]);
+        if (dest != MAP_NO_CELL && map_can_unit_enter_cell(fx->map, dest, NULL)) {
+            map_move_actor(fx->map, actor, dest);
+            break;
+        }
+    }
+}
+
+static bool combat_fixture_create(CombatFixture *fx) {
+    terrain_init_all(fx->terrains);
+    fx->map = bench_create_map(MAP_SIDES[0][0], MAP_SIDES[0][1], fx->terrains);
+    if (fx->map == NULL) return false;
+
+    faction_init_default(fx->factions, 3);
+    ActorTemplate militia;
+    actor_get_default_militia_template(&militia);
+    actor_init_from_template(&fx->actors[0], &fx->factions[DARKUS], SPRITE_NONE, &militia);
+    actor_init_from_template(&fx->actors[1], &fx->factions[VENTUS], SPRITE_NONE, &militia);
+    fx->actors[1].max_health = 1 << 30;
+
+    fx->attacker_cell = map_get_cell(fx->map, 10, 10);
+    fx->defender_cell = map_get_cell(fx->map, 11, 10);
+    map_move_actor(fx->map, &fx->actors[0], fx->attacker_cell);
+    map_move_actor(fx->map, &fx->actors[1], fx->defender_cell);
+    return true;
+}
+
+static void combat_fixture_free(CombatFixture *fx) {
+    map_free(fx->map);
+}
+
+static long long op_combat(void *fixture, int i) {
+    (void)i;
+    CombatFixture *fx = fixture;
+    actor_reset_turn_flags(&fx->actors[0]);
+    actor_heal(&fx->actors[1], fx->actors[1].max_health - fx->actors[1].curr_health);
+    combat_execute_at_cells(fx->map, fx->attacker_cell, fx->defender_cell);
+    return 0;
+}
+
+static bool clone_fixture_create(CloneFixture *fx) {
+    MatchSettings settings;
+    match_settings_default(&settings);
+    settings.seed = SUITE_SEED;
+    settings.troops = SUITE_CLONE_TROOPS;
+    fx->match = match_create(&settings);
+    fx->source = malloc(sizeof(CompactState));
+    fx->copy = malloc(sizeof(CompactState));
+    if (fx->match == NULL || fx->source == NULL || fx->copy == NULL) {
+        clone_fixture_free(fx);
+        return false;
+    }
+    if (!compact_state_capture(fx->source, fx->match->state, fx->match->map)) {
+        clone_fixture_free(fx);
+        return false;
+    }
+    return true;
+}
+
+static void clone_fixture_free(CloneFixture *fx) {
+    match_free(fx->match);
+    free(fx->source);
+    free(fx->copy);
+    fx->match = NULL;
+    fx->source = NULL;
+    fx->copy = NULL;
+}
+
+// One clone of the whole match; reports the cells copied
+static long long op_compact_clone(void *fixture, int i) {
+    (void)i;
+    CloneFixture *fx = fixture;
+    compact_state_clone(fx->copy, fx->source);
+    return fx->copy->cell_count;
+}
+
+// One search AI decision for the next unit to act, a few turns into the
+// same match; reports the playouts run in place of cells
+static long long op_mcts_decision(void *fixture, int i) {
+    CloneFixture *fx = fixture;
+    AiSearchSettings settings;
+    game_ai_search_defaults(&settings);
+    settings.budget_ms = 0;
+    settings.max_playouts = SUITE_MCTS_PLAYOUTS;
+    AiSearchStats stats = {0};
+    CompactAction action;
+    mcts_search(fx->source, &settings, SUITE_SEED + (uint64_t)i, 0, &action, &stats);
+    return stats.playouts;
+}
+
+// One alpha-beta decision on the same position, with a fresh transposition
+// table each time; reports the nodes searched in place of cells
+static long long op_alphabeta_decision(void *fixture, int i) {
+    (void)i;
+    CloneFixture *fx = fixture;
+    AiSearchSettings settings;
+    game_ai_search_defaults(&settings);
+    settings.budget_ms = 0;
+    settings.max_depth = SUITE_ALPHABETA_DEPTH;
+    AiSearchStats stats = {0};
+    CompactAction action;
+    AlphaBeta *ab = alphabeta_create();
+    if (ab == NULL) return 0;
+    alphabeta_search(ab, fx->source, &settings, 0, &action, &stats);
+    alphabeta_free(ab);
+    return stats.nodes;
+}
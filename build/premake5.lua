@@ -14,6 +14,12 @@ newoption
     default = "opengl33"
 }
 
+newoption
+{
+    trigger = "profiler",
+    description = "compile the frame profiler into release builds (always on in debug builds)"
+}
+
 function download_progress(total, current)
     local ratio = current / total;
     ratio = math.min(math.max(ratio, 0), 1);
@@ -114,9 +120,12 @@ workspace (workspaceName)
     defaultplatform ("x64")
 
     filter "configurations:Debug or Debug_RGFW"
-        defines { "DEBUG" }
+        defines { "DEBUG", "PROFILER_ENABLED" }
         symbols "On"
 
+    filter { "options:profiler" }
+        defines { "PROFILER_ENABLED" }
+
     filter "configurations:Release or Release_RGFW"
         defines { "NDEBUG" }
         optimize "On"
@@ -162,7 +171,8 @@ if (downloadRaylib) then
             ["Windows Resource Files/*"] = {"../src/*.rc", "src/*.ico"},
         }
         
-        files {"../src/main.c", "../src/*/*.c", "../src/**.h", "../src/**.hpp", "../include/**.h", "../include/**.hpp"}
+        -- Window, rendering and input; the simulation comes from the sim library
+        files {"../src/main.c", "../src/render/*.c", "../src/input/*.c", "../src/ui/*.c", "../src/**.h", "../src/**.hpp", "../include/**.h", "../include/**.hpp"}
         
         filter {"system:windows", "action:vs*"}
             files {"../src/*.rc", "../src/*.ico"}
@@ -172,7 +182,7 @@ if (downloadRaylib) then
         includedirs { "../src" }
         includedirs { "../include" }
 
-        links {"raylib"}
+        links {"sim", "raylib"}
 
         cdialect "C17"
         cppdialect "C++17"
@@ -185,8 +195,8 @@ if (downloadRaylib) then
 
         filter "action:vs*"
             defines{"_WINSOCK_DEPRECATED_NO_WARNINGS", "_CRT_SECURE_NO_WARNINGS"}
-            dependson {"raylib"}
-            links {"raylib.lib"}
+            dependson {"sim", "raylib"}
+            links {"sim.lib", "raylib.lib"}
             characterset ("Unicode")
             buildoptions { "/Zc:__cplusplus" }
 
@@ -204,6 +214,122 @@ if (downloadRaylib) then
         filter{}
         
 
+    -- Headless simulation: map, actors, combat, game logic, spawning and
+    -- generation. No raylib; art is referenced through sprite ids only.
+    project "sim"
+        kind "StaticLib"
+        location "build_files/"
+        language "C"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        files {"../src/game/*.c", "../src/core/*.c", "../src/types.h", "../src/game/*.h", "../src/core/*.h"}
+
+        includedirs { "../src" }
+
+        cdialect "C17"
+        flags { "ShadowedVariables"}
+
+        filter "system:linux"
+            defines {"_GNU_SOURCE"}
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+            characterset ("Unicode")
+
+        filter{}
+
+    -- Headless benchmark runner: links the simulation library only, no GL
+    project "bench"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        files {"../bench/*.c", "../bench/*.h"}
+
+        includedirs { "../src" }
+
+        links {"sim"}
+
+        cdialect "C17"
+        flags { "ShadowedVariables"}
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+            dependson {"sim"}
+            links {"sim.lib"}
+            characterset ("Unicode")
+
+        filter "system:windows"
+            libdirs {"../bin/%{cfg.buildcfg}"}
+
+        -- Count heap allocations for `bench suite` (see bench/bench_alloc.c)
+        filter "system:linux"
+            defines {"_GNU_SOURCE", "BENCH_COUNT_ALLOCS"}
+            links {"pthread", "m"}
+            linkoptions {"-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc"}
+
+        filter{}
+
+    -- Headless AI-vs-AI batch runner: links the simulation library only
+    project "match_runner"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        files {"../tools/match_runner.c"}
+
+        includedirs { "../src" }
+
+        links {"sim"}
+
+        cdialect "C17"
+        flags { "ShadowedVariables"}
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+            dependson {"sim"}
+            links {"sim.lib"}
+            characterset ("Unicode")
+
+        filter "system:windows"
+            libdirs {"../bin/%{cfg.buildcfg}"}
+
+        filter "system:linux"
+            defines {"_GNU_SOURCE"}
+            links {"pthread", "m"}
+
+        filter{}
+
+    -- Headless replay player: links the simulation library only
+    project "replay_player"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        files {"../tools/replay_player.c"}
+
+        includedirs { "../src" }
+
+        links {"sim"}
+
+        cdialect "C17"
+        flags { "ShadowedVariables"}
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+            dependson {"sim"}
+            links {"sim.lib"}
+            characterset ("Unicode")
+
+        filter "system:windows"
+            libdirs {"../bin/%{cfg.buildcfg}"}
+
+        filter "system:linux"
+            defines {"_GNU_SOURCE"}
+            links {"pthread", "m"}
+
+        filter{}
+
     project "raylib"
         kind "StaticLib"
     
@@ -0,0 +1,153 @@
+#include "core/bitboard.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Forward declarations for internal helper functions
+static int popcount64(uint64_t v);
+static uint64_t row_tail_mask(const Bitboard *bb);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+Bitboard *bitboard_create(int width, int height) {
+    Bitboard *bb = malloc(sizeof(Bitboard));
+    if (bb == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for bitboard\n");
+        return NULL;
+    }
+
+    bb->width = width;
+    bb->height = height;
+    bb->row_words = (width + 63) / 64;
+    bb->word_count = bb->row_words * height;
+    bb->words = calloc(bb->word_count, sizeof(uint64_t));
+    if (bb->words == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for bitboard words\n");
+        free(bb);
+        return NULL;
+    }
+    return bb;
+}
+
+void bitboard_free(Bitboard *bb) {
+    if (bb == NULL) return;
+    free(bb->words);
+    free(bb);
+}
+
+// ============================================================================
+// Whole-board Operations
+// ============================================================================
+
+void bitboard_clear(Bitboard *bb) {
+    memset(bb->words, 0, sizeof(uint64_t) * bb->word_count);
+}
+
+void bitboard_fill(Bitboard *bb) {
+    memset(bb->words, 0xFF, sizeof(uint64_t) * bb->word_count);
+
+    // Keep the row padding clear so counts and shifts stay exact
+    uint64_t tail = row_tail_mask(bb);
+    for (int y = 0; y < bb->height; y++) {
+        bb->words[y * bb->row_words + bb->row_words - 1] &= tail;
+    }
+}
+
+void bitboard_copy(Bitboard *dst, const Bitboard *src) {
+    memcpy(dst->words, src->words, sizeof(uint64_t) * src->word_count);
+}
+
+int bitboard_count(const Bitboard *bb) {
+    int count = 0;
+    for (int i = 0; i < bb->word_count; i++) {
+        count += popcount64(bb->words[i]);
+    }
+    return count;
+}
+
+// ============================================================================
+// Single Cell Access
+// ============================================================================
+
+void bitboard_set(Bitboard *bb, int x, int y) {
+    bb->words[y * bb->row_words + (x >> 6)] |= (uint64_t)1 << (x & 63);
+}
+
+void bitboard_reset(Bitboard *bb, int x, int y) {
+    bb->words[y * bb->row_words + (x >> 6)] &= ~((uint64_t)1 << (x & 63));
+}
+
+void bitboard_assign(Bitboard *bb, int x, int y, bool value) {
+    if (value) {
+        bitboard_set(bb, x, y);
+    } else {
+        bitboard_reset(bb, x, y);
+    }
+}
+
+bool bitboard_test(const Bitboard *bb, int x, int y) {
+    return (bb->words[y * bb->row_words + (x >> 6)] >> (x & 63)) & 1;
+}
+
+// ============================================================================
+// Set Algebra
+// ============================================================================
+
+void bitboard_and(Bitboard *dst, const Bitboard *a, const Bitboard *b) {
+    for (int i = 0; i < dst->word_count; i++) {
+        dst->words[i] = a->words[i] & b->words[i];
+    }
+}
+
+void bitboard_or(Bitboard *dst, const Bitboard *a, const Bitboard *b) {
+    for (int i = 0; i < dst->word_count; i++) {
+        dst->words[i] = a->words[i] | b->words[i];
+    }
+}
+
+void bitboard_dilate(Bitboard *dst, const Bitboard *src) {
+    int rw = src->row_words;
+    uint64_t tail = row_tail_mask(src);
+
+    for (int y = 0; y < src->height; y++) {
+        const uint64_t *row = src->words + y * rw;
+        const uint64_t *up = (y > 0) ? row - rw : NULL;
+        const uint64_t *down = (y < src->height - 1) ? row + rw : NULL;
+        uint64_t *out = dst->words + y * rw;
+
+        for (int i = 0; i < rw; i++) {
+            uint64_t v = row[i];
+            // Shift towards x + 1 and x - 1, carrying bits across word boundaries
+            uint64_t to_right = (v << 1) | ((i > 0) ? row[i - 1] >> 63 : 0);
+            uint64_t to_left = (v >> 1) | ((i < rw - 1) ? row[i + 1] << 63 : 0);
+            uint64_t result = v | to_right | to_left;
+            if (up != NULL) result |= up[i];
+            if (down != NULL) result |= down[i];
+            if (i == rw - 1) result &= tail;
+            out[i] = result;
+        }
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static int popcount64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((v * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Mask of the valid bits in the last word of a row
+static uint64_t row_tail_mask(const Bitboard *bb) {
+    int used = bb->width - (bb->row_words - 1) * 64;
+    return (used >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << used) - 1);
+}
@@ -0,0 +1,41 @@
+#ifndef BITBOARD_H_
+#define BITBOARD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// One bit per map cell, 64 cells per word. Each row is padded to a whole
+// number of words so horizontal shifts never bleed into the next row.
+typedef struct Bitboard {
+    int width;
+    int height;
+    int row_words;   // 64-bit words per row
+    int word_count;  // row_words * height
+    uint64_t *words;
+} Bitboard;
+
+// Lifecycle
+Bitboard *bitboard_create(int width, int height);
+void bitboard_free(Bitboard *bb);
+
+// Whole-board operations
+void bitboard_clear(Bitboard *bb);
+void bitboard_fill(Bitboard *bb);
+void bitboard_copy(Bitboard *dst, const Bitboard *src);
+int bitboard_count(const Bitboard *bb);
+
+// Single cell access
+void bitboard_set(Bitboard *bb, int x, int y);
+void bitboard_reset(Bitboard *bb, int x, int y);
+void bitboard_assign(Bitboard *bb, int x, int y, bool value);
+bool bitboard_test(const Bitboard *bb, int x, int y);
+
+// Set algebra (dst may alias either operand)
+void bitboard_and(Bitboard *dst, const Bitboard *a, const Bitboard *b);
+void bitboard_or(Bitboard *dst, const Bitboard *a, const Bitboard *b);
+
+// Grows the set by one step in the four cardinal directions.
+// dst must not alias src.
+void bitboard_dilate(Bitboard *dst, const Bitboard *src);
+
+#endif
@@ -0,0 +1,185 @@
+#include "core/grid_kernel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GRID_KERNEL_SSE2 1
+#endif
+
+// Most ids with a partner that the SSE2 path resolves with compares
+#define GRID_KERNEL_MAX_PAIRS 8
+
+// Forward declarations for internal helper functions
+static bool uniform_at(const uint8_t *center, int stride, const uint8_t partner[256],
+                       uint8_t wildcard);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+PaddedGrid *padded_grid_create(int width, int height) {
+    PaddedGrid *grid = malloc(sizeof(PaddedGrid));
+    if (grid == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for padded grid\n");
+        return NULL;
+    }
+
+    grid->width = width;
+    grid->height = height;
+    grid->stride = width + 2;
+    grid->cells = malloc((size_t)grid->stride * (height + 2));
+    if (grid->cells == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for padded grid cells\n");
+        free(grid);
+        return NULL;
+    }
+    return grid;
+}
+
+void padded_grid_free(PaddedGrid *grid) {
+    if (grid == NULL) return;
+    free(grid->cells);
+    free(grid);
+}
+
+void padded_grid_load(PaddedGrid *grid, const uint8_t *src, uint8_t border) {
+    padded_grid_fill_border(grid, border);
+    for (int y = 0; y < grid->height; y++) {
+        padded_grid_store(grid, 0, y, src + (size_t)y * grid->width, grid->width);
+    }
+}
+
+void padded_grid_fill_border(PaddedGrid *grid, uint8_t border) {
+    int stride = grid->stride;
+
+    memset(grid->cells, border, stride);
+    memset(grid->cells + (size_t)(grid->height + 1) * stride, border, stride);
+
+    for (int y = 0; y < grid->height; y++) {
+        uint8_t *row = grid->cells + (size_t)(y + 1) * stride;
+        row[0] = border;
+        row[grid->width + 1] = border;
+    }
+}
+
+void padded_grid_store(PaddedGrid *grid, int x, int y, const uint8_t *src, int count) {
+    memcpy(grid->cells + (size_t)(y + 1) * grid->stride + 1 + x, src, count);
+}
+
+const uint8_t *padded_grid_row(const PaddedGrid *grid, int y) {
+    return grid->cells + (size_t)(y + 1) * grid->stride + 1;
+}
+
+// ============================================================================
+// Kernels
+// ============================================================================
+
+void grid_kernel_uniform3x3(const PaddedGrid *grid, const uint8_t partner[256],
+                            uint8_t wildcard, uint8_t *out_mask) {
+    grid_kernel_uniform3x3_rows(grid, partner, wildcard, 0, grid->height, out_mask);
+}
+
+void grid_kernel_uniform3x3_rows(const PaddedGrid *grid, const uint8_t partner[256],
+                                 uint8_t wildcard, int y0, int y1, uint8_t *out_mask) {
+    int width = grid->width;
+    int stride = grid->stride;
+
+#ifdef GRID_KERNEL_SSE2
+    // Partners are resolved in registers when only a few ids have one (the
+    // usual case: the handful of terrains with a deep variant). Otherwise a
+    // row of partners is gathered up front so the vector loop only loads.
+    uint8_t pair_id[GRID_KERNEL_MAX_PAIRS];
+    uint8_t pair_partner[GRID_KERNEL_MAX_PAIRS];
+    int pair_count = 0;
+    for (int v = 0; v < 256; v++) {
+        if (partner[v] == 0) continue;
+        if (pair_count < GRID_KERNEL_MAX_PAIRS) {
+            pair_id[pair_count] = (uint8_t)v;
+            pair_partner[pair_count] = partner[v];
+        }
+        pair_count++;
+    }
+
+    uint8_t *alt_row = NULL;
+    if (pair_count > GRID_KERNEL_MAX_PAIRS) {
+        alt_row = malloc(sizeof(uint8_t) * width);
+        if (alt_row == NULL) {
+            fprintf(stderr, "Error: Failed to allocate memory for grid kernel row\n");
+            return;
+        }
+    }
+    const __m128i wild = _mm_set1_epi8((char)wildcard);
+    const __m128i one = _mm_set1_epi8(1);
+#endif
+
+    for (int y = y0; y < y1; y++) {
+        const uint8_t *row = padded_grid_row(grid, y);
+        uint8_t *out = out_mask + (size_t)(y - y0) * width;
+        int x = 0;
+
+#ifdef GRID_KERNEL_SSE2
+        if (alt_row != NULL) {
+            for (int i = 0; i < width; i++) {
+                alt_row[i] = partner[row[i]];
+            }
+        }
+
+        // 16 cells per step: compare all 8 shifted windows against the centers
+        for (; x + 16 <= width; x += 16) {
+            const uint8_t *c = row + x;
+            __m128i center = _mm_loadu_si128((const __m128i *)c);
+
+            __m128i alt;
+            if (alt_row != NULL) {
+                alt = _mm_loadu_si128((const __m128i *)(alt_row + x));
+            } else {
+                alt = _mm_setzero_si128();
+                for (int p = 0; p < pair_count; p++) {
+                    __m128i is_id = _mm_cmpeq_epi8(center, _mm_set1_epi8((char)pair_id[p]));
+                    alt = _mm_or_si128(alt, _mm_and_si128(is_id, _mm_set1_epi8((char)pair_partner[p])));
+                }
+            }
+
+            __m128i ok = _mm_set1_epi8((char)0xFF);
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (dx == 0 && dy == 0) continue;
+                    __m128i w = _mm_loadu_si128((const __m128i *)(c + dy * stride + dx));
+                    __m128i match = _mm_or_si128(_mm_cmpeq_epi8(w, center),
+                                                 _mm_or_si128(_mm_cmpeq_epi8(w, alt),
+                                                              _mm_cmpeq_epi8(w, wild)));
+                    ok = _mm_and_si128(ok, match);
+                }
+            }
+            _mm_storeu_si128((__m128i *)(out + x), _mm_and_si128(ok, one));
+        }
+#endif
+
+        for (; x < width; x++) {
+            out[x] = uniform_at(row + x, stride, partner, wildcard) ? 1 : 0;
+        }
+    }
+
+#ifdef GRID_KERNEL_SSE2
+    free(alt_row);
+#endif
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static bool uniform_at(const uint8_t *center, int stride, const uint8_t partner[256],
+                       uint8_t wildcard) {
+    uint8_t self = *center;
+    uint8_t alt = partner[self];
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            uint8_t w = center[dy * stride + dx];
+            if (w != self && w != alt && w != wildcard) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef GRID_KERNEL_H_
+#define GRID_KERNEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Byte-per-cell grid with a one-cell border on every side, so 3x3 windows
+// can be read without bounds checks. Neighbourhood passes read from a
+// PaddedGrid snapshot and write to a separate buffer, which makes their
+// result independent of scan order.
+typedef struct PaddedGrid {
+    int width;
+    int height;
+    int stride;     // bytes per padded row (width + 2)
+    uint8_t *cells; // (height + 2) * stride bytes
+} PaddedGrid;
+
+// Lifecycle
+PaddedGrid *padded_grid_create(int width, int height);
+void padded_grid_free(PaddedGrid *grid);
+
+// Copies a row-major width * height array in and sets the border to `border`
+void padded_grid_load(PaddedGrid *grid, const uint8_t *src, uint8_t border);
+
+// Piecewise loading: set the border, then store runs of cells row by row
+void padded_grid_fill_border(PaddedGrid *grid, uint8_t border);
+void padded_grid_store(PaddedGrid *grid, int x, int y, const uint8_t *src, int count);
+
+// Pointer to cell (0, y); x - 1 and y +/- 1 are valid offsets from it
+const uint8_t *padded_grid_row(const PaddedGrid *grid, int y);
+
+// For every cell writes 1 to out_mask when each of its 8 neighbours equals
+// the cell's own value, partner[value], or `wildcard`; 0 otherwise.
+// out_mask is row-major, width * height bytes.
+void grid_kernel_uniform3x3(const PaddedGrid *grid, const uint8_t partner[256],
+                            uint8_t wildcard, uint8_t *out_mask);
+
+// Same, for rows [y0, y1) only; out_mask holds (y1 - y0) rows starting at y0.
+// Disjoint row ranges can run on different threads over the same grid.
+void grid_kernel_uniform3x3_rows(const PaddedGrid *grid, const uint8_t partner[256],
+                                 uint8_t wildcard, int y0, int y1, uint8_t *out_mask);
+
+#endif
@@ -0,0 +1,21 @@
+#include "core/log.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+static bool log_enabled = true;
+
+void log_set_enabled(bool enabled) {
+    log_enabled = enabled;
+}
+
+bool log_is_enabled(void) {
+    return log_enabled;
+}
+
+void log_info(const char *format, ...) {
+    if (!log_enabled) return;
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
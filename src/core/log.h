@@ -0,0 +1,15 @@
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <stdbool.h>
+
+// Match narration: turn banners, attacks, deaths and level ups. On by
+// default. Headless runners switch it off before starting worker threads;
+// it must not change while matches are running.
+void log_set_enabled(bool enabled);
+bool log_is_enabled(void);
+
+// printf to stdout when narration is on
+void log_info(const char *format, ...);
+
+#endif
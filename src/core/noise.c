@@ -0,0 +1,125 @@
+#include "core/noise.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NOISE_SSE2 1
+#endif
+
+// Lattice points whose values are kept on the stack at a time
+#define NOISE_LINE_BLOCK 64
+
+// Forward declarations for internal helper functions
+static int lattice_value(const NoiseLayer *layer, int octave, int ix, int iy);
+static int16_t blend(int a, int b, int weight);
+static void fill_segment(int16_t *out, const int16_t *fade, int period, int a, int b);
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void noise_layer_init(NoiseLayer *layer, uint64_t seed, int octaves, int period_shift) {
+    if (period_shift < 1) period_shift = 1;
+    if (period_shift > NOISE_MAX_PERIOD_SHIFT) period_shift = NOISE_MAX_PERIOD_SHIFT;
+    if (octaves > period_shift) octaves = period_shift;
+    if (octaves > NOISE_MAX_OCTAVES) octaves = NOISE_MAX_OCTAVES;
+    if (octaves < 1) octaves = 1;
+
+    layer->seed = seed;
+    layer->octaves = octaves;
+    layer->period_shift = period_shift;
+
+    // smoothstep(k / P) = k^2 (3P - 2k) / P^3, in Q15
+    memset(layer->fade, 0, sizeof(layer->fade));
+    for (int o = 0; o < octaves; o++) {
+        long long period = 1LL << (period_shift - o);
+        for (long long k = 0; k < period; k++) {
+            layer->fade[o][k] = (int16_t)(32767 * k * k * (3 * period - 2 * k) /
+                                          (period * period * period));
+        }
+    }
+}
+
+int noise_layer_max(const NoiseLayer *layer) {
+    int max = 0;
+    for (int o = 0; o < layer->octaves; o++) {
+        max += (1 << (14 - o)) - 1;
+    }
+    return max;
+}
+
+int noise_row_capacity(const NoiseLayer *layer, int width) {
+    int period = 1 << layer->period_shift;
+    return (width + period - 1) & ~(period - 1);
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+void noise_fill_row(const NoiseLayer *layer, int y, int width, int16_t *out) {
+    memset(out, 0, sizeof(int16_t) * noise_row_capacity(layer, width));
+
+    for (int o = 0; o < layer->octaves; o++) {
+        int shift = layer->period_shift - o;
+        int period = 1 << shift;
+        int iy = y >> shift;
+        int weight_y = layer->fade[o][y & (period - 1)];
+        int segments = (width + period - 1) >> shift;
+
+        // Blend the two lattice rows around y once per lattice column, then
+        // every segment between two columns is a run of identical math
+        for (int first = 0; first < segments; first += NOISE_LINE_BLOCK) {
+            int count = segments - first;
+            if (count > NOISE_LINE_BLOCK) count = NOISE_LINE_BLOCK;
+
+            int16_t line[NOISE_LINE_BLOCK + 1];
+            for (int i = 0; i <= count; i++) {
+                int top = lattice_value(layer, o, first + i, iy);
+                int bottom = lattice_value(layer, o, first + i, iy + 1);
+                line[i] = blend(top, bottom, weight_y);
+            }
+            for (int i = 0; i < count; i++) {
+                fill_segment(out + (size_t)(first + i) * period, layer->fade[o], period,
+                             line[i], line[i + 1]);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Octave o's lattice values lie in [0, 2^(14 - o))
+static int lattice_value(const NoiseLayer *layer, int octave, int ix, int iy) {
+    uint64_t h = layer->seed;
+    h ^= (uint64_t)(uint32_t)ix * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t)(uint32_t)iy * 0xC2B2AE3D27D4EB4FULL;
+    h ^= (uint64_t)(octave + 1) * 0x165667B19E3779F9ULL;
+    h = (h ^ (h >> 32)) * 0xD6E8FEB86659FD93ULL;
+    h = (h ^ (h >> 32)) * 0xD6E8FEB86659FD93ULL;
+    return (int)((uint32_t)(h >> 32) >> (18 + octave));
+}
+
+// a + (b - a) * weight / 2^15, rounded down; matches _mm_mulhi_epi16 exactly
+static int16_t blend(int a, int b, int weight) {
+    return (int16_t)(a + ((2 * (b - a) * weight) >> 16));
+}
+
+static void fill_segment(int16_t *out, const int16_t *fade, int period, int a, int b) {
+    int k = 0;
+#ifdef NOISE_SSE2
+    __m128i base = _mm_set1_epi16((short)a);
+    __m128i delta2 = _mm_set1_epi16((short)(2 * (b - a)));
+    for (; k + 8 <= period; k += 8) {
+        __m128i weight = _mm_loadu_si128((const __m128i *)(fade + k));
+        __m128i value = _mm_add_epi16(base, _mm_mulhi_epi16(delta2, weight));
+        __m128i acc = _mm_loadu_si128((const __m128i *)(out + k));
+        _mm_storeu_si128((__m128i *)(out + k), _mm_add_epi16(acc, value));
+    }
+#endif
+    for (; k < period; k++) {
+        out[k] = (int16_t)(out[k] + blend(a, b, fade[k]));
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef NOISE_H_
+#define NOISE_H_
+
+#include <stdint.h>
+
+#define NOISE_MAX_OCTAVES 6
+#define NOISE_MAX_PERIOD_SHIFT 8
+
+// Fractal value noise in fixed point. Lattice values are hashed from the
+// seed and blended with a smoothstep; octave o has half the wavelength and
+// half the amplitude of octave o - 1. Everything is integer math, so a seed
+// gives the same field on every platform, with or without SIMD.
+typedef struct NoiseLayer {
+    uint64_t seed;
+    int octaves;
+    int period_shift;   // first octave's wavelength is 1 << period_shift cells
+    int16_t fade[NOISE_MAX_OCTAVES][1 << NOISE_MAX_PERIOD_SHIFT]; // Q15 smoothstep per octave
+} NoiseLayer;
+
+// octaves is clamped so the finest wavelength is at least 2 cells
+void noise_layer_init(NoiseLayer *layer, uint64_t seed, int octaves, int period_shift);
+
+// Largest value noise_fill_row can produce (the smallest is 0)
+int noise_layer_max(const NoiseLayer *layer);
+
+// Entries a row buffer needs for `width` cells: width rounded up to the
+// first octave's wavelength
+int noise_row_capacity(const NoiseLayer *layer, int width);
+
+// Writes row y of the field into out[0..width); out must hold
+// noise_row_capacity(layer, width) entries. Rows are independent, so
+// different threads can fill different rows.
+void noise_fill_row(const NoiseLayer *layer, int y, int width, int16_t *out);
+
+#endif
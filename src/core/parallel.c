@@ -0,0 +1,144 @@
+#include "core/parallel.h"
+#include "core/profiler.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// Upper bound on worker threads per parallel_for call
+#define PARALLEL_MAX_THREADS 64
+
+typedef struct ParallelJob {
+    ParallelTask task;
+    void *ctx;
+    int task_count;
+#if defined(_WIN32)
+    volatile LONG next;
+#else
+    int next;
+#endif
+} ParallelJob;
+
+static int default_threads = 0;
+
+// Forward declarations for internal helper functions
+static int claim_task(ParallelJob *job);
+static void run_tasks(ParallelJob *job);
+#if defined(_WIN32)
+static DWORD WINAPI worker_main(LPVOID arg);
+#else
+static void *worker_main(void *arg);
+#endif
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+int parallel_cpu_count(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (count > 0) ? count : 1;
+}
+
+void parallel_set_thread_count(int threads) {
+    default_threads = (threads > 0) ? threads : 0;
+}
+
+int parallel_thread_count(void) {
+    return (default_threads > 0) ? default_threads : parallel_cpu_count();
+}
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+void parallel_for(int task_count, int threads, ParallelTask task, void *ctx) {
+    if (task_count <= 0) return;
+    if (threads <= 0) threads = parallel_thread_count();
+    if (threads > task_count) threads = task_count;
+    if (threads > PARALLEL_MAX_THREADS) threads = PARALLEL_MAX_THREADS;
+
+    ParallelJob job = {0};
+    job.task = task;
+    job.ctx = ctx;
+    job.task_count = task_count;
+
+    // Workers that fail to start are simply not waited for; the calling
+    // thread drains whatever they would have claimed
+#if defined(_WIN32)
+    HANDLE workers[PARALLEL_MAX_THREADS];
+    int started = 0;
+    for (int i = 1; i < threads; i++) {
+        HANDLE handle = CreateThread(NULL, 0, worker_main, &job, 0, NULL);
+        if (handle == NULL) {
+            fprintf(stderr, "Error: Failed to start worker thread\n");
+            break;
+        }
+        workers[started++] = handle;
+    }
+    run_tasks(&job);
+    for (int i = 0; i < started; i++) {
+        WaitForSingleObject(workers[i], INFINITE);
+        CloseHandle(workers[i]);
+    }
+#else
+    pthread_t workers[PARALLEL_MAX_THREADS];
+    int started = 0;
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, worker_main, &job) != 0) {
+            fprintf(stderr, "Error: Failed to start worker thread\n");
+            break;
+        }
+        started++;
+    }
+    run_tasks(&job);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+#endif
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static int claim_task(ParallelJob *job) {
+#if defined(_WIN32)
+    return (int)InterlockedIncrement(&job->next) - 1;
+#else
+    return __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static void run_tasks(ParallelJob *job) {
+    PROFILE_BEGIN("parallel_tasks");
+    for (int i = claim_task(job); i < job->task_count; i = claim_task(job)) {
+        job->task(job->ctx, i);
+    }
+    PROFILE_END();
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_main(LPVOID arg) {
+    run_tasks((ParallelJob *)arg);
+    PROFILE_THREAD_EXIT();
+    return 0;
+}
+#else
+static void *worker_main(void *arg) {
+    run_tasks((ParallelJob *)arg);
+    PROFILE_THREAD_EXIT();
+    return NULL;
+}
+#endif
@@ -0,0 +1,22 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+// Runs task(ctx, i) for every i in [0, task_count) on a set of worker
+// threads. Tasks are handed out one at a time from a shared counter, so
+// callers get deterministic results as long as each task only writes
+// state that no other task touches.
+typedef void (*ParallelTask)(void *ctx, int task);
+
+// Online CPU count (at least 1)
+int parallel_cpu_count(void);
+
+// Default worker count used when a caller passes threads <= 0.
+// 0 (the initial value) means one per CPU.
+void parallel_set_thread_count(int threads);
+int parallel_thread_count(void);
+
+// The calling thread works too; returns once every task has finished.
+// threads <= 0 uses parallel_thread_count().
+void parallel_for(int task_count, int threads, ParallelTask task, void *ctx);
+
+#endif
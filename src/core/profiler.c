@@ -0,0 +1,189 @@
+#include "core/profiler.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+typedef struct ProfilerFrame {
+    float frame_ms;
+    float zone_ms[PROFILER_MAX_ZONES];
+} ProfilerFrame;
+
+typedef struct OpenZone {
+    int zone;
+    uint64_t start;
+} OpenZone;
+
+// Only the profiled thread touches anything below the thread flag
+static _Thread_local bool profiled_thread = false;
+
+static const char *zone_names[PROFILER_MAX_ZONES];
+static int zone_count = 0;
+
+static ProfilerFrame frames[PROFILER_FRAMES];
+static int frame_head = 0;      // slot the next completed frame goes to
+static int frames_recorded = 0;
+static ProfilerFrame current;
+static uint64_t frame_start = 0;
+
+static OpenZone open_zones[PROFILER_MAX_DEPTH];
+static int depth = 0;
+
+// Forward declarations for internal helper functions
+static int zone_id(const char *name);
+static const ProfilerFrame *frame_at(int age);
+static int compare_double(const void *a, const void *b);
+static int compare_zone_stat(const void *a, const void *b);
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void profiler_init(void) {
+    profiled_thread = true;
+    zone_count = 0;
+    frame_head = 0;
+    frames_recorded = 0;
+    depth = 0;
+    frame_start = 0;
+    memset(&current, 0, sizeof(current));
+}
+
+void profiler_frame_mark(void) {
+    if (!profiled_thread) return;
+    uint64_t now = profiler_now_ns();
+    if (frame_start != 0) {
+        current.frame_ms = (float)((now - frame_start) * 1e-6);
+        frames[frame_head] = current;
+        frame_head = (frame_head + 1) % PROFILER_FRAMES;
+        if (frames_recorded < PROFILER_FRAMES) frames_recorded++;
+    }
+    memset(&current, 0, sizeof(current));
+    frame_start = now;
+}
+
+void profiler_zone_begin(const char *name) {
+    trace_zone_begin(name);
+    if (!profiled_thread) return;
+    if (depth >= PROFILER_MAX_DEPTH) {
+        depth++; // still counted, so the matching end stays balanced
+        return;
+    }
+    open_zones[depth].zone = zone_id(name);
+    open_zones[depth].start = profiler_now_ns();
+    depth++;
+}
+
+void profiler_zone_end(void) {
+    trace_zone_end();
+    if (!profiled_thread || depth == 0) return;
+    depth--;
+    if (depth >= PROFILER_MAX_DEPTH) return;
+
+    OpenZone *zone = &open_zones[depth];
+    if (zone->zone < 0) return; // more names than PROFILER_MAX_ZONES
+    current.zone_ms[zone->zone] += (float)((profiler_now_ns() - zone->start) * 1e-6);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+int profiler_frame_count(void) {
+    return frames_recorded;
+}
+
+double profiler_frame_ms(int age) {
+    const ProfilerFrame *frame = frame_at(age);
+    return (frame != NULL) ? frame->frame_ms : 0.0;
+}
+
+void profiler_percentiles(double *out_p50, double *out_p95, double *out_p99) {
+    double sorted[PROFILER_FRAMES];
+    int n = frames_recorded;
+    for (int i = 0; i < n; i++) {
+        sorted[i] = frame_at(i)->frame_ms;
+    }
+    qsort(sorted, n, sizeof(double), compare_double);
+
+    // Nearest rank
+    *out_p50 = (n > 0) ? sorted[(50 * n + 99) / 100 - 1] : 0.0;
+    *out_p95 = (n > 0) ? sorted[(95 * n + 99) / 100 - 1] : 0.0;
+    *out_p99 = (n > 0) ? sorted[(99 * n + 99) / 100 - 1] : 0.0;
+}
+
+int profiler_top_zones(ProfilerZoneStat *out, int max) {
+    ProfilerZoneStat stats[PROFILER_MAX_ZONES];
+    int n = frames_recorded;
+    for (int z = 0; z < zone_count; z++) {
+        double total = 0.0;
+        double worst = 0.0;
+        for (int i = 0; i < n; i++) {
+            double ms = frame_at(i)->zone_ms[z];
+            total += ms;
+            if (ms > worst) worst = ms;
+        }
+        stats[z].name = zone_names[z];
+        stats[z].avg_ms = (n > 0) ? total / n : 0.0;
+        stats[z].max_ms = worst;
+    }
+    qsort(stats, zone_count, sizeof(ProfilerZoneStat), compare_zone_stat);
+
+    int count = (zone_count < max) ? zone_count : max;
+    memcpy(out, stats, sizeof(ProfilerZoneStat) * count);
+    return count;
+}
+
+uint64_t profiler_now_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart * 1000000000.0 / frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Zone names are nearly always the same literal, so compare pointers first
+static int zone_id(const char *name) {
+    for (int z = 0; z < zone_count; z++) {
+        if (zone_names[z] == name) return z;
+    }
+    for (int z = 0; z < zone_count; z++) {
+        if (strcmp(zone_names[z], name) == 0) return z;
+    }
+    if (zone_count >= PROFILER_MAX_ZONES) return -1;
+    zone_names[zone_count] = name;
+    return zone_count++;
+}
+
+static const ProfilerFrame *frame_at(int age) {
+    if (age < 0 || age >= frames_recorded) return NULL;
+    int slot = (frame_head - 1 - age + PROFILER_FRAMES) % PROFILER_FRAMES;
+    return &frames[slot];
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_zone_stat(const void *a, const void *b) {
+    double x = ((const ProfilerZoneStat *)a)->avg_ms;
+    double y = ((const ProfilerZoneStat *)b)->avg_ms;
+    return (x < y) - (x > y);
+}
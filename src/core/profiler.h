@@ -0,0 +1,64 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "core/trace.h"
+#include <stdint.h>
+
+#define PROFILER_FRAMES 240     // frames kept in the ring buffer
+#define PROFILER_MAX_ZONES 32   // distinct zone names
+#define PROFILER_MAX_DEPTH 16   // nesting depth
+
+// Timing zones around main-loop stages and key functions. Build with
+// PROFILER_ENABLED to compile them in; otherwise every macro expands to
+// nothing. The frame statistics only cover the thread that called
+// profiler_init. While a trace recording runs (core/trace.h), zones on every
+// thread and PROFILE_COUNTER values also go to the trace file.
+//
+//     PROFILE_BEGIN("render_game");
+//     ...
+//     PROFILE_END();
+//
+// Every PROFILE_BEGIN needs a PROFILE_END on each path out of the scope.
+// Threads that record zones call PROFILE_THREAD_EXIT() before they exit.
+#ifdef PROFILER_ENABLED
+#define PROFILE_INIT() profiler_init()
+#define PROFILE_FRAME() profiler_frame_mark()
+#define PROFILE_BEGIN(name) profiler_zone_begin(name)
+#define PROFILE_END() profiler_zone_end()
+#define PROFILE_COUNTER(name, value) trace_counter(name, value)
+#define PROFILE_THREAD_EXIT() trace_thread_exit()
+#else
+#define PROFILE_INIT() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)sizeof(value)) // keeps counter locals "used"
+#define PROFILE_THREAD_EXIT() ((void)0)
+#endif
+
+typedef struct ProfilerZoneStat {
+    const char *name;
+    double avg_ms;  // inclusive time per frame, averaged over the ring buffer
+    double max_ms;  // worst single frame in the ring buffer
+} ProfilerZoneStat;
+
+// Makes the calling thread the profiled one
+void profiler_init(void);
+
+// Closes the current frame and opens the next; call once per loop iteration
+void profiler_frame_mark(void);
+
+// `name` should be a string literal; zones are matched by pointer first
+void profiler_zone_begin(const char *name);
+void profiler_zone_end(void);
+
+// Queries over the ring buffer, for the overlay
+int profiler_frame_count(void);
+double profiler_frame_ms(int age); // age 0 is the last completed frame
+void profiler_percentiles(double *out_p50, double *out_p95, double *out_p99);
+int profiler_top_zones(ProfilerZoneStat *out, int max); // sorted by avg_ms, descending
+
+// Monotonic clock in nanoseconds
+uint64_t profiler_now_ns(void);
+
+#endif
@@ -0,0 +1,36 @@
+#include "core/rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream) {
+    rng->state = 0;
+    rng->inc = (stream << 1) | 1u;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+uint32_t rng_next(Rng *rng) {
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+int rng_range(Rng *rng, int bound) {
+    // Rejection sampling removes the modulo bias
+    uint32_t b = (uint32_t)bound;
+    uint32_t threshold = (0u - b) % b;
+    for (;;) {
+        uint32_t r = rng_next(rng);
+        if (r >= threshold) return (int)(r % b);
+    }
+}
+
+uint64_t rng_mix(uint64_t seed, uint64_t value) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (value + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,34 @@
+#ifndef RNG_H_
+#define RNG_H_
+
+#include <stdint.h>
+
+// PCG32 generator (O'Neill, pcg-random.org): 64-bit state, 32-bit output.
+// Each subsystem draws from its own stream, so adding a roll in one place
+// never shifts the numbers another subsystem sees.
+typedef struct Rng {
+    uint64_t state;
+    uint64_t inc; // stream selector, always odd
+} Rng;
+
+// Stream ids for the subsystems that consume randomness
+typedef enum {
+    RNG_STREAM_MAP = 1,
+    RNG_STREAM_STRUCTURES,
+    RNG_STREAM_SPAWNING,
+    RNG_STREAM_AI,
+    RNG_STREAM_COMBAT,
+    RNG_STREAM_SEARCH
+} RngStream;
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream);
+uint32_t rng_next(Rng *rng);
+
+// Uniform integer in [0, bound); bound must be positive
+int rng_range(Rng *rng, int bound);
+
+// Mixes a value into a seed (SplitMix64 finaliser), for deriving
+// independent per-chunk or per-actor seeds from the match seed
+uint64_t rng_mix(uint64_t seed, uint64_t value);
+
+#endif
@@ -0,0 +1,357 @@
+#include "core/trace.h"
+#include "core/profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+typedef struct TraceEvent {
+    const char *name;   // NULL for zone ends
+    uint64_t ts;        // nanoseconds since trace_start
+    int64_t value;      // counters only
+    char phase;         // 'B', 'E' or 'C', as in the Chrome format
+} TraceEvent;
+
+typedef struct TraceBuffer {
+    struct TraceBuffer *next;   // writer queue link
+    int session;                // recording the events belong to
+    int tid;
+    int count;
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+} TraceBuffer;
+
+// Read on every event without the lock
+static int recording = 0;
+static int session = 0;
+static int next_tid = 0;
+static uint64_t start_ns = 0;
+
+// Writer queue, guarded by queue_lock
+#if defined(_WIN32)
+static SRWLOCK queue_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE queue_ready = CONDITION_VARIABLE_INIT;
+static HANDLE writer_thread = NULL;
+#else
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_ready = PTHREAD_COND_INITIALIZER;
+static pthread_t writer_thread;
+#endif
+static TraceBuffer *queue_head = NULL;
+static TraceBuffer *queue_tail = NULL;
+static bool writer_running = false;
+static bool stop_requested = false;
+
+// Owned by the writer thread between trace_start and trace_stop
+static FILE *trace_file = NULL;
+static long events_written = 0;
+static int main_tid = 0;
+static bool named_threads[TRACE_MAX_THREADS];
+
+static _Thread_local TraceBuffer *local_buffer = NULL;
+static _Thread_local int local_tid = 0;  // 0 until the thread records its first event
+
+// Forward declarations for internal helper functions
+static int load_int(int *value);
+static void store_int(int *value, int new_value);
+static int thread_id(void);
+static void record(char phase, const char *name, int64_t value);
+static TraceEvent *next_event(void);
+static void submit(TraceBuffer *buffer);
+static void queue_lock_acquire(void);
+static void queue_lock_release(void);
+static void queue_wait(void);
+static void queue_signal(void);
+static bool writer_start(void);
+static void writer_join(void);
+static void writer_loop(void);
+static void write_buffer(const TraceBuffer *buffer);
+#if defined(_WIN32)
+static DWORD WINAPI writer_main(LPVOID arg);
+#else
+static void *writer_main(void *arg);
+#endif
+
+// ============================================================================
+// Recording Control
+// ============================================================================
+
+bool trace_start(const char *path) {
+    if (trace_is_recording()) {
+        fprintf(stderr, "Error: A trace is already recording\n");
+        return false;
+    }
+
+    trace_file = fopen(path, "w");
+    if (trace_file == NULL) {
+        fprintf(stderr, "Error: Failed to open trace file '%s'\n", path);
+        return false;
+    }
+    fputs("{\"traceEvents\":[\n", trace_file);
+    events_written = 0;
+    main_tid = thread_id();
+    memset(named_threads, 0, sizeof(named_threads));
+
+    queue_lock_acquire();
+    queue_head = NULL;
+    queue_tail = NULL;
+    stop_requested = false;
+    writer_running = true;
+    queue_lock_release();
+
+    if (!writer_start()) {
+        fprintf(stderr, "Error: Failed to start trace writer thread\n");
+        queue_lock_acquire();
+        writer_running = false;
+        queue_lock_release();
+        fclose(trace_file);
+        trace_file = NULL;
+        return false;
+    }
+
+    // Buffers left over from an earlier recording see the new session and
+    // start over instead of being written into this file
+    store_int(&session, load_int(&session) + 1);
+    start_ns = profiler_now_ns();
+    store_int(&recording, 1);
+    return true;
+}
+
+void trace_stop(void) {
+    if (!trace_is_recording()) return;
+    store_int(&recording, 0);
+    trace_thread_exit();
+
+    queue_lock_acquire();
+    stop_requested = true;
+    queue_signal();
+    queue_lock_release();
+    writer_join();
+}
+
+bool trace_is_recording(void) {
+    return load_int(&recording) != 0;
+}
+
+// ============================================================================
+// Events
+// ============================================================================
+
+void trace_zone_begin(const char *name) {
+    if (!trace_is_recording()) return;
+    record('B', name, 0);
+}
+
+void trace_zone_end(void) {
+    if (!trace_is_recording()) return;
+    record('E', NULL, 0);
+}
+
+void trace_counter(const char *name, int64_t value) {
+    if (!trace_is_recording()) return;
+    record('C', name, value);
+}
+
+void trace_thread_exit(void) {
+    TraceBuffer *buffer = local_buffer;
+    if (buffer == NULL) return;
+    local_buffer = NULL;
+    if (buffer->count > 0) {
+        submit(buffer);
+    } else {
+        free(buffer);
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static int load_int(int *value) {
+#if defined(_WIN32)
+    return (int)InterlockedCompareExchange((volatile LONG *)value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void store_int(int *value, int new_value) {
+#if defined(_WIN32)
+    InterlockedExchange((volatile LONG *)value, (LONG)new_value);
+#else
+    __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+#endif
+}
+
+static int thread_id(void) {
+    if (local_tid == 0) {
+#if defined(_WIN32)
+        local_tid = (int)InterlockedIncrement((volatile LONG *)&next_tid);
+#else
+        local_tid = __atomic_add_fetch(&next_tid, 1, __ATOMIC_RELAXED);
+#endif
+    }
+    return local_tid;
+}
+
+static void record(char phase, const char *name, int64_t value) {
+    uint64_t now = profiler_now_ns();
+    TraceEvent *event = next_event();
+    if (event == NULL) return;
+    event->name = name;
+    event->ts = now - start_ns;
+    event->value = value;
+    event->phase = phase;
+}
+
+static TraceEvent *next_event(void) {
+    int current = load_int(&session);
+    TraceBuffer *buffer = local_buffer;
+
+    if (buffer != NULL && buffer->session != current) {
+        // Never handed over before an earlier recording stopped
+        buffer->session = current;
+        buffer->count = 0;
+    }
+    if (buffer != NULL && buffer->count == TRACE_BUFFER_EVENTS) {
+        submit(buffer);
+        buffer = NULL;
+    }
+    if (buffer == NULL) {
+        buffer = malloc(sizeof(TraceBuffer));
+        if (buffer == NULL) {
+            local_buffer = NULL;
+            return NULL;
+        }
+        buffer->next = NULL;
+        buffer->session = current;
+        buffer->tid = thread_id();
+        buffer->count = 0;
+    }
+    local_buffer = buffer;
+    return &buffer->events[buffer->count++];
+}
+
+// Buffers that arrive after the writer has finished, or that belong to an
+// older recording, are dropped
+static void submit(TraceBuffer *buffer) {
+    buffer->next = NULL;
+    queue_lock_acquire();
+    if (writer_running && buffer->session == load_int(&session)) {
+        if (queue_tail != NULL) {
+            queue_tail->next = buffer;
+        } else {
+            queue_head = buffer;
+        }
+        queue_tail = buffer;
+        queue_signal();
+        buffer = NULL;
+    }
+    queue_lock_release();
+    free(buffer);
+}
+
+#if defined(_WIN32)
+static void queue_lock_acquire(void) { AcquireSRWLockExclusive(&queue_lock); }
+static void queue_lock_release(void) { ReleaseSRWLockExclusive(&queue_lock); }
+static void queue_wait(void) { SleepConditionVariableSRW(&queue_ready, &queue_lock, INFINITE, 0); }
+static void queue_signal(void) { WakeConditionVariable(&queue_ready); }
+
+static bool writer_start(void) {
+    writer_thread = CreateThread(NULL, 0, writer_main, NULL, 0, NULL);
+    return writer_thread != NULL;
+}
+
+static void writer_join(void) {
+    WaitForSingleObject(writer_thread, INFINITE);
+    CloseHandle(writer_thread);
+    writer_thread = NULL;
+}
+
+static DWORD WINAPI writer_main(LPVOID arg) {
+    (void)arg;
+    writer_loop();
+    return 0;
+}
+#else
+static void queue_lock_acquire(void) { pthread_mutex_lock(&queue_lock); }
+static void queue_lock_release(void) { pthread_mutex_unlock(&queue_lock); }
+static void queue_wait(void) { pthread_cond_wait(&queue_ready, &queue_lock); }
+static void queue_signal(void) { pthread_cond_signal(&queue_ready); }
+
+static bool writer_start(void) {
+    return pthread_create(&writer_thread, NULL, writer_main, NULL) == 0;
+}
+
+static void writer_join(void) {
+    pthread_join(writer_thread, NULL);
+}
+
+static void *writer_main(void *arg) {
+    (void)arg;
+    writer_loop();
+    return NULL;
+}
+#endif
+
+// Drains the queue until trace_stop asks it to finish, then closes the file
+static void writer_loop(void) {
+    queue_lock_acquire();
+    for (;;) {
+        while (queue_head == NULL && !stop_requested) {
+            queue_wait();
+        }
+        TraceBuffer *buffer = queue_head;
+        if (buffer == NULL) break;
+        queue_head = buffer->next;
+        if (queue_head == NULL) queue_tail = NULL;
+
+        queue_lock_release();
+        write_buffer(buffer);
+        free(buffer);
+        queue_lock_acquire();
+    }
+    writer_running = false;
+    queue_lock_release();
+
+    fputs("\n]}\n", trace_file);
+    fclose(trace_file);
+    trace_file = NULL;
+}
+
+// Names are written unescaped; zone and counter names are plain identifiers
+static void write_buffer(const TraceBuffer *buffer) {
+    int tid = buffer->tid;
+    if (tid < TRACE_MAX_THREADS && !named_threads[tid]) {
+        named_threads[tid] = true;
+        fprintf(trace_file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"name\":\"%s %d\"}}", events_written++ > 0 ? ",\n" : "", tid,
+                tid == main_tid ? "main" : "worker", tid);
+    }
+
+    for (int i = 0; i < buffer->count; i++) {
+        const TraceEvent *event = &buffer->events[i];
+        const char *separator = events_written++ > 0 ? ",\n" : "";
+        double ts_us = (double)event->ts * 1e-3;
+        switch (event->phase) {
+            case 'B':
+                fprintf(trace_file, "%s{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                        separator, event->name, ts_us, tid);
+                break;
+            case 'E':
+                fprintf(trace_file, "%s{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                        separator, ts_us, tid);
+                break;
+            default:
+                fprintf(trace_file, "%s{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,"
+                        "\"args\":{\"value\":%lld}}", separator, event->name, ts_us, tid,
+                        (long long)event->value);
+                break;
+        }
+    }
+}
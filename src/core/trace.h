@@ -0,0 +1,36 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TRACE_BUFFER_EVENTS 4096    // events per thread buffer
+#define TRACE_MAX_THREADS 256       // distinct thread ids named in the file
+
+// Chrome trace event recording, viewable in chrome://tracing or
+// ui.perfetto.dev. While a recording runs, profiler zones on every thread
+// and PROFILE_COUNTER values become trace events. Each thread appends to its
+// own buffer; full buffers are handed to a background writer thread, so the
+// recording threads never touch the file.
+
+// Opens `path` and starts the writer thread. Returns false if a recording is
+// already running or the file cannot be opened.
+bool trace_start(const char *path);
+
+// Flushes the calling thread's buffer, waits for the writer to finish the
+// file and closes it. Other threads flush through trace_thread_exit.
+void trace_stop(void);
+
+bool trace_is_recording(void);
+
+// Event recording; no-ops unless a recording runs. Names should be string
+// literals, since they are written out long after the call returns.
+void trace_zone_begin(const char *name);
+void trace_zone_end(void);
+void trace_counter(const char *name, int64_t value);
+
+// Hands the calling thread's buffer to the writer. Threads that may record
+// events call this before exiting; parallel_for workers do.
+void trace_thread_exit(void);
+
+#endif
@@ -1,7 +1,6 @@
 #include "game/actions.h"
 #include <stdlib.h>
 #include <string.h>
-#include "raylib.h"
 
 
 void skill_free(Skill *skill) {
@@ -13,7 +12,7 @@ void skill_free(Skill *skill) {
     }
 }
 
-Skill spear_strike = {
+static const Skill spear_strike = {
     .name = "Spear Strike",
     .id = 101,
     .damage = -1, // Damage to be set dynamically
@@ -22,7 +21,7 @@ Skill spear_strike = {
     .range = 1, 
     .area_of_effect = NULL,
     .aoe_size = 0,
-    .icon = {0}
+    .icon = SPRITE_ICON_SPEAR_STRIKE
 };
 
 void action_copy_spear_strike(Skill *dest_skill) {
@@ -31,7 +30,7 @@ void action_copy_spear_strike(Skill *dest_skill) {
     return;
 }
 
-Skill bite = {
+static const Skill bite = {
     .name = "Bite",
     .id = 102,
     .damage = -1, // Damage to be set dynamically
@@ -40,7 +39,7 @@ Skill bite = {
     .range = 1, 
     .area_of_effect = NULL,
     .aoe_size = 0,
-    .icon = {0}
+    .icon = SPRITE_NONE
 };
 
 void action_copy_bite(Skill *dest_skill) {
@@ -49,20 +48,6 @@ void action_copy_bite(Skill *dest_skill) {
     return;
 }
 
-// Load action-related icons/resources. Call after InitWindow.
-void actions_load_icons(void) {
-    // Load spear strike icon
-    spear_strike.icon = LoadTexture("../../resources/actions/spear_strike_icon.png");
-    // If there were other action icons, load them similarly, e.g.:
-    // bite.icon = LoadTexture("../../resources/actions/bite_icon.png");
-}
-
-// Unload action-related icons/resources. Call during cleanup after actors freed.
-void actions_unload_icons(void) {
-    if (spear_strike.icon.id) UnloadTexture(spear_strike.icon);
-    if (bite.icon.id) UnloadTexture(bite.icon);
-}
-
 void action_set_damage(Skill *skill, Actor *owner) {
     if (skill == NULL) return;
     if (owner == NULL) return;
@@ -1,5 +1,8 @@
 #include "game/actor.h"
 #include "game/actions.h"
+#include "game/map.h"
+#include "game/zobrist.h"
+#include "core/log.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -30,11 +33,15 @@ static const ActorTemplate DEFAULT_WARG = {
     .attack_range = 1
 };
 
+// Forward declarations for internal helper functions
+static uint64_t state_key(const Actor *actor);
+static void rehash(Actor *actor);
+
 // ============================================================================
 // Actor Creation and Initialization
 // ============================================================================
 
-Actor *militia_create(Faction *owner, Texture2D sprite) {
+Actor *militia_create(Faction *owner, SpriteId sprite) {
     Actor *actor = malloc(sizeof(Actor));
     if (actor == NULL) {
         fprintf(stderr, "Error: Failed to allocate memory for actor\n");
@@ -45,7 +52,7 @@ Actor *militia_create(Faction *owner, Texture2D sprite) {
     return actor;
 }
 
-Actor *actor_create_from_template(Faction *owner, Texture2D sprite, ActorTemplate *template) {
+Actor *actor_create_from_template(Faction *owner, SpriteId sprite, ActorTemplate *template) {
     Actor *actor = malloc(sizeof(Actor));
     if (actor == NULL) {
         fprintf(stderr, "Error: Failed to allocate memory for actor\n");
@@ -55,9 +62,13 @@ Actor *actor_create_from_template(Faction *owner, Texture2D sprite, ActorTemplat
     return actor;
 }
 
-void militia_init(Actor *actor, Faction *owner, Texture2D sprite) {
+void militia_init(Actor *actor, Faction *owner, SpriteId sprite) {
     actor->sprite = sprite;
     actor->owner = owner;
+    actor->id = 0;
+    actor->cell = MAP_NO_CELL;
+    actor->hash = NULL;
+    actor->hash_key = 0;
     
     // Initialize action flags
     actor->can_move = true;
@@ -65,6 +76,7 @@ void militia_init(Actor *actor, Faction *owner, Texture2D sprite) {
     
     // Initialize level and experience
     actor->level = 1;
+    actor->level_up_pending = false;
     actor->next_level_xp = 100;
     
     // Initialize stats from default template
@@ -88,14 +100,19 @@ void militia_init(Actor *actor, Faction *owner, Texture2D sprite) {
 }
 
 void actor_init_from_template(Actor *actor, Faction *owner, 
-                              Texture2D sprite, ActorTemplate *template) {
+                              SpriteId sprite, ActorTemplate *template) {
     actor->sprite = sprite;
     actor->owner = owner;
+    actor->id = 0;
+    actor->cell = MAP_NO_CELL;
+    actor->hash = NULL;
+    actor->hash_key = 0;
     
     actor->can_move = true;
     actor->can_act = true;
     
     actor->level = 1;
+    actor->level_up_pending = false;
     actor->next_level_xp = 100;
     
     // Use template stats
@@ -139,11 +156,39 @@ void actor_free(Actor *actor) {
 void actor_reset_turn_flags(Actor *actor) {
     actor->can_move = true;
     actor->can_act = true;
+    rehash(actor);
 }
 
 void actor_end_turn(Actor *actor) {
     actor->can_move = false;
     actor->can_act = false;
+    rehash(actor);
+}
+
+void actor_spend_move(Actor *actor) {
+    actor->can_move = false;
+    rehash(actor);
+}
+
+void actor_spend_action(Actor *actor) {
+    actor->can_act = false;
+    rehash(actor);
+}
+
+void actor_set_turn_flags(Actor *actor, bool can_move, bool can_act) {
+    actor->can_move = can_move;
+    actor->can_act = can_act;
+    rehash(actor);
+}
+
+void actor_attach_hash(Actor *actor, uint64_t *hash) {
+    if (actor->hash == hash) return;
+    if (actor->hash != NULL) *actor->hash ^= actor->hash_key;
+    actor->hash = hash;
+    if (hash != NULL) {
+        actor->hash_key = state_key(actor);
+        *hash ^= actor->hash_key;
+    }
 }
 
 bool actor_can_perform_action(Actor *actor) {
@@ -165,10 +210,11 @@ void actor_take_damage(Actor *actor, int damage) {
     if (actor->curr_health < 0) {
         actor->curr_health = 0;
     }
+    rehash(actor);
     
     // Log death
     if (!actor_is_alive(actor)) {
-        printf("%s has been defeated!\n", actor->name);
+        log_info("%s has been defeated!\n", actor->name);
     }
 }
 
@@ -179,6 +225,7 @@ void actor_heal(Actor *actor, int amount) {
     if (actor->curr_health > actor->max_health) {
         actor->curr_health = actor->max_health;
     }
+    rehash(actor);
 }
 
 void actor_gain_experience(Actor *actor, int xp) {
@@ -188,7 +235,7 @@ void actor_gain_experience(Actor *actor, int xp) {
     if (actor->next_level_xp <= 0) {
         actor->next_level_xp = 0;
         actor->level_up_pending = true;
-        printf("%s has enough experience to level up (manual).\n", actor->name);
+        log_info("%s has enough experience to level up (manual).\n", actor->name);
     }
 }
 
@@ -198,6 +245,7 @@ void actor_level_up(Actor *actor) {
     // Stat increases (basic formula, can be expanded)
     actor->max_health += 3;
     actor->curr_health = actor->max_health; // Full heal on level up
+    rehash(actor);
     actor->phys_attack += 1;
     actor->phys_defense += 1;
     actor->magic_attack += 1;
@@ -207,7 +255,7 @@ void actor_level_up(Actor *actor) {
     actor->next_level_xp = 100 * actor->level;
     // Clear pending flag when level-up is performed manually
     actor->level_up_pending = false;
-    printf("%s leveled up to level %d!\n", actor->name, actor->level);
+    log_info("%s leveled up to level %d!\n", actor->name, actor->level);
 }
 
 // ============================================================================
@@ -236,7 +284,7 @@ bool actor_has_pending_level_up(Actor *actor) {
 // ============================================================================
 
 Actor *actor_array_create_from_template(int count, Faction *owner,
-                                        Texture2D sprite, ActorTemplate *template) {
+                                        SpriteId sprite, ActorTemplate *template) {
     Actor *actors = malloc(sizeof(Actor) * count);
     
     if (actors == NULL) {
@@ -293,4 +341,22 @@ void actor_get_default_warg_template(ActorTemplate *out) {
 void actor_get_default_militia_template(ActorTemplate *out) {
     if (out == NULL) return;
     memcpy(out, &DEFAULT_MILITIA, sizeof(ActorTemplate));
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// The actor's part of the map hash, keyed by its handle
+static uint64_t state_key(const Actor *actor) {
+    uint32_t flags = (actor->can_move ? 2u : 0u) | (actor->can_act ? 1u : 0u);
+    return zobrist_key(ZOBRIST_ACTOR, (uint32_t)actor->id, ((uint32_t)actor->curr_health << 2) | flags);
+}
+
+// Swaps the actor's old key for its current one
+static void rehash(Actor *actor) {
+    if (actor->hash == NULL) return;
+    uint64_t key = state_key(actor);
+    *actor->hash ^= actor->hash_key ^ key;
+    actor->hash_key = key;
+}
@@ -2,17 +2,19 @@
 #define ACTOR_H_
 
 #include "types.h"
-#include "raylib.h"
 #include <stdbool.h>
 
 // Actor creation and initialization
-Actor *militia_create(Faction *owner, Texture2D sprite);
-void militia_init(Actor *actor, Faction *owner, Texture2D sprite);
+Actor *militia_create(Faction *owner, SpriteId sprite);
+void militia_init(Actor *actor, Faction *owner, SpriteId sprite);
 void actor_free(Actor *actor);
 
 // Actor state management
 void actor_reset_turn_flags(Actor *actor);
 void actor_end_turn(Actor *actor);
+void actor_spend_move(Actor *actor);    // clears can_move
+void actor_spend_action(Actor *actor);  // clears can_act
+void actor_set_turn_flags(Actor *actor, bool can_move, bool can_act);
 bool actor_can_perform_action(Actor *actor);
 bool actor_is_alive(Actor *actor);
 
@@ -23,6 +25,11 @@ void actor_gain_experience(Actor *actor, int xp);
 void actor_level_up(Actor *actor);
 bool actor_has_pending_level_up(Actor *actor);
 
+// State hash: hit points and turn flags are folded into `hash` (the
+// map's, see map_hash) and every change through this API keeps it current.
+// NULL detaches the actor, taking its key back out.
+void actor_attach_hash(Actor *actor, uint64_t *hash);
+
 // Actor queries
 bool actor_belongs_to_faction(Actor *actor, Faction *faction);
 bool actor_is_enemy(Actor *actor1, Actor *actor2);
@@ -42,16 +49,16 @@ typedef struct {
 } ActorTemplate;
 
 // Actor arrays and groups
-Actor *actor_array_create_from_template(int count, Faction *owner, Texture2D sprite, ActorTemplate *template);
+Actor *actor_array_create_from_template(int count, Faction *owner, SpriteId sprite, ActorTemplate *template);
 void actor_array_free(Actor *actors, int count);
 void actor_array_reset_turns(Actor *actors, int count);
 int actor_array_count_alive(Actor *actors, int count);
 
 void actor_init_from_template(Actor *actor, Faction *owner, 
-                              Texture2D sprite, ActorTemplate *template);
+                              SpriteId sprite, ActorTemplate *template);
 
 // Allocate and initialize an actor from a template
-Actor *actor_create_from_template(Faction *owner, Texture2D sprite, ActorTemplate *template);
+Actor *actor_create_from_template(Faction *owner, SpriteId sprite, ActorTemplate *template);
 
 // Helpers to expose default templates from actor.c
 void actor_get_default_warg_template(ActorTemplate *out);
@@ -0,0 +1,479 @@
+#include "game/alphabeta.h"
+#include "core/rng.h"
+#include "core/log.h"
+#include "core/profiler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define AB_MAX_PLY 32
+#define AB_MAX_ACTIONS 1024         // per decision
+#define AB_TABLE_BITS 18            // transposition table entries, as a power of two
+#define AB_CHECK_INTERVAL 1024      // nodes between deadline checks; a power of two
+#define AB_ZOBRIST_SEED 0x5eed0fab
+
+// Evaluation, from the searching faction's side: hit points and living
+// units, its own minus everyone else's
+#define AB_HEALTH_VALUE 4
+#define AB_UNIT_VALUE 40
+#define AB_WIN 1000000
+#define AB_INFINITY (AB_WIN + 1)
+
+// Move ordering: kills, then hits, then moves; within each, the bigger
+// threat removed or the nearer the enemy, the earlier
+#define AB_ORDER_KILL 20000
+#define AB_ORDER_HIT 10000
+
+typedef enum {
+    AB_BOUND_EXACT,
+    AB_BOUND_LOWER,     // the value is at least this
+    AB_BOUND_UPPER      // the value is at most this
+} AbBound;
+
+typedef struct AbEntry {
+    uint64_t key;           // 0 while empty
+    int32_t value;
+    CompactAction best;
+    uint8_t depth;
+    uint8_t bound;
+} AbEntry;
+
+struct AlphaBeta {
+    AbEntry *table;
+
+    // Zobrist keys. A unit's key is the XOR of its cell, health and flags
+    // keys rotated by its index, so two units never cancel out.
+    uint64_t cell_keys[COMPACT_MAX_CELLS];
+    uint64_t health_keys[256];
+    uint64_t flag_keys[4];
+    uint64_t faction_keys[MAX_FACTIONS];
+
+    // Per search
+    uint8_t root_faction;
+    uint64_t deadline;      // profiler_now_ns() value; 0 for none
+    bool aborted;
+    long long nodes;
+    long long tt_probes;
+    long long tt_hits;
+    CompactAction root_best;
+
+    // Copy-make: ply i searches states[i] and builds states[i + 1]
+    CompactState states[AB_MAX_PLY + 1];
+    CompactAction actions[AB_MAX_PLY][AB_MAX_ACTIONS];
+    int order[AB_MAX_PLY][AB_MAX_ACTIONS];
+    CompactReach reach;
+};
+
+// Forward declarations for internal helper functions
+static int search(AlphaBeta *ab, int ply, int depth, int alpha, int beta, uint64_t hash);
+static int generate_actions(AlphaBeta *ab, int ply, int unit, const CompactAction *first);
+static void order_next(AlphaBeta *ab, int ply, int from, int count);
+static int evaluate(const AlphaBeta *ab, const CompactState *state);
+static uint64_t unit_key(const AlphaBeta *ab, const CompactState *state, int unit);
+static uint64_t full_hash(const AlphaBeta *ab, const CompactState *state);
+static uint64_t apply_hashed(AlphaBeta *ab, CompactState *state, const CompactAction *action, uint64_t hash);
+static uint64_t pass_idle_units(AlphaBeta *ab, CompactState *state, uint64_t hash);
+static void rest_idle_units(CompactState *state);
+static bool in_contact(const CompactState *state, int unit);
+static bool same_action(const CompactAction *a, const CompactAction *b);
+static int count_ready_units(const CompactState *state);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+AlphaBeta *alphabeta_create(void) {
+    AlphaBeta *ab = malloc(sizeof(AlphaBeta));
+    if (ab == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for alpha-beta search\n");
+        return NULL;
+    }
+    ab->table = calloc((size_t)1 << AB_TABLE_BITS, sizeof(AbEntry));
+    if (ab->table == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for transposition table\n");
+        free(ab);
+        return NULL;
+    }
+
+    Rng rng;
+    rng_seed(&rng, AB_ZOBRIST_SEED, RNG_STREAM_SEARCH);
+    uint64_t *keys[] = {ab->cell_keys, ab->health_keys, ab->flag_keys, ab->faction_keys};
+    int counts[] = {COMPACT_MAX_CELLS, 256, 4, MAX_FACTIONS};
+    for (int k = 0; k < 4; k++) {
+        for (int i = 0; i < counts[k]; i++) {
+            keys[k][i] = ((uint64_t)rng_next(&rng) << 32) | rng_next(&rng);
+        }
+    }
+    memset(&ab->reach, 0, sizeof(ab->reach));
+    return ab;
+}
+
+void alphabeta_free(AlphaBeta *ab) {
+    if (ab == NULL) return;
+    free(ab->table);
+    free(ab);
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+bool alphabeta_search(AlphaBeta *ab, const CompactState *state, const AiSearchSettings *settings,
+                      uint64_t budget_ns, CompactAction *out, AiSearchStats *stats) {
+    if (compact_state_next_unit(state) == -1 || compact_state_factions_alive(state) <= 1) return false;
+
+    uint64_t start = profiler_now_ns();
+    ab->deadline = (budget_ns > 0) ? start + budget_ns : 0;
+    ab->aborted = false;
+    ab->nodes = 0;
+    ab->tt_probes = 0;
+    ab->tt_hits = 0;
+    ab->root_faction = state->current_faction;
+
+    compact_state_clone(&ab->states[0], state);
+    uint64_t hash = full_hash(ab, &ab->states[0]);
+
+    // Without a completed iteration, the best-ordered decision stands
+    int count = generate_actions(ab, 0, compact_state_next_unit(state), NULL);
+    order_next(ab, 0, 0, count);
+    *out = ab->actions[0][0];
+
+    int max_depth = (settings->max_depth > 0 && settings->max_depth < AB_MAX_PLY) ? settings->max_depth
+                                                                                 : AB_MAX_PLY;
+    int completed = 0;
+    for (int depth = 1; depth <= max_depth; depth++) {
+        int value = search(ab, 0, depth, -AB_INFINITY, AB_INFINITY, hash);
+        if (ab->aborted) break;
+        *out = ab->root_best;
+        completed = depth;
+        if (value >= AB_WIN || value <= -AB_WIN) break; // decided either way
+    }
+
+    if (stats != NULL) {
+        stats->nodes += ab->nodes;
+        stats->tt_probes += ab->tt_probes;
+        stats->tt_hits += ab->tt_hits;
+        stats->depth_sum += completed;
+        stats->seconds += (double)(profiler_now_ns() - start) * 1e-9;
+        stats->searches++;
+    }
+    return true;
+}
+
+void alphabeta_play_turn(GameState *state, Map *map) {
+    CompactState *compact = malloc(sizeof(CompactState));
+    if (compact == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for search state\n");
+        return;
+    }
+    if (!compact_state_capture(compact, state, map)) {
+        free(compact);
+        return;
+    }
+    AlphaBeta *ab = alphabeta_create();
+    if (ab == NULL) {
+        free(compact);
+        return;
+    }
+
+    PROFILE_BEGIN("alphabeta_turn");
+    const AiSearchSettings *settings = &state->ai_search;
+    uint64_t start = profiler_now_ns();
+    uint64_t budget = (uint64_t)(settings->budget_ms > 0 ? settings->budget_ms : 0) * 1000000ULL;
+    AiSearchStats before = state->ai_stats;
+    int faction = compact->current_faction;
+
+    // Each decision gets an equal share of what is left of the turn budget.
+    // Idle units are only passed on the copy, so the map keeps them ready.
+    for (;;) {
+        rest_idle_units(compact);
+        int ready = count_ready_units(compact);
+        if (ready == 0) break;
+
+        uint64_t budget_ns = 0;
+        if (budget > 0) {
+            uint64_t spent = profiler_now_ns() - start;
+            budget_ns = (spent < budget) ? (budget - spent) / (uint64_t)ready : 1;
+        }
+
+        CompactAction action;
+        if (!alphabeta_search(ab, compact, settings, budget_ns, &action, &state->ai_stats)) break;
+        compact_state_commit(state, map, compact, &action);
+
+        if (!compact_state_capture(compact, state, map) || compact->current_faction != faction) break;
+    }
+
+    const AiSearchStats *after = &state->ai_stats;
+    long long nodes = after->nodes - before.nodes;
+    long long probes = after->tt_probes - before.tt_probes;
+    long long hits = after->tt_hits - before.tt_hits;
+    int searches = after->searches - before.searches;
+    double seconds = (double)(profiler_now_ns() - start) * 1e-9;
+    if (searches > 0) {
+        log_info("%s searched %d decisions, %lld nodes in %.1f ms (%.0f nodes/s, depth %.1f, TT hits %.1f%%)\n",
+                 game_get_current_faction(state)->name, searches, nodes, seconds * 1e3,
+                 seconds > 0.0 ? nodes / seconds : 0.0,
+                 (double)(after->depth_sum - before.depth_sum) / searches,
+                 probes > 0 ? 100.0 * hits / probes : 0.0);
+    }
+    PROFILE_COUNTER("alphabeta_nodes", nodes);
+    PROFILE_END();
+
+    alphabeta_free(ab);
+    free(compact);
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Minimax value of states[ply] from the root faction's side, searched
+// `depth` decisions deep. Returns 0 once the deadline passed; the caller
+// then throws the iteration away.
+static int search(AlphaBeta *ab, int ply, int depth, int alpha, int beta, uint64_t hash) {
+    CompactState *state = &ab->states[ply];
+    ab->nodes++;
+    if ((ab->nodes & (AB_CHECK_INTERVAL - 1)) == 0 && ab->deadline != 0 &&
+        profiler_now_ns() >= ab->deadline) {
+        ab->aborted = true;
+    }
+    if (ab->aborted) return 0;
+
+    // Passing idle units changes this ply's own copy only
+    if (ply > 0) hash = pass_idle_units(ab, state, hash);
+    int unit = compact_state_next_unit(state);
+    if (depth == 0 || ply == AB_MAX_PLY || unit == -1 || compact_state_factions_alive(state) <= 1) {
+        return evaluate(ab, state);
+    }
+
+    // The root always searches, so it always names a best decision
+    const CompactAction *tt_best = NULL;
+    AbEntry *entry = &ab->table[hash & (((uint64_t)1 << AB_TABLE_BITS) - 1)];
+    ab->tt_probes++;
+    if (entry->key == hash) {
+        ab->tt_hits++;
+        tt_best = &entry->best;
+        if (ply > 0 && entry->depth >= depth) {
+            if (entry->bound == AB_BOUND_EXACT) return entry->value;
+            if (entry->bound == AB_BOUND_LOWER && entry->value > alpha) alpha = entry->value;
+            if (entry->bound == AB_BOUND_UPPER && entry->value < beta) beta = entry->value;
+            if (alpha >= beta) return entry->value;
+        }
+    }
+
+    int alpha_in = alpha;
+    int beta_in = beta;
+    bool maximizing = (state->current_faction == ab->root_faction);
+    int best_value = maximizing ? -AB_INFINITY : AB_INFINITY;
+    int best = 0;
+
+    int count = generate_actions(ab, ply, unit, tt_best);
+    for (int i = 0; i < count; i++) {
+        order_next(ab, ply, i, count);
+        CompactState *child = &ab->states[ply + 1];
+        compact_state_clone(child, state);
+        uint64_t child_hash = apply_hashed(ab, child, &ab->actions[ply][i], hash);
+
+        int value = search(ab, ply + 1, depth - 1, alpha, beta, child_hash);
+        if (ab->aborted) return 0;
+
+        if (maximizing ? value > best_value : value < best_value) {
+            best_value = value;
+            best = i;
+        }
+        if (maximizing && value > alpha) alpha = value;
+        if (!maximizing && value < beta) beta = value;
+        if (alpha >= beta) break;
+    }
+
+    // Always replace: the newest search knows the most about this position
+    entry->key = hash;
+    entry->value = best_value;
+    entry->best = ab->actions[ply][best];
+    entry->depth = (uint8_t)depth;
+    if (best_value <= alpha_in) {
+        entry->bound = AB_BOUND_UPPER;
+    } else if (best_value >= beta_in) {
+        entry->bound = AB_BOUND_LOWER;
+    } else {
+        entry->bound = AB_BOUND_EXACT;
+    }
+
+    if (ply == 0) ab->root_best = ab->actions[0][best];
+    return best_value;
+}
+
+// Every cell in movement range, with one decision per enemy that can be
+// struck from it, or a plain move when none can. Each gets an ordering
+// score in order[ply]; `first`, when given and generated, goes ahead of all.
+static int generate_actions(AlphaBeta *ab, int ply, int unit, const CompactAction *first) {
+    const CompactState *state = &ab->states[ply];
+    const CompactUnit *u = &state->units[unit];
+    CompactAction *actions = ab->actions[ply];
+    int *order = ab->order[ply];
+    compact_state_reach(state, unit, &ab->reach);
+
+    // Moves are ranked by distance to the nearest enemy
+    int goal = COMPACT_NO_CELL;
+    int goal_distance = 0;
+    for (int e = 0; e < state->unit_count; e++) {
+        const CompactUnit *enemy = &state->units[e];
+        if (enemy->cell == COMPACT_NO_CELL || enemy->faction == u->faction) continue;
+        int d = compact_state_distance(state, u->cell, enemy->cell);
+        if (goal == COMPACT_NO_CELL || d < goal_distance) {
+            goal = enemy->cell;
+            goal_distance = d;
+        }
+    }
+
+    int count = 0;
+    for (int r = 0; r < ab->reach.count && count < AB_MAX_ACTIONS; r++) {
+        int dest = ab->reach.cells[r];
+        int attacks = 0;
+        if (u->flags & COMPACT_CAN_ACT) {
+            for (int e = 0; e < state->unit_count && count < AB_MAX_ACTIONS; e++) {
+                const CompactUnit *enemy = &state->units[e];
+                if (enemy->cell == COMPACT_NO_CELL || enemy->faction == u->faction) continue;
+                if (compact_state_distance(state, dest, enemy->cell) > u->attack_range) continue;
+                actions[count] = (CompactAction){(int16_t)unit, (int16_t)dest, (int16_t)e};
+                order[count++] = (enemy->health <= u->phys_attack)
+                                     ? AB_ORDER_KILL + enemy->phys_attack
+                                     : AB_ORDER_HIT - enemy->health;
+                attacks++;
+            }
+        }
+        if (attacks == 0 && count < AB_MAX_ACTIONS) {
+            actions[count] = (CompactAction){(int16_t)unit, (int16_t)dest, -1};
+            order[count++] = (goal != COMPACT_NO_CELL) ? -compact_state_distance(state, dest, goal) : 0;
+        }
+    }
+
+    if (first != NULL) {
+        for (int i = 0; i < count; i++) {
+            if (same_action(&actions[i], first)) {
+                order[i] = AB_INFINITY;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+// Selection sort done lazily: swaps the best-ordered of actions
+// [from, count) into `from`, so a cutoff skips sorting the rest
+static void order_next(AlphaBeta *ab, int ply, int from, int count) {
+    CompactAction *actions = ab->actions[ply];
+    int *order = ab->order[ply];
+    int best = from;
+    for (int i = from + 1; i < count; i++) {
+        if (order[i] > order[best]) best = i;
+    }
+    if (best != from) {
+        CompactAction action = actions[from];
+        actions[from] = actions[best];
+        actions[best] = action;
+        int score = order[from];
+        order[from] = order[best];
+        order[best] = score;
+    }
+}
+
+static int evaluate(const AlphaBeta *ab, const CompactState *state) {
+    int winner = compact_state_winner(state);
+    if (winner != -1) return (winner == ab->root_faction) ? AB_WIN : -AB_WIN;
+
+    int value = 0;
+    for (int i = 0; i < state->unit_count; i++) {
+        const CompactUnit *u = &state->units[i];
+        if (u->cell == COMPACT_NO_CELL) continue;
+        int worth = AB_HEALTH_VALUE * u->health + AB_UNIT_VALUE;
+        value += (u->faction == ab->root_faction) ? worth : -worth;
+    }
+    return value;
+}
+
+static uint64_t rotate(uint64_t key, int by) {
+    by &= 63;
+    return (by == 0) ? key : (key << by) | (key >> (64 - by));
+}
+
+// Dead units drop out of the hash
+static uint64_t unit_key(const AlphaBeta *ab, const CompactState *state, int unit) {
+    const CompactUnit *u = &state->units[unit];
+    if (u->cell == COMPACT_NO_CELL) return 0;
+    uint64_t key = ab->cell_keys[u->cell] ^ ab->health_keys[u->health & 255] ^ ab->flag_keys[u->flags & 3];
+    return rotate(key, unit);
+}
+
+static uint64_t full_hash(const AlphaBeta *ab, const CompactState *state) {
+    uint64_t hash = ab->faction_keys[state->current_faction];
+    for (int i = 0; i < state->unit_count; i++) {
+        hash ^= unit_key(ab, state, i);
+    }
+    return hash;
+}
+
+// Applies `action` and returns the new hash: the acting and struck units
+// are swapped out and back in. A turn change resets every unit's flags,
+// so then the hash is rebuilt.
+static uint64_t apply_hashed(AlphaBeta *ab, CompactState *state, const CompactAction *action, uint64_t hash) {
+    int faction = state->current_faction;
+    hash ^= unit_key(ab, state, action->unit);
+    if (action->target >= 0) hash ^= unit_key(ab, state, action->target);
+
+    compact_state_apply(state, action);
+    if (state->current_faction != faction) return full_hash(ab, state);
+
+    hash ^= unit_key(ab, state, action->unit);
+    if (action->target >= 0) hash ^= unit_key(ab, state, action->target);
+    return hash;
+}
+
+// Units that no enemy can meet stand still for free, until one in contact
+// is up. When nobody is in contact, every unit passes once at most and the
+// next one is then searched like any other.
+static uint64_t pass_idle_units(AlphaBeta *ab, CompactState *state, uint64_t hash) {
+    for (int passes = 0; passes < state->unit_count; passes++) {
+        int unit = compact_state_next_unit(state);
+        if (unit == -1 || in_contact(state, unit)) return hash;
+        CompactAction pass = {(int16_t)unit, state->units[unit].cell, -1};
+        hash = apply_hashed(ab, state, &pass, hash);
+    }
+    return hash;
+}
+
+// The same for the root, on the copy alone: the faction's idle units are
+// marked done without handing the turn on, and stay ready on the map
+static void rest_idle_units(CompactState *state) {
+    for (int i = 0; i < state->unit_count; i++) {
+        CompactUnit *u = &state->units[i];
+        if (u->faction != state->current_faction || u->cell == COMPACT_NO_CELL) continue;
+        if (u->flags != 0 && !in_contact(state, i)) u->flags = 0;
+    }
+}
+
+static bool in_contact(const CompactState *state, int unit) {
+    const CompactUnit *u = &state->units[unit];
+    int reach = COMPACT_CONTACT_DISTANCE(u);
+    for (int e = 0; e < state->unit_count; e++) {
+        const CompactUnit *enemy = &state->units[e];
+        if (enemy->cell == COMPACT_NO_CELL || enemy->faction == u->faction) continue;
+        if (compact_state_distance(state, u->cell, enemy->cell) <= reach) return true;
+    }
+    return false;
+}
+
+static bool same_action(const CompactAction *a, const CompactAction *b) {
+    return a->unit == b->unit && a->dest == b->dest && a->target == b->target;
+}
+
+static int count_ready_units(const CompactState *state) {
+    int count = 0;
+    for (int i = 0; i < state->unit_count; i++) {
+        const CompactUnit *u = &state->units[i];
+        if (u->faction == state->current_faction && u->cell != COMPACT_NO_CELL && u->flags != 0) {
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,36 @@
+#ifndef ALPHABETA_H_
+#define ALPHABETA_H_
+
+#include "types.h"
+#include "game/game_logic.h"
+#include "game/compact_state.h"
+#include <stdbool.h>
+
+// Alpha-beta AI for skirmishes. Each ply is one unit's decision (a move
+// plus an optional attack) on a compact copy of the match; the searching
+// faction maximises and every other faction minimises its score (the
+// paranoid assumption). Units no enemy can meet within two turns pass
+// without using up depth. Searches deepen one ply at a time until the
+// deadline or the depth cap, trying the previous iteration's best decision
+// first, then kills, then hits on the weakest enemies, then moves towards
+// the nearest one. A transposition table keyed by a Zobrist hash of unit
+// positions, hit points, turn flags and the faction to move cuts repeated
+// positions; it lives as long as the search object.
+typedef struct AlphaBeta AlphaBeta;
+
+AlphaBeta *alphabeta_create(void);
+void alphabeta_free(AlphaBeta *ab);
+
+// Fills `out` with the best decision for the next unit of the current
+// faction. `budget_ns` bounds the search (0 for none); settings->max_depth
+// caps the plies (0 for none, so give one of the two). Returns false when
+// no unit of the current faction can act or only one faction is left.
+bool alphabeta_search(AlphaBeta *ab, const CompactState *state, const AiSearchSettings *settings,
+                      uint64_t budget_ns, CompactAction *out, AiSearchStats *stats);
+
+// Plays the current faction's units that are in contact with the enemy,
+// splitting the turn budget over them. The others are left ready for the
+// greedy AI. Does nothing when the match does not fit a compact state.
+void alphabeta_play_turn(GameState *state, Map *map);
+
+#endif
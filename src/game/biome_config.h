@@ -5,6 +5,6 @@
 
 // Creates default biome configurations for world generation
 // Returns the number of biomes configured
-int biome_config_get_default(BiomeConfig *configs, int max_configs, Terrain *terrains);
+int biome_config_get_default(BiomeConfig *configs, int max_configs);
 
 #endif
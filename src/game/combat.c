@@ -1,5 +1,8 @@
 #include "game/combat.h"
 #include "game/actor.h"
+#include "core/rng.h"
+#include "core/log.h"
+#include "core/profiler.h"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -12,8 +15,8 @@
 // Forward declarations for internal functions
 static int calculate_hit_chance(Actor *attacker, Actor *defender);
 static int calculate_crit_chance(Actor *attacker, Actor *defender);
-static bool roll_hit(int hit_chance);
-static bool roll_crit(int crit_chance);
+static bool roll_hit(Rng *rng, int hit_chance);
+static bool roll_crit(Rng *rng, int crit_chance);
 static void apply_combat_damage(Actor *actor, int damage);
 
 // ============================================================================
@@ -37,17 +40,17 @@ CombatResult combat_execute(Actor *attacker, Actor *defender) {
 
     apply_combat_damage(defender, result.attacker_damage_dealt);
 
-    printf("%s uses a battle skill on %s for %d damage! (%s: %d/%d HP)\n",
+    log_info("%s uses a battle skill on %s for %d damage! (%s: %d/%d HP)\n",
            attacker->name, defender->name, result.attacker_damage_dealt,
            defender->name, defender->curr_health, defender->max_health);
 
     // Check if defender died
     if (!actor_is_alive(defender)) {
         result.defender_died = true;
-        printf("%s has been defeated!\n", defender->name);
+        log_info("%s has been defeated!\n", defender->name);
         combat_grant_experience(attacker, defender, true);
         // Attacker used their action
-        attacker->can_act = false;
+        actor_spend_action(attacker);
         return result;
     }
 
@@ -55,39 +58,40 @@ CombatResult combat_execute(Actor *attacker, Actor *defender) {
     combat_grant_experience(attacker, defender, false);
 
     // Attacker has used their action
-    attacker->can_act = false;
+    actor_spend_action(attacker);
 
     return result;
 }
 
-CombatResult combat_execute_at_cells(GridConfig *grid_config, Point *map,
-                                     Point *attacker_cell, Point *defender_cell) {
+CombatResult combat_execute_at_cells(Map *map, int attacker_cell, int defender_cell) {
     CombatResult result = {0};
     
+    Actor *attacker = map_get_occupant(map, attacker_cell);
+    Actor *defender = map_get_occupant(map, defender_cell);
+
     // Validate cells have occupants
-    if (attacker_cell->occupant == NULL || defender_cell->occupant == NULL) {
+    if (attacker == NULL || defender == NULL) {
         fprintf(stderr, "Error: Cannot execute combat with empty cells\n");
         return result;
     }
     
-    Actor *attacker = attacker_cell->occupant;
-    Actor *defender = defender_cell->occupant;
-    
     // Validate combat is possible
-    if (!combat_can_attack(grid_config, map, attacker_cell, defender_cell)) {
+    if (!combat_can_attack(map, attacker_cell, defender_cell)) {
         fprintf(stderr, "Error: Combat not possible between these cells\n");
         return result;
     }
     
     // Execute combat
+    PROFILE_BEGIN("combat");
     result = combat_execute(attacker, defender);
+    PROFILE_END();
     
     // Remove dead units from map
     if (result.defender_died) {
-        defender_cell->occupant = NULL;
+        map_remove_actor(map, defender);
     }
     if (result.attacker_died) {
-        attacker_cell->occupant = NULL;
+        map_remove_actor(map, attacker);
     }
     
     return result;
@@ -118,16 +122,15 @@ CombatForecast combat_forecast(Actor *attacker, Actor *defender) {
     return forecast;
 }
 
-bool combat_can_attack(GridConfig *grid_config, Point *map,
-                      Point *attacker_cell, Point *defender_cell) {
+bool combat_can_attack(Map *map, int attacker_cell, int defender_cell) {
+    Actor *attacker = map_get_occupant(map, attacker_cell);
+    Actor *defender = map_get_occupant(map, defender_cell);
+
     // Check cells have occupants
-    if (attacker_cell->occupant == NULL || defender_cell->occupant == NULL) {
+    if (attacker == NULL || defender == NULL) {
         return false;
     }
     
-    Actor *attacker = attacker_cell->occupant;
-    Actor *defender = defender_cell->occupant;
-    
     // Check attacker can act
     if (!attacker->can_act) {
         return false;
@@ -139,7 +142,7 @@ bool combat_can_attack(GridConfig *grid_config, Point *map,
     }
     
     // Check if defender is in range
-    int distance = combat_get_distance(attacker_cell, defender_cell);
+    int distance = combat_get_distance(map, attacker_cell, defender_cell);
     if (distance > attacker->attack_range) {
         return false;
     }
@@ -185,16 +188,15 @@ int combat_calculate_magical_damage(Actor *attacker, Actor *defender) {
 // Combat Queries
 // ============================================================================
 
-bool combat_is_in_range(GridConfig *grid_config, Point *cell1, Point *cell2, int range) {
-    (void)grid_config; // Unused, but kept for API consistency
-    int distance = combat_get_distance(cell1, cell2);
+bool combat_is_in_range(Map *map, int cell1, int cell2, int range) {
+    int distance = combat_get_distance(map, cell1, cell2);
     return distance <= range;
 }
 
-int combat_get_distance(Point *cell1, Point *cell2) {
+int combat_get_distance(Map *map, int cell1, int cell2) {
     // Manhattan distance
-    int dx = abs(cell1->x - cell2->x);
-    int dy = abs(cell1->y - cell2->y);
+    int dx = abs(map_cell_x(map, cell1) - map_cell_x(map, cell2));
+    int dy = abs(map_cell_y(map, cell1) - map_cell_y(map, cell2));
     return dx + dy;
 }
 
@@ -226,7 +228,7 @@ int combat_calculate_experience(Actor *attacker, Actor *defender, bool killed) {
 void combat_grant_experience(Actor *attacker, Actor *defender, bool killed) {
     int xp = combat_calculate_experience(attacker, defender, killed);
     
-    printf("%s gained %d experience!\n", attacker->name, xp);
+    log_info("%s gained %d experience!\n", attacker->name, xp);
     actor_gain_experience(attacker, xp);
 }
 
@@ -250,13 +252,13 @@ static int calculate_crit_chance(Actor *attacker, Actor *defender) {
     return BASE_CRIT_CHANCE;
 }
 
-static bool roll_hit(int hit_chance) {
-    int roll = rand() % 100;
+static bool roll_hit(Rng *rng, int hit_chance) {
+    int roll = rng_range(rng, 100);
     return roll < hit_chance;
 }
 
-static bool roll_crit(int crit_chance) {
-    int roll = rand() % 100;
+static bool roll_crit(Rng *rng, int crit_chance) {
+    int roll = rng_range(rng, 100);
     return roll < crit_chance;
 }
 
@@ -32,13 +32,11 @@ typedef struct {
 
 // Combat execution
 CombatResult combat_execute(Actor *attacker, Actor *defender);
-CombatResult combat_execute_at_cells(GridConfig *grid_config, Point *map, 
-                                     Point *attacker_cell, Point *defender_cell);
+CombatResult combat_execute_at_cells(Map *map, int attacker_cell, int defender_cell);
 
 // Combat prediction (for UI display)
 CombatForecast combat_forecast(Actor *attacker, Actor *defender);
-bool combat_can_attack(GridConfig *grid_config, Point *map, 
-                      Point *attacker_cell, Point *defender_cell);
+bool combat_can_attack(Map *map, int attacker_cell, int defender_cell);
 
 // Damage calculation
 int combat_calculate_damage(Actor *attacker, Actor *defender, bool is_magic);
@@ -46,8 +44,8 @@ int combat_calculate_physical_damage(Actor *attacker, Actor *defender);
 int combat_calculate_magical_damage(Actor *attacker, Actor *defender);
 
 // Combat queries
-bool combat_is_in_range(GridConfig *grid_config, Point *cell1, Point *cell2, int range);
-int combat_get_distance(Point *cell1, Point *cell2);
+bool combat_is_in_range(Map *map, int cell1, int cell2, int range);
+int combat_get_distance(Map *map, int cell1, int cell2);
 bool combat_can_counter_attack(Actor *attacker, Actor *defender, int distance);
 
 // Experience and rewards
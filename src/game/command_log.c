@@ -0,0 +1,189 @@
+#include "game/command_log.h"
+#include "game/actor.h"
+#include "game/replay.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+// Forward declarations for internal helper functions
+static void record(CommandLog *log, const Command *command);
+static uint8_t pack_flags(const Actor *actor);
+static void restore_flags(Actor *actor, uint8_t flags);
+
+// ============================================================================
+// Command Log Creation
+// ============================================================================
+
+CommandLog *command_log_create(void) {
+    CommandLog *log = calloc(1, sizeof(CommandLog));
+    if (log == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for command log\n");
+        return NULL;
+    }
+    log->ring = malloc(sizeof(Command) * COMMAND_LOG_SIZE);
+    if (log->ring == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for command ring\n");
+        free(log);
+        return NULL;
+    }
+    return log;
+}
+
+void command_log_free(CommandLog *log) {
+    if (log == NULL) return;
+    free(log->ring);
+    free(log);
+}
+
+// ============================================================================
+// Recorded Actions
+// ============================================================================
+
+bool command_log_move(CommandLog *log, Map *map, Actor *actor, int dest_cell) {
+    Command command = {0};
+    command.type = COMMAND_MOVE;
+    command.flags = pack_flags(actor);
+    command.from = actor->cell;
+    command.to = dest_cell;
+
+    if (!map_move_actor(map, actor, dest_cell)) return false;
+    actor_spend_move(actor);
+
+    command.actor = (uint16_t)actor->id;
+    if (log != NULL) record(log, &command);
+    return true;
+}
+
+CombatResult command_log_attack(CommandLog *log, Map *map, int attacker_cell, int defender_cell) {
+    Command command = {0};
+    command.type = COMMAND_ATTACK;
+    command.from = attacker_cell;
+    command.to = defender_cell;
+
+    Actor *attacker = map_get_occupant(map, attacker_cell);
+    Actor *defender = map_get_occupant(map, defender_cell);
+    if (attacker != NULL && defender != NULL) {
+        command.flags = pack_flags(attacker);
+        command.actor = (uint16_t)attacker->id;
+        command.target = (uint16_t)defender->id;
+        command.target_health = defender->curr_health;
+        command.next_level_xp = attacker->next_level_xp;
+    }
+
+    // Nothing happened when the blow was refused
+    CombatResult result = combat_execute_at_cells(map, attacker_cell, defender_cell);
+    if (log != NULL && result.attacker != NULL) record(log, &command);
+    return result;
+}
+
+void command_log_wait(CommandLog *log, Actor *actor) {
+    Command command = {0};
+    command.type = COMMAND_WAIT;
+    command.flags = pack_flags(actor);
+    command.actor = (uint16_t)actor->id;
+    command.from = actor->cell;
+    command.to = actor->cell;
+
+    actor_end_turn(actor);
+    // Units that never stood on the map have no handle to find them by
+    if (log != NULL && actor->id != 0) record(log, &command);
+}
+
+// ============================================================================
+// Undo and Redo
+// ============================================================================
+
+bool command_log_can_undo(const CommandLog *log) {
+    // The ring still holds command count - 1 while fewer than
+    // COMMAND_LOG_SIZE commands were recorded after it
+    return log->count > log->floor && log->end - log->count < COMMAND_LOG_SIZE;
+}
+
+bool command_log_can_redo(const CommandLog *log) {
+    return log->count < log->end;
+}
+
+bool command_log_undo(CommandLog *log, Map *map) {
+    if (!command_log_can_undo(log)) return false;
+    const Command *command = &log->ring[(log->count - 1) % COMMAND_LOG_SIZE];
+    Actor *actor = map_get_actor(map, command->actor);
+    if (actor == NULL) return false;
+
+    switch ((CommandType)command->type) {
+        case COMMAND_MOVE:
+            if (command->from == MAP_NO_CELL) {
+                map_remove_actor(map, actor);
+            } else {
+                map_move_actor(map, actor, command->from);
+            }
+            break;
+        case COMMAND_ATTACK: {
+            // A fallen target goes back where it stood
+            Actor *target = map_get_actor(map, command->target);
+            if (target == NULL) return false;
+            if (target->cell == MAP_NO_CELL) {
+                map_move_actor(map, target, command->to);
+            }
+            actor_heal(target, command->target_health - target->curr_health);
+            actor->next_level_xp = command->next_level_xp;
+            break;
+        }
+        case COMMAND_WAIT:
+            break;
+    }
+    restore_flags(actor, command->flags);
+    log->count--;
+    if (log->recorder != NULL) replay_record_undo(log->recorder);
+    return true;
+}
+
+bool command_log_redo(CommandLog *log, Map *map) {
+    if (!command_log_can_redo(log)) return false;
+    const Command *command = &log->ring[log->count % COMMAND_LOG_SIZE];
+    Actor *actor = map_get_actor(map, command->actor);
+    if (actor == NULL) return false;
+
+    // Undo left everything as it was, so the same action has the same outcome
+    switch ((CommandType)command->type) {
+        case COMMAND_MOVE:
+            map_move_actor(map, actor, command->to);
+            actor_spend_move(actor);
+            break;
+        case COMMAND_ATTACK:
+            combat_execute_at_cells(map, command->from, command->to);
+            break;
+        case COMMAND_WAIT:
+            actor_end_turn(actor);
+            break;
+    }
+    log->count++;
+    if (log->recorder != NULL) replay_record_redo(log->recorder);
+    return true;
+}
+
+void command_log_seal(CommandLog *log) {
+    log->floor = log->count;
+    log->end = log->count;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Appends at the current position; anything that could have been redone
+// is dropped
+static void record(CommandLog *log, const Command *command) {
+    log->ring[log->count % COMMAND_LOG_SIZE] = *command;
+    log->count++;
+    log->end = log->count;
+    if (log->recorder != NULL) replay_record_command(log->recorder, command);
+}
+
+static uint8_t pack_flags(const Actor *actor) {
+    return (uint8_t)((actor->can_move ? COMMAND_CAN_MOVE : 0u) | (actor->can_act ? COMMAND_CAN_ACT : 0u) |
+                     (actor->level_up_pending ? COMMAND_LEVEL_UP_PENDING : 0u));
+}
+
+static void restore_flags(Actor *actor, uint8_t flags) {
+    actor_set_turn_flags(actor, (flags & COMMAND_CAN_MOVE) != 0, (flags & COMMAND_CAN_ACT) != 0);
+    actor->level_up_pending = (flags & COMMAND_LEVEL_UP_PENDING) != 0;
+}
@@ -0,0 +1,69 @@
+#ifndef COMMAND_LOG_H_
+#define COMMAND_LOG_H_
+
+#include "types.h"
+#include "game/map.h"
+#include "game/combat.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Every unit action of a match goes through here as a small command that
+// keeps just what is needed to take it back: where the unit came from, its
+// turn flags and, for attacks, the target's hit points and the attacker's
+// experience before. Commands sit in a ring; recording one after an undo
+// drops whatever could still have been redone. Undo restores the deltas
+// and redo plays the command again (combat has no random rolls), both in
+// constant time and through the map and actor APIs, so caches and the
+// state hash follow along.
+#define COMMAND_LOG_SIZE 4096
+
+typedef enum {
+    COMMAND_MOVE,    // actor walks from -> to, spending its move
+    COMMAND_ATTACK,  // actor at `from` strikes target at `to`, spending its action
+    COMMAND_WAIT     // actor gives up what it had left this turn
+} CommandType;
+
+// Turn flags and experience state, packed
+#define COMMAND_CAN_MOVE 1u
+#define COMMAND_CAN_ACT 2u
+#define COMMAND_LEVEL_UP_PENDING 4u
+
+typedef struct Command {
+    uint8_t type;          // CommandType
+    uint8_t flags;         // the actor's COMMAND_* bits before
+    uint16_t actor;        // map handle of the acting unit
+    uint16_t target;       // map handle of the struck unit, 0 unless attacking
+    int32_t from;          // cell the actor acted from
+    int32_t to;            // cell it moved to, or the target's cell
+    int32_t target_health; // target's hit points before the blow
+    int32_t next_level_xp; // actor's experience to go before the blow
+} Command;
+
+struct ReplayWriter;
+
+typedef struct CommandLog {
+    Command *ring;
+    uint64_t count;  // commands in effect; the next undo takes command count - 1
+    uint64_t end;    // commands recorded; count..end - 1 can be redone
+    uint64_t floor;  // undo stops here: the turn's first command
+    struct ReplayWriter *recorder; // also writes every action, undo and redo here when set
+} CommandLog;
+
+CommandLog *command_log_create(void);
+void command_log_free(CommandLog *log);
+
+// Perform an action and record it; a NULL log only performs it
+bool command_log_move(CommandLog *log, Map *map, Actor *actor, int dest_cell);
+CombatResult command_log_attack(CommandLog *log, Map *map, int attacker_cell, int defender_cell);
+void command_log_wait(CommandLog *log, Actor *actor);
+
+// Take back or replay one command; false when there is none to take
+bool command_log_undo(CommandLog *log, Map *map);
+bool command_log_redo(CommandLog *log, Map *map);
+bool command_log_can_undo(const CommandLog *log);
+bool command_log_can_redo(const CommandLog *log);
+
+// Makes everything recorded so far final, e.g. when the turn passes on
+void command_log_seal(CommandLog *log);
+
+#endif
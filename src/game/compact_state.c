@@ -0,0 +1,343 @@
+#include "game/compact_state.h"
+#include "game/map.h"
+#include "game/actor.h"
+#include "game/command_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Forward declarations for internal helper functions
+static int capture_structure(CompactState *out, Map *map, int handle);
+static void remove_unit(CompactState *state, int unit);
+static int enter_cost(const CompactState *state, int cell);
+
+// ============================================================================
+// Capture and Clone
+// ============================================================================
+
+bool compact_state_capture(CompactState *out, GameState *state, Map *map) {
+    if (map->width > COMPACT_MAX_WIDTH || map->height > COMPACT_MAX_HEIGHT) {
+        fprintf(stderr, "Error: Map of %dx%d is too large for a compact state\n",
+                map->width, map->height);
+        return false;
+    }
+    if (state->num_factions > MAX_FACTIONS) {
+        fprintf(stderr, "Error: Too many factions for a compact state\n");
+        return false;
+    }
+
+    out->width = (uint8_t)map->width;
+    out->height = (uint8_t)map->height;
+    out->cell_count = (uint16_t)(map->width * map->height);
+    out->unit_count = 0;
+    out->structure_count = 0;
+    out->faction_count = (uint8_t)state->num_factions;
+    out->current_faction = (uint8_t)state->current_faction_index;
+    out->turn_number = state->turn_number;
+
+    for (int t = 0; t < TERRAIN_COUNT; t++) {
+        int cost = map->terrains[t].move_cost;
+        if (cost < 1) cost = 1;
+        if (cost > UINT8_MAX) cost = UINT8_MAX;
+        out->move_cost[t] = map->terrains[t].passable ? (uint8_t)cost : 0;
+    }
+
+    for (int y = 0; y < map->height; y++) {
+        for (int x = 0; x < map->width; x++) {
+            int cell = map_get_cell(map, x, y);
+            CompactCell *c = &out->cells[y * map->width + x];
+            c->terrain = map->terrain[cell];
+            c->occupant = 0;
+            c->structure = 0;
+            c->reserved = 0;
+            if (map->structure[cell] != 0) {
+                int index = capture_structure(out, map, map->structure[cell]);
+                if (index < 0) return false;
+                c->structure = (uint8_t)(index + 1);
+            }
+        }
+    }
+
+    // Living units on the map, faction by faction
+    for (int f = 0; f < state->num_factions; f++) {
+        Faction *faction = &state->factions[f];
+        for (int i = 0; i < faction->actor_count; i++) {
+            Actor *actor = &faction->actors[i];
+            if (!actor_is_alive(actor) || actor->cell == MAP_NO_CELL) continue;
+            if (out->unit_count == COMPACT_MAX_UNITS) {
+                fprintf(stderr, "Error: More than %d units for a compact state\n", COMPACT_MAX_UNITS);
+                return false;
+            }
+
+            int cell = compact_state_cell(out, map_cell_x(map, actor->cell), map_cell_y(map, actor->cell));
+            int index = out->unit_count++;
+            CompactUnit *unit = &out->units[index];
+            unit->cell = (int16_t)cell;
+            unit->faction = (uint8_t)f;
+            unit->flags = (actor->can_move ? COMPACT_CAN_MOVE : 0) | (actor->can_act ? COMPACT_CAN_ACT : 0);
+            unit->health = (int16_t)actor->curr_health;
+            unit->max_health = (int16_t)actor->max_health;
+            unit->phys_attack = (int16_t)actor->phys_attack;
+            unit->movement = (uint8_t)actor->movement;
+            unit->attack_range = (uint8_t)actor->attack_range;
+            unit->actor = (uint16_t)i;
+            out->cells[cell].occupant = (uint8_t)(index + 1);
+        }
+    }
+    return true;
+}
+
+size_t compact_state_size(const CompactState *state) {
+    return offsetof(CompactState, cells) + sizeof(CompactCell) * state->cell_count;
+}
+
+void compact_state_clone(CompactState *dst, const CompactState *src) {
+    memcpy(dst, src, compact_state_size(src));
+}
+
+// ============================================================================
+// Cell Helpers
+// ============================================================================
+
+int compact_state_cell(const CompactState *state, int x, int y) {
+    if (x < 0 || y < 0 || x >= state->width || y >= state->height) return COMPACT_NO_CELL;
+    return y * state->width + x;
+}
+
+int compact_state_distance(const CompactState *state, int cell_a, int cell_b) {
+    int dx = abs(cell_a % state->width - cell_b % state->width);
+    int dy = abs(cell_a / state->width - cell_b / state->width);
+    return dx + dy;
+}
+
+bool compact_state_can_enter(const CompactState *state, int cell) {
+    const CompactCell *c = &state->cells[cell];
+    if (c->occupant != 0 || state->move_cost[c->terrain] == 0) return false;
+    return c->structure == 0 || state->structures[c->structure - 1].passable;
+}
+
+// Every step costs at least one point, as on the map
+int compact_state_move_cost(const CompactState *state, int cell) {
+    int cost = state->move_cost[state->cells[cell].terrain];
+    return (cost > 0) ? cost : 1;
+}
+
+// ============================================================================
+// Rules
+// ============================================================================
+
+void compact_state_move(CompactState *state, int unit, int cell) {
+    CompactUnit *u = &state->units[unit];
+    state->cells[u->cell].occupant = 0;
+    state->cells[cell].occupant = (uint8_t)(unit + 1);
+    u->cell = (int16_t)cell;
+    u->flags &= (uint8_t)~COMPACT_CAN_MOVE;
+}
+
+// Battle skills hit for the attacker's physical attack and draw no counter
+void compact_state_attack(CompactState *state, int attacker, int defender) {
+    CompactUnit *target = &state->units[defender];
+    target->health -= state->units[attacker].phys_attack;
+    if (target->health <= 0) {
+        target->health = 0;
+        remove_unit(state, defender);
+    }
+    state->units[attacker].flags &= (uint8_t)~COMPACT_CAN_ACT;
+}
+
+// Ends the current faction's turn and readies the next one's units
+void compact_state_end_turn(CompactState *state) {
+    for (int i = 0; i < state->unit_count; i++) {
+        if (state->units[i].faction == state->current_faction) {
+            state->units[i].flags = 0;
+        }
+    }
+
+    state->current_faction++;
+    if (state->current_faction >= state->faction_count) {
+        state->current_faction = 0;
+        state->turn_number++;
+    }
+
+    for (int i = 0; i < state->unit_count; i++) {
+        CompactUnit *u = &state->units[i];
+        if (u->faction == state->current_faction && u->cell != COMPACT_NO_CELL) {
+            u->flags = COMPACT_CAN_MOVE | COMPACT_CAN_ACT;
+        }
+    }
+}
+
+int compact_state_factions_alive(const CompactState *state) {
+    bool alive[MAX_FACTIONS] = {false};
+    int count = 0;
+    for (int i = 0; i < state->unit_count; i++) {
+        const CompactUnit *u = &state->units[i];
+        if (u->cell != COMPACT_NO_CELL && !alive[u->faction]) {
+            alive[u->faction] = true;
+            count++;
+        }
+    }
+    return count;
+}
+
+int compact_state_winner(const CompactState *state) {
+    int winner = -1;
+    for (int i = 0; i < state->unit_count; i++) {
+        const CompactUnit *u = &state->units[i];
+        if (u->cell == COMPACT_NO_CELL) continue;
+        if (winner != -1 && winner != u->faction) return -1;
+        winner = u->faction;
+    }
+    return winner;
+}
+
+// ============================================================================
+// Decisions
+// ============================================================================
+
+// Steps cost at least one point, so a FIFO label-correcting search settles
+// quickly
+void compact_state_reach(const CompactState *state, int unit, CompactReach *reach) {
+    const CompactUnit *u = &state->units[unit];
+    reach->generation++;
+    if (reach->generation == 0) {
+        memset(reach->stamp, 0, sizeof(reach->stamp));
+        memset(reach->queued, 0, sizeof(reach->queued));
+        reach->generation = 1;
+    }
+    uint16_t generation = reach->generation;
+
+    int start = u->cell;
+    int movement = (u->flags & COMPACT_CAN_MOVE) ? u->movement : 0;
+    reach->count = 0;
+    reach->cells[reach->count++] = (int16_t)start;
+    reach->stamp[start] = generation;
+    reach->cost[start] = 0;
+
+    int head = 0;
+    int tail = 0;
+    int queued = 0;
+    reach->queue[tail++] = (int16_t)start;
+    reach->queued[start] = generation;
+    queued++;
+    while (queued > 0) {
+        int cell = reach->queue[head];
+        if (++head == COMPACT_MAX_CELLS) head = 0;
+        queued--;
+        reach->queued[cell] = 0;
+
+        int x = cell % state->width;
+        int neighbors[4] = {
+            (cell >= state->width) ? cell - state->width : -1,
+            (cell + state->width < state->cell_count) ? cell + state->width : -1,
+            (x > 0) ? cell - 1 : -1,
+            (x + 1 < state->width) ? cell + 1 : -1
+        };
+        for (int d = 0; d < 4; d++) {
+            int next = neighbors[d];
+            if (next < 0) continue;
+            int step = enter_cost(state, next);
+            if (step == 0) continue;
+
+            int cost = reach->cost[cell] + step;
+            if (cost > movement) continue;
+            if (reach->stamp[next] == generation) {
+                if (reach->cost[next] <= cost) continue;
+            } else {
+                reach->stamp[next] = generation;
+                reach->cells[reach->count++] = (int16_t)next;
+            }
+            reach->cost[next] = (uint8_t)cost;
+            if (reach->queued[next] != generation) {
+                reach->queued[next] = generation;
+                reach->queue[tail] = (int16_t)next;
+                if (++tail == COMPACT_MAX_CELLS) tail = 0;
+                queued++;
+            }
+        }
+    }
+}
+
+int compact_state_next_unit(const CompactState *state) {
+    for (int i = 0; i < state->unit_count; i++) {
+        const CompactUnit *u = &state->units[i];
+        if (u->faction == state->current_faction && u->cell != COMPACT_NO_CELL && u->flags != 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void compact_state_apply(CompactState *state, const CompactAction *action) {
+    CompactUnit *unit = &state->units[action->unit];
+    if (action->dest != unit->cell && (unit->flags & COMPACT_CAN_MOVE)) {
+        compact_state_move(state, action->unit, action->dest);
+    }
+    if (action->target >= 0 && (unit->flags & COMPACT_CAN_ACT)) {
+        compact_state_attack(state, action->unit, action->target);
+    }
+    unit->flags = 0;
+
+    for (int k = 0; k < state->faction_count && compact_state_next_unit(state) == -1; k++) {
+        if (compact_state_factions_alive(state) <= 1) break;
+        compact_state_end_turn(state);
+    }
+}
+
+// The unit is done for the turn afterwards, whether or not it struck
+void compact_state_commit(GameState *state, Map *map, const CompactState *compact,
+                          const CompactAction *action) {
+    const CompactUnit *unit = &compact->units[action->unit];
+    Actor *actor = &state->factions[unit->faction].actors[unit->actor];
+
+    if (action->dest != unit->cell && actor->can_move) {
+        int cell = map_get_cell(map, action->dest % compact->width, action->dest / compact->width);
+        command_log_move(state->commands, map, actor, cell);
+    }
+    if (action->target >= 0 && actor->can_act) {
+        const CompactUnit *target = &compact->units[action->target];
+        Actor *defender = &state->factions[target->faction].actors[target->actor];
+        command_log_attack(state->commands, map, actor->cell, defender->cell);
+    }
+    if (actor_can_perform_action(actor)) {
+        command_log_wait(state->commands, actor);
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Index of the map structure `handle` in the compact table, added on first
+// sight. -1 when the table is full.
+static int capture_structure(CompactState *out, Map *map, int handle) {
+    for (int i = 0; i < out->structure_count; i++) {
+        if (out->structures[i].handle == handle) return i;
+    }
+    if (out->structure_count == COMPACT_MAX_STRUCTURES) {
+        fprintf(stderr, "Error: More than %d structures for a compact state\n", COMPACT_MAX_STRUCTURES);
+        return -1;
+    }
+
+    int index = out->structure_count++;
+    out->structures[index].passable = map->structures[handle - 1]->passable;
+    out->structures[index].handle = (uint16_t)handle;
+    return index;
+}
+
+static void remove_unit(CompactState *state, int unit) {
+    CompactUnit *u = &state->units[unit];
+    if (u->cell == COMPACT_NO_CELL) return;
+    state->cells[u->cell].occupant = 0;
+    u->cell = COMPACT_NO_CELL;
+    u->flags = 0;
+}
+
+// compact_state_can_enter and compact_state_move_cost in one: the cost of
+// stepping onto `cell`, 0 where it is blocked
+static int enter_cost(const CompactState *state, int cell) {
+    const CompactCell *c = &state->cells[cell];
+    if (c->occupant != 0) return 0;
+    if (c->structure != 0 && !state->structures[c->structure - 1].passable) return 0;
+    return state->move_cost[c->terrain];
+}
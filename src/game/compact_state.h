@@ -0,0 +1,134 @@
+#ifndef COMPACT_STATE_H_
+#define COMPACT_STATE_H_
+
+#include "types.h"
+#include "game/game_logic.h"
+#include "game/terrain.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Capacities of a compact state; larger matches cannot be captured
+#define COMPACT_MAX_WIDTH 64
+#define COMPACT_MAX_HEIGHT 64
+#define COMPACT_MAX_CELLS (COMPACT_MAX_WIDTH * COMPACT_MAX_HEIGHT)
+#define COMPACT_MAX_UNITS 64
+#define COMPACT_MAX_STRUCTURES 16
+
+#define COMPACT_NO_CELL -1
+
+// Enemies further than this, as the crow flies, cannot meet the unit this
+// turn or the next
+#define COMPACT_CONTACT_DISTANCE(unit) (2 * (unit)->movement + (unit)->attack_range)
+
+// Unit flags
+#define COMPACT_CAN_MOVE 0x01
+#define COMPACT_CAN_ACT 0x02
+
+// What search needs of an actor. Units are addressed by index; a cell's
+// occupant is the unit index + 1.
+typedef struct CompactUnit {
+    int16_t cell;           // row-major cell, COMPACT_NO_CELL once dead
+    uint8_t faction;        // index into the match's faction array
+    uint8_t flags;          // COMPACT_CAN_MOVE | COMPACT_CAN_ACT
+    int16_t health;
+    int16_t max_health;
+    int16_t phys_attack;
+    uint8_t movement;
+    uint8_t attack_range;
+    uint16_t actor;         // index of the source actor in its faction's array
+} CompactUnit;
+
+typedef struct CompactCell {
+    uint8_t terrain;        // TerrainType
+    uint8_t occupant;       // unit index + 1, 0 when empty
+    uint8_t structure;      // structure index + 1, 0 when none
+    uint8_t reserved;
+} CompactCell;
+
+typedef struct CompactStructure {
+    bool passable;
+    uint16_t handle;        // map structure handle it came from
+} CompactStructure;
+
+// A match snapshot without pointers: units, structures and factions are
+// referred to by index, and everything lives in fixed-capacity arrays, so
+// a copy of the bytes is a complete, independent state. Cells are row-major
+// (y * width + x) and come last, so a clone copies only the cells in use.
+typedef struct CompactState {
+    uint8_t width;
+    uint8_t height;
+    uint16_t cell_count;        // width * height
+    uint8_t unit_count;
+    uint8_t structure_count;
+    uint8_t faction_count;
+    uint8_t current_faction;
+    int32_t turn_number;
+    uint8_t move_cost[TERRAIN_COUNT];   // per terrain, 0 where impassable
+    CompactStructure structures[COMPACT_MAX_STRUCTURES];
+    CompactUnit units[COMPACT_MAX_UNITS];
+    CompactCell cells[COMPACT_MAX_CELLS];
+} CompactState;
+
+// One unit's decision: where to stand, then whom to strike (-1 for nobody)
+typedef struct CompactAction {
+    int16_t unit;
+    int16_t dest;       // compact cell; the unit's own cell to stay put
+    int16_t target;     // unit index, or -1
+} CompactAction;
+
+// Scratch for movement ranges. Stamps are generation-counted, so a reach
+// needs no clearing between calls; zero it once before the first.
+typedef struct CompactReach {
+    uint16_t generation;
+    uint16_t stamp[COMPACT_MAX_CELLS];
+    uint16_t queued[COMPACT_MAX_CELLS];
+    uint8_t cost[COMPACT_MAX_CELLS];
+    int16_t queue[COMPACT_MAX_CELLS];
+    int16_t cells[COMPACT_MAX_CELLS];  // reachable cells, the unit's own first
+    int count;
+} CompactReach;
+
+// Snapshots the living units on the map, the terrain and the structures.
+// Returns false (leaving `out` undefined) if the match exceeds a capacity.
+bool compact_state_capture(CompactState *out, GameState *state, Map *map);
+
+// Bytes a clone copies: everything up to and including the cells in use
+size_t compact_state_size(const CompactState *state);
+
+// Copies `src` into `dst` with a single memcpy. `dst` may be any buffer of
+// sizeof(CompactState) bytes; nothing needs fixing up afterwards.
+void compact_state_clone(CompactState *dst, const CompactState *src);
+
+// Cell helpers
+int compact_state_cell(const CompactState *state, int x, int y);
+int compact_state_distance(const CompactState *state, int cell_a, int cell_b);
+bool compact_state_can_enter(const CompactState *state, int cell);
+int compact_state_move_cost(const CompactState *state, int cell);
+
+// Rules, as game_logic.c and combat.c apply them
+void compact_state_move(CompactState *state, int unit, int cell);
+void compact_state_attack(CompactState *state, int attacker, int defender);
+void compact_state_end_turn(CompactState *state);
+
+// Factions with living units; the winner is the last one standing, or -1
+int compact_state_factions_alive(const CompactState *state);
+int compact_state_winner(const CompactState *state);
+
+// Cells `unit` can end its move on this turn, in reach->cells
+void compact_state_reach(const CompactState *state, int unit, CompactReach *reach);
+
+// Next unit of the current faction that can still act, or -1
+int compact_state_next_unit(const CompactState *state);
+
+// Applies one decision; the unit is done for the turn afterwards. Factions
+// left without a unit to act hand the turn on at once, until the match is
+// decided.
+void compact_state_apply(CompactState *state, const CompactAction *action);
+
+// Carries a decision made on the compact copy of the match over to the
+// actors and the map
+void compact_state_commit(GameState *state, Map *map, const CompactState *compact,
+                          const CompactAction *action);
+
+#endif
@@ -0,0 +1,396 @@
+#include "game/flow_field.h"
+#include "game/map.h"
+#include "core/profiler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Initial bucket queue sizes; both grow on demand
+#define FLOW_BUCKETS_INITIAL 256
+#define FLOW_ENTRIES_INITIAL 1024
+
+// Per-cell state bits; the terrain type sits above them
+#define FLOW_STATE_PASSABLE 1
+#define FLOW_STATE_TARGET 2
+#define FLOW_STATE_TERRAIN_SHIFT 2
+
+// Up, down, left, right (same order as the range searches)
+static const int NEIGHBOR_DX[4] = {0, 0, -1, 1};
+static const int NEIGHBOR_DY[4] = {-1, 1, 0, 0};
+
+// Forward declarations for internal helper functions
+static uint16_t cell_state(const FlowField *field, Map *map, int cell);
+static int step_cost(Map *map, const FlowField *field, int cell);
+static int neighbor(Map *map, int cell, int d);
+static int invalidate_subtree(FlowField *field, Map *map, int root, int count);
+static void seed_cell(FlowField *field, Map *map, int cell);
+static void propagate(FlowField *field, Map *map);
+static void clear_queue(FlowField *field);
+static bool push_entry(FlowField *field, int cell, int dist);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+FlowField *flow_field_create(int cell_count, int faction_id, bool include_structures) {
+    FlowField *field = malloc(sizeof(FlowField));
+    if (field == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for flow field\n");
+        return NULL;
+    }
+
+    field->cell_count = cell_count;
+    field->faction_id = faction_id;
+    field->include_structures = include_structures;
+    field->built = false;
+    field->synced = 0;
+    field->bucket_capacity = FLOW_BUCKETS_INITIAL;
+    field->bucket_max = -1;
+    field->entry_count = 0;
+    field->entry_capacity = (cell_count > FLOW_ENTRIES_INITIAL) ? cell_count : FLOW_ENTRIES_INITIAL;
+    field->last_rebuilt = false;
+    field->last_changed = 0;
+    field->last_settled = 0;
+
+    field->dist = malloc(sizeof(int) * cell_count);
+    field->parent = malloc(sizeof(int) * cell_count);
+    field->state = malloc(sizeof(uint16_t) * cell_count);
+    // Changed cells, then the cells whose distances they invalidated
+    field->stack = malloc(sizeof(int) * (cell_count + cell_count / FLOW_REBUILD_FRACTION + 1));
+    field->bucket_head = malloc(sizeof(int) * field->bucket_capacity);
+    field->entry_cell = malloc(sizeof(int) * field->entry_capacity);
+    field->entry_next = malloc(sizeof(int) * field->entry_capacity);
+
+    if (field->dist == NULL || field->parent == NULL || field->state == NULL ||
+        field->stack == NULL || field->bucket_head == NULL ||
+        field->entry_cell == NULL || field->entry_next == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for flow field buffers\n");
+        flow_field_free(field);
+        return NULL;
+    }
+    for (int c = 0; c < field->bucket_capacity; c++) {
+        field->bucket_head[c] = -1;
+    }
+
+    return field;
+}
+
+void flow_field_free(FlowField *field) {
+    if (field == NULL) return;
+    free(field->dist);
+    free(field->parent);
+    free(field->state);
+    free(field->stack);
+    free(field->bucket_head);
+    free(field->entry_cell);
+    free(field->entry_next);
+    free(field);
+}
+
+FlowField *flow_field_for_faction(Map *map, int faction_id) {
+    if (faction_id < 0 || faction_id >= MAX_FACTIONS) return NULL;
+    if (map->flow[faction_id] == NULL) {
+        map->flow[faction_id] = flow_field_create(map->cell_count, faction_id, false);
+        if (map->flow[faction_id] == NULL) return NULL;
+    }
+    flow_field_update(map->flow[faction_id], map);
+    return map->flow[faction_id];
+}
+
+// ============================================================================
+// Updates
+// ============================================================================
+
+void flow_field_rebuild(FlowField *field, Map *map) {
+    PROFILE_BEGIN("flow_field_rebuild");
+    clear_queue(field);
+    field->last_settled = 0;
+    field->built = true; // until the queue runs out of memory
+
+    // Every target starts the search at zero; padding slots stay blocked
+    for (int cell = 0; cell < field->cell_count; cell++) {
+        uint16_t state = map_is_valid_cell(map, cell) ? cell_state(field, map, cell) : 0;
+        field->state[cell] = state;
+        field->parent[cell] = -1;
+        if (state & FLOW_STATE_TARGET) {
+            field->dist[cell] = 0;
+            if (!push_entry(field, cell, 0)) field->built = false;
+        } else {
+            field->dist[cell] = FLOW_UNREACHABLE;
+        }
+    }
+    propagate(field, map);
+
+    field->synced = map_change_count(map);
+    field->last_rebuilt = true;
+    field->last_changed = field->cell_count;
+    PROFILE_END();
+}
+
+void flow_field_update(FlowField *field, Map *map) {
+    uint64_t now = map_change_count(map);
+    if (!field->built || now - field->synced > MAP_CHANGE_LOG_SIZE) {
+        flow_field_rebuild(field, map);
+        return;
+    }
+    field->last_rebuilt = false;
+    field->last_changed = 0;
+    field->last_settled = 0;
+    if (now == field->synced) return;
+
+    PROFILE_BEGIN("flow_field_update");
+
+    // Cells journaled more than once, or changed in ways this field ignores
+    // (the faction's own units), keep their state and drop out here
+    int max_changes = field->cell_count / FLOW_REBUILD_FRACTION;
+    int changed = 0;
+    for (uint64_t i = field->synced; i < now; i++) {
+        int cell = map_get_change(map, i);
+        uint16_t state = cell_state(field, map, cell);
+        if (state == field->state[cell]) continue;
+        field->state[cell] = state;
+        field->stack[changed++] = cell;
+        if (changed > max_changes) {
+            PROFILE_END();
+            flow_field_rebuild(field, map);
+            return;
+        }
+    }
+    field->last_changed = changed;
+
+    // Distances that ran through a changed cell may only have grown: forget
+    // them, then let each forgotten cell take the best of its neighbours'
+    // distances that still hold. Distances that shrank (a new target, a cell
+    // opening up) spread from the changed cells through plain relaxation.
+    // The forgotten cells go after the changed ones; each is listed once
+    int count = changed;
+    for (int i = 0; i < changed; i++) {
+        count = invalidate_subtree(field, map, field->stack[i], count);
+    }
+
+    for (int i = 0; i < count; i++) {
+        seed_cell(field, map, field->stack[i]);
+    }
+    propagate(field, map);
+
+    field->synced = now;
+    PROFILE_COUNTER("flow_cells_settled", field->last_settled);
+    PROFILE_END();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+int flow_field_distance(const FlowField *field, int cell) {
+    if (cell < 0 || cell >= field->cell_count) return FLOW_UNREACHABLE;
+    return field->dist[cell];
+}
+
+int flow_field_descend(const FlowField *field, Map *map, int start, int movement) {
+    int current = start;
+    int budget = movement;
+
+    while (field->dist[current] > 0 && field->dist[current] != FLOW_UNREACHABLE) {
+        int x = map_cell_x(map, current);
+        int y = map_cell_y(map, current);
+
+        // The neighbour on the cheapest way on, among those that get closer
+        int best = MAP_NO_CELL;
+        int best_total = FLOW_UNREACHABLE;
+        int best_cost = 0;
+        for (int d = 0; d < 4; d++) {
+            int next = map_get_cell(map, x + NEIGHBOR_DX[d], y + NEIGHBOR_DY[d]);
+            if (next == MAP_NO_CELL) continue;
+            if (field->dist[next] >= field->dist[current]) continue;
+            if (!map_can_unit_enter_cell(map, next, NULL)) continue;
+            int cost = map_get_move_cost(map, next);
+            if (cost > budget) continue;
+            if (field->dist[next] + cost < best_total) {
+                best = next;
+                best_total = field->dist[next] + cost;
+                best_cost = cost;
+            }
+        }
+        if (best == MAP_NO_CELL) break;
+
+        budget -= best_cost;
+        current = best;
+    }
+
+    return (current == start) ? MAP_NO_CELL : current;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// What the distances depend on: terrain (for its cost), whether the cell can
+// be walked through, and whether it is a target. Units of the field's own
+// faction count as empty ground.
+static uint16_t cell_state(const FlowField *field, Map *map, int cell) {
+    uint16_t state = (uint16_t)(map->terrain[cell] << FLOW_STATE_TERRAIN_SHIFT);
+    if (bitboard_test(map->passable_layer, map_cell_x(map, cell), map_cell_y(map, cell))) {
+        state |= FLOW_STATE_PASSABLE;
+    }
+
+    Actor *occupant = map_get_occupant(map, cell);
+    if (occupant != NULL && occupant->owner != NULL && occupant->owner->id != field->faction_id) {
+        state |= FLOW_STATE_TARGET;
+    }
+    if (field->include_structures && map->structure[cell] != 0) {
+        state |= FLOW_STATE_TARGET;
+    }
+    return state;
+}
+
+// Cost of the step into `cell` on the way to a target: its move cost, or
+// nothing when it is a target, since a unit stops next to it
+static int step_cost(Map *map, const FlowField *field, int cell) {
+    if (field->state[cell] & FLOW_STATE_TARGET) return 0;
+    return map_get_move_cost(map, cell);
+}
+
+// Forgets the distances of `root` and of every cell whose distance came
+// through it, appending them to the stack from `count` on. Returns the new
+// stack size. Forgotten cells look unreachable, so a root forgotten as part
+// of an earlier subtree adds nothing.
+static int invalidate_subtree(FlowField *field, Map *map, int root, int count) {
+    if (field->dist[root] == FLOW_UNREACHABLE && field->parent[root] == -1) return count;
+    int first = count;
+    field->dist[root] = FLOW_UNREACHABLE;
+    field->parent[root] = -1;
+    field->stack[count++] = root;
+
+    for (int i = first; i < count; i++) {
+        int cell = field->stack[i];
+        for (int d = 0; d < 4; d++) {
+            int child = neighbor(map, cell, d);
+            if (child == MAP_NO_CELL || field->parent[child] != cell) continue;
+            field->dist[child] = FLOW_UNREACHABLE;
+            field->parent[child] = -1;
+            field->stack[count++] = child;
+        }
+    }
+    return count;
+}
+
+// Gives a forgotten cell its best distance from neighbours that kept theirs
+// and queues it for propagation
+static void seed_cell(FlowField *field, Map *map, int cell) {
+    uint16_t state = field->state[cell];
+    if (state & FLOW_STATE_TARGET) {
+        field->dist[cell] = 0;
+        field->parent[cell] = -1;
+        if (!push_entry(field, cell, 0)) field->built = false;
+        return;
+    }
+    if (!(state & FLOW_STATE_PASSABLE)) {
+        field->dist[cell] = FLOW_UNREACHABLE;
+        field->parent[cell] = -1;
+        return;
+    }
+
+    for (int d = 0; d < 4; d++) {
+        int next = neighbor(map, cell, d);
+        if (next == MAP_NO_CELL || field->dist[next] == FLOW_UNREACHABLE) continue;
+        int dist = field->dist[next] + step_cost(map, field, next);
+        if (dist < field->dist[cell]) {
+            field->dist[cell] = dist;
+            field->parent[cell] = next;
+        }
+    }
+    if (field->dist[cell] != FLOW_UNREACHABLE && !push_entry(field, cell, field->dist[cell])) {
+        field->built = false; // out of memory: start over next update
+    }
+}
+
+// Dijkstra from the queued cells, lowest distance first. Distances only
+// ever drop here, so the cells settled are those whose distance changed.
+// Steps out of a target cost nothing, so a bucket can refill while it is
+// drained; entries are taken off its head until it stays empty.
+static void propagate(FlowField *field, Map *map) {
+    for (int c = 0; c <= field->bucket_max; c++) {
+        int e;
+        while ((e = field->bucket_head[c]) != -1) {
+            field->bucket_head[c] = field->entry_next[e];
+            int cell = field->entry_cell[e];
+            if (field->dist[cell] != c) continue; // stale
+            field->last_settled++;
+
+            int dist = c + step_cost(map, field, cell);
+            for (int d = 0; d < 4; d++) {
+                int next = neighbor(map, cell, d);
+                if (next == MAP_NO_CELL) continue;
+                if (!(field->state[next] & FLOW_STATE_PASSABLE)) continue;
+                if (field->dist[next] <= dist) continue;
+
+                field->dist[next] = dist;
+                field->parent[next] = cell;
+                if (!push_entry(field, next, dist)) {
+                    clear_queue(field);
+                    field->built = false; // out of memory: start over next update
+                    return;
+                }
+            }
+        }
+    }
+    field->bucket_max = -1;
+    field->entry_count = 0;
+}
+
+// Neighbour `d` of a cell; steps within the chunk skip the coordinate round
+// trip. Padding slots come back as cells, but their state keeps them blocked.
+static int neighbor(Map *map, int cell, int d) {
+    int lx = (cell & (MAP_CHUNK_SIZE - 1)) + NEIGHBOR_DX[d];
+    int ly = ((cell >> MAP_CHUNK_SHIFT) & (MAP_CHUNK_SIZE - 1)) + NEIGHBOR_DY[d];
+    if (lx >= 0 && lx < MAP_CHUNK_SIZE && ly >= 0 && ly < MAP_CHUNK_SIZE) {
+        return cell + NEIGHBOR_DY[d] * MAP_CHUNK_SIZE + NEIGHBOR_DX[d];
+    }
+    return map_get_cell(map, map_cell_x(map, cell) + NEIGHBOR_DX[d],
+                        map_cell_y(map, cell) + NEIGHBOR_DY[d]);
+}
+
+static void clear_queue(FlowField *field) {
+    for (int c = 0; c <= field->bucket_max; c++) {
+        field->bucket_head[c] = -1;
+    }
+    field->bucket_max = -1;
+    field->entry_count = 0;
+}
+
+static bool push_entry(FlowField *field, int cell, int dist) {
+    if (dist >= field->bucket_capacity) {
+        int new_capacity = field->bucket_capacity * 2;
+        while (new_capacity <= dist) new_capacity *= 2;
+        int *buckets = realloc(field->bucket_head, sizeof(int) * new_capacity);
+        if (buckets == NULL) {
+            fprintf(stderr, "Error: Failed to grow flow field buckets\n");
+            return false;
+        }
+        for (int c = field->bucket_capacity; c < new_capacity; c++) {
+            buckets[c] = -1;
+        }
+        field->bucket_head = buckets;
+        field->bucket_capacity = new_capacity;
+    }
+    if (field->entry_count == field->entry_capacity) {
+        int new_capacity = field->entry_capacity * 2;
+        int *cells = realloc(field->entry_cell, sizeof(int) * new_capacity);
+        if (cells != NULL) field->entry_cell = cells;
+        int *next = realloc(field->entry_next, sizeof(int) * new_capacity);
+        if (next != NULL) field->entry_next = next;
+        if (cells == NULL || next == NULL) {
+            fprintf(stderr, "Error: Failed to grow flow field queue\n");
+            return false;
+        }
+        field->entry_capacity = new_capacity;
+    }
+
+    int e = field->entry_count++;
+    field->entry_cell[e] = cell;
+    field->entry_next[e] = field->bucket_head[dist];
+    field->bucket_head[dist] = e;
+    if (dist > field->bucket_max) field->bucket_max = dist;
+    return true;
+}
@@ -0,0 +1,70 @@
+#ifndef FLOW_FIELD_H_
+#define FLOW_FIELD_H_
+
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Distance for cells no target can be reached from
+#define FLOW_UNREACHABLE INT32_MAX
+
+// Rebuild from scratch when more than 1/FLOW_REBUILD_FRACTION of the cells
+// changed since the last update
+#define FLOW_REBUILD_FRACTION 8
+
+// Per-faction distance field: for every cell, the movement cost a unit of
+// the faction pays to get next to an enemy unit (or an objective). One
+// multi-source Dijkstra serves every unit, which then walks downhill in
+// O(path length). The faction's own units neither block the field nor feed
+// it, so their moves never invalidate it; only enemy moves and structure
+// changes do, and those are repaired in place from the map's change journal.
+typedef struct FlowField {
+    int cell_count;
+    int faction_id;
+    bool include_structures;    // structures are targets too (e.g. Warg Lairs)
+
+    int *dist;                  // cost to reach a target, FLOW_UNREACHABLE if none
+    int *parent;                // cell the distance came through, -1 for targets
+    uint16_t *state;            // terrain, passability and target bit the distance assumed
+    bool built;
+    uint64_t synced;            // map change count the field reflects
+
+    // Bucket queue: one singly linked list of entries per distance. Both
+    // arrays grow on demand and are kept between updates.
+    int *bucket_head;
+    int bucket_capacity;
+    int bucket_max;             // highest distance queued
+    int *entry_cell;
+    int *entry_next;
+    int entry_count;
+    int entry_capacity;
+    int *stack;                 // changed and invalidated cells during a repair
+
+    // Last update, for benchmarks and traces
+    bool last_rebuilt;
+    int last_changed;           // journal cells whose state differed
+    int last_settled;           // cells popped from the open list
+} FlowField;
+
+// Lifecycle. cell_count is the map's slot count (map->cell_count).
+FlowField *flow_field_create(int cell_count, int faction_id, bool include_structures);
+void flow_field_free(FlowField *field);
+
+// Brings the field up to date with the map: repairs it around changed cells,
+// or rebuilds it when it was never built, the journal has moved on too far
+// or too many cells changed
+void flow_field_update(FlowField *field, Map *map);
+void flow_field_rebuild(FlowField *field, Map *map);
+
+// The map's field towards `faction_id`'s enemies, created on first use and
+// updated before it is returned. NULL if it cannot be allocated.
+FlowField *flow_field_for_faction(Map *map, int faction_id);
+
+int flow_field_distance(const FlowField *field, int cell);
+
+// Walks downhill from `start` while `movement` pays for the steps, through
+// cells a unit can enter right now, and stops next to a target. Returns the
+// last cell reached, or MAP_NO_CELL if not even one step was possible.
+int flow_field_descend(const FlowField *field, Map *map, int start, int movement);
+
+#endif
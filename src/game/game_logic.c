@@ -2,32 +2,78 @@
 #include "game/actor.h"
 #include "game/map.h"
 #include "game/combat.h"
+#include "game/spatial_index.h"
+#include "game/pathfinding.h"
+#include "game/flow_field.h"
+#include "game/influence_map.h"
+#include "game/reachability.h"
+#include "game/mcts.h"
+#include "game/alphabeta.h"
+#include "game/replay.h"
+#include "game/zobrist.h"
+#include "core/rng.h"
+#include "core/log.h"
+#include "core/profiler.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+
+// A* limits for AI moves. A query may expand AI_PATH_EXPANSIONS_PER_CELL
+// cells per cell of distance to the target, up to AI_PATH_MAX_EXPANSIONS, so
+// targets walled in by other units cost little more than reachable ones.
+// Paths keep AI_PATH_MAX_CELLS cells, enough for any movement since every
+// step costs at least one point.
+#define AI_PATH_EXPANSIONS_PER_CELL 32
+#define AI_PATH_MAX_EXPANSIONS 1024
+#define AI_PATH_MAX_CELLS 64
+
+// Destination scores for AI moves into enemy reach: each point of distance
+// left to an enemy costs as much as AI_DISTANCE_WEIGHT points of damage the
+// enemy could deal there, and a cell where that damage could kill the unit
+// costs AI_LETHAL_PENALTY on top
+#define AI_DISTANCE_WEIGHT 8
+#define AI_LETHAL_PENALTY 64
+
+// Search AI defaults: thinking time per faction turn and workers
+#define AI_SEARCH_DEFAULT_BUDGET_MS 100
+#define AI_SEARCH_DEFAULT_THREADS 1
+
+// Forward declarations for internal helper functions
+static int ai_path_destination(Map *map, Actor *actor, int target_cell);
+static int ai_scored_destination(Map *map, const FlowField *field, const InfluenceMap *influence,
+                                 Actor *actor);
+static int ai_score_cell(const FlowField *field, const InfluenceMap *influence, Actor *actor, int cell);
+static int ai_exposure(const InfluenceMap *influence, Actor *actor, int cell);
 
 // ============================================================================
 // Game State Initialization
 // ============================================================================
 
-GameState *game_state_create(Faction *factions, int num_factions) {
+GameState *game_state_create(Faction *factions, int num_factions, uint64_t seed) {
     GameState *state = malloc(sizeof(GameState));
     if (state == NULL) {
         fprintf(stderr, "Error: Failed to allocate memory for game state\n");
         return NULL;
     }
     
-    game_state_init(state, factions, num_factions);
+    game_state_init(state, factions, num_factions, seed);
+    state->commands = command_log_create();
+    if (state->commands == NULL) {
+        free(state);
+        return NULL;
+    }
     return state;
 }
 
 void game_state_free(GameState *state) {
     if (state != NULL) {
+        command_log_free(state->commands);
         free(state);
     }
 }
 
-void game_state_init(GameState *state, Faction *factions, int num_factions) {
+void game_state_init(GameState *state, Faction *factions, int num_factions, uint64_t seed) {
     state->current_phase = PHASE_PLAYER_TURN;
     state->factions = factions;
     state->num_factions = num_factions;
@@ -36,6 +82,13 @@ void game_state_init(GameState *state, Faction *factions, int num_factions) {
     state->turn_number = 1;
     state->game_over = false;
     state->winner = NULL;
+    state->seed = seed;
+    for (int i = 0; i < MAX_FACTIONS; i++) {
+        state->ai_mode[i] = AI_MODE_GREEDY;
+    }
+    game_ai_search_defaults(&state->ai_search);
+    memset(&state->ai_stats, 0, sizeof(state->ai_stats));
+    state->commands = NULL;
     
     // Set first faction to have the turn
     if (num_factions > 0) {
@@ -45,11 +98,11 @@ void game_state_init(GameState *state, Faction *factions, int num_factions) {
         factions[0].has_turn = true;
     }
     
-    printf("\n=== GAME START ===\n");
+    log_info("\n=== GAME START ===\n");
     if (state->current_faction_index < num_factions) {
-        printf("Turn %d: %s's turn\n\n", state->turn_number, factions[state->current_faction_index].name);
+        log_info("Turn %d: %s's turn\n\n", state->turn_number, factions[state->current_faction_index].name);
     } else {
-        printf("Turn %d: (no playable faction)\n\n", state->turn_number);
+        log_info("Turn %d: (no playable faction)\n\n", state->turn_number);
     }
 }
 
@@ -58,12 +111,17 @@ void game_state_init(GameState *state, Faction *factions, int num_factions) {
 // ============================================================================
 
 void game_next_turn(GameState *state) {
+    // What the last faction did can no longer be taken back
+    if (state->commands != NULL) {
+        command_log_seal(state->commands);
+    }
+
     // Move to next faction in order
     state->current_faction_index++;
     if (state->current_faction_index >= state->num_factions) {
         state->current_faction_index = 0;
         state->turn_number++;
-        printf("\n=== TURN %d ===\n", state->turn_number);
+        log_info("\n=== TURN %d ===\n", state->turn_number);
     }
 
     // Update faction turn flags
@@ -72,7 +130,7 @@ void game_next_turn(GameState *state) {
     }
     
     Faction *current_faction = game_get_current_faction(state);
-    printf("\n--- %s's turn ---\n", current_faction->name);
+    log_info("\n--- %s's turn ---\n", current_faction->name);
     
     // Start the new faction's turn
     game_start_faction_turn(state);
@@ -84,16 +142,21 @@ void game_next_turn(GameState *state) {
         
         Faction *winner = game_get_winner(state);
         if (winner != NULL) {
-            printf("\n=== VICTORY ===\n");
-            printf("%s has won the game!\n", winner->name);
+            log_info("\n=== VICTORY ===\n");
+            log_info("%s has won the game!\n", winner->name);
             state->winner = winner;
         }
     }
+
+    // Replays check the match against this once the turn has passed
+    if (state->commands != NULL && state->commands->recorder != NULL) {
+        replay_record_turn(state->commands->recorder);
+    }
 }
 
 void game_end_current_turn(GameState *state) {
     Faction *current_faction = game_get_current_faction(state);
-    printf("Ending turn for %s\n", current_faction->name);
+    log_info("Ending turn for %s\n", current_faction->name);
     
     // End all units' turns for current faction
     game_end_all_unit_turns(current_faction);
@@ -121,45 +184,44 @@ void game_start_faction_turn(GameState *state) {
 // AI Processing
 // ============================================================================
 
-void game_process_ai_turn(GameState *state, Point *map, GridConfig *grid_config) {
+void game_process_ai_turn(GameState *state, Map *map) {
     Faction *current = game_get_current_faction(state);
     if (current == NULL) return;
 
-    int total_cells = grid_config->max_grid_cells_x * grid_config->max_grid_cells_y;
+    // The search AI only takes matches that fit a compact state; larger ones
+    // stay with the greedy logic below
+    if (state->ai_mode[current->id] == AI_MODE_MCTS && mcts_play_turn(state, map)) {
+        game_end_current_turn(state);
+        return;
+    }
+
+    // Alpha-beta settles the units already in contact with the enemy; the
+    // rest, done or not, carry on below
+    if (state->ai_mode[current->id] == AI_MODE_ALPHABETA) {
+        alphabeta_play_turn(state, map);
+    }
+
+    // One distance field towards every enemy serves all of this faction's
+    // units; it is repaired in place as enemies die during the turn
+    FlowField *field = flow_field_for_faction(map, current->id);
+    InfluenceMap *influence = influence_map_current(map);
 
+    int processed = 0;
     for (int i = 0; i < current->actor_count; i++) {
         Actor *actor = &current->actors[i];
         if (!actor_is_alive(actor)) continue;
         if (!actor_can_perform_action(actor)) continue;
 
-        // Locate actor's cell
-        Point *actor_cell = NULL;
-        for (int c = 0; c < total_cells; c++) {
-            if (map[c].occupant == actor) {
-                actor_cell = &map[c];
-                break;
-            }
-        }
-        if (actor_cell == NULL) continue;
+        int actor_cell = actor->cell;
+        if (actor_cell == MAP_NO_CELL) continue;
+        processed++;
 
         // Search for enemies in attack range; pick the closest
-        Point *best_target = NULL;
-        int best_dist = 999999;
-        for (int c = 0; c < total_cells; c++) {
-            if (map[c].occupant == NULL) continue;
-            Actor *other = map[c].occupant;
-            if (!actor_is_enemy(actor, other)) continue;
-            if (combat_is_in_range(grid_config, actor_cell, &map[c], actor->attack_range)) {
-                int d = combat_get_distance(actor_cell, &map[c]);
-                if (d < best_dist) {
-                    best_dist = d;
-                    best_target = &map[c];
-                }
-            }
-        }
+        int best_target = spatial_index_nearest_enemy(map->spatial, map, actor,
+                                                      actor->attack_range);
 
-        if (best_target != NULL && actor->can_act) {
-            combat_execute_at_cells(grid_config, map, actor_cell, best_target);
+        if (best_target != MAP_NO_CELL && actor->can_act) {
+            command_log_attack(state->commands, map, actor_cell, best_target);
             // continue to next actor
             continue;
         }
@@ -167,60 +229,57 @@ void game_process_ai_turn(GameState *state, Point *map, GridConfig *grid_config)
         // No enemy in immediate attack range
         if (!actor->can_move) continue;
 
-        // First: try to find a closest enemy that can be reached (move + range)
-        Point *closest_enemy = NULL;
-        int closest_dist = 999999;
-        for (int c = 0; c < total_cells; c++) {
-            if (map[c].occupant == NULL) continue;
-            Actor *other = map[c].occupant;
-            if (!actor_is_enemy(actor, other)) continue;
-            int d = combat_get_distance(actor_cell, &map[c]);
-            if (d < closest_dist) {
-                closest_dist = d;
-                closest_enemy = &map[c];
+        // Walk down the distance field towards the nearest enemy by path
+        // cost, as far as this turn's movement goes. When friendly units
+        // block the way, or no enemy can be reached at all, take an A* path
+        // towards the closest enemy instead, which routes around them or
+        // ends as near as the terrain allows.
+        int actor_x = map_cell_x(map, actor_cell);
+        int actor_y = map_cell_y(map, actor_cell);
+
+        int dest = MAP_NO_CELL;
+        if (field != NULL) {
+            flow_field_update(field, map);
+            dest = flow_field_descend(field, map, actor_cell, actor->movement);
+        }
+        if (dest == MAP_NO_CELL) {
+            int closest_enemy = spatial_index_nearest_enemy(map->spatial, map, actor, -1);
+            if (closest_enemy != MAP_NO_CELL) {
+                dest = ai_path_destination(map, actor, closest_enemy);
             }
         }
 
-        bool moved = false;
-        if (closest_enemy != NULL && closest_dist <= (actor->movement + actor->attack_range)) {
-            // Move one step towards the enemy (reduce Manhattan distance)
-            int dx = closest_enemy->x - actor_cell->x;
-            int dy = closest_enemy->y - actor_cell->y;
-            int sx = (dx > 0) ? 1 : (dx < 0) ? -1 : 0;
-            int sy = (dy > 0) ? 1 : (dy < 0) ? -1 : 0;
-
-            // Prefer the axis with larger distance
-            int try_x_first = (abs(dx) >= abs(dy));
-            int try_order[2][2];
-            if (try_x_first) {
-                try_order[0][0] = sx; try_order[0][1] = 0;
-                try_order[1][0] = 0; try_order[1][1] = sy;
-            } else {
-                try_order[0][0] = 0; try_order[0][1] = sy;
-                try_order[1][0] = sx; try_order[1][1] = 0;
+        // Walking into more enemy reach than friendly support covers: weigh
+        // every cell in movement range by distance left against the damage
+        // that could land there. Staying put may win, which also skips the
+        // random move below.
+        bool hold = false;
+        if (dest != MAP_NO_CELL && field != NULL && influence != NULL) {
+            influence_map_update(influence, map);
+            if (ai_exposure(influence, actor, dest) > 0) {
+                dest = ai_scored_destination(map, field, influence, actor);
+                hold = (dest == MAP_NO_CELL);
             }
+        }
 
-            for (int t = 0; t < 2 && !moved; t++) {
-                int nx = actor_cell->x + try_order[t][0];
-                int ny = actor_cell->y + try_order[t][1];
-                if (!map_is_valid_coords(grid_config, nx, ny)) continue;
-                Point *dest = map_get_cell(map, grid_config, nx, ny);
-                if (dest == NULL) continue;
-                if (!map_can_unit_enter_cell(dest, actor)) continue;
-                // Move actor
-                dest->occupant = actor;
-                actor_cell->occupant = NULL;
-                actor->can_move = false;
-                moved = true;
-                // update actor_cell to new location so we can attempt an attack after moving
-                actor_cell = dest;
-                break;
-            }
+        bool moved = false;
+        if (dest != MAP_NO_CELL) {
+            command_log_move(state->commands, map, actor, dest);
+            moved = true;
+            // update actor_cell to new location so we can attempt an attack after moving
+            actor_cell = dest;
         }
 
-        // If we didn't move towards an enemy, fallback to probabilistic random move
-        if (!moved) {
-            int roll = rand() % 100;
+        // If no path led towards an enemy, fallback to probabilistic random move.
+        // Each actor gets its own stream per turn, so its rolls do not depend
+        // on how many numbers other actors consumed before it.
+        if (!moved && !hold) {
+            Rng rng;
+            uint64_t actor_seed = rng_mix(state->seed, (uint64_t)state->turn_number);
+            actor_seed = rng_mix(rng_mix(actor_seed, (uint64_t)current->id), (uint64_t)i);
+            rng_seed(&rng, actor_seed, RNG_STREAM_AI);
+
+            int roll = rng_range(&rng, 100);
             if (roll < 40) {
                 // stay still
                 continue;
@@ -229,7 +288,7 @@ void game_process_ai_turn(GameState *state, Point *map, GridConfig *grid_config)
             int dirs[4][2] = {{0,-1},{0,1},{-1,0},{1,0}};
             // Shuffle directions
             for (int k = 0; k < 4; k++) {
-                int r = rand() % 4;
+                int r = rng_range(&rng, 4);
                 int tx = dirs[k][0];
                 int ty = dirs[k][1];
                 dirs[k][0] = dirs[r][0];
@@ -239,41 +298,26 @@ void game_process_ai_turn(GameState *state, Point *map, GridConfig *grid_config)
             }
 
             for (int d = 0; d < 4; d++) {
-                int nx = actor_cell->x + dirs[d][0];
-                int ny = actor_cell->y + dirs[d][1];
-                if (!map_is_valid_coords(grid_config, nx, ny)) continue;
-                Point *dest = map_get_cell(map, grid_config, nx, ny);
-                if (dest == NULL) continue;
-                if (!map_can_unit_enter_cell(dest, actor)) continue;
+                int step = map_get_cell(map, actor_x + dirs[d][0], actor_y + dirs[d][1]);
+                if (step == MAP_NO_CELL) continue;
+                if (!map_can_unit_enter_cell(map, step, actor)) continue;
                 // Move actor
-                dest->occupant = actor;
-                actor_cell->occupant = NULL;
-                actor->can_move = false;
+                command_log_move(state->commands, map, actor, step);
+                actor_cell = step;
                 break;
             }
         }
         
         // After moving (either toward enemy or random), if actor can still act, try to attack any enemy now in range
         if (actor->can_act) {
-            Point *attack_target = NULL;
-            int attack_dist = 999999;
-            for (int c = 0; c < total_cells; c++) {
-                if (map[c].occupant == NULL) continue;
-                Actor *other = map[c].occupant;
-                if (!actor_is_enemy(actor, other)) continue;
-                if (combat_is_in_range(grid_config, actor_cell, &map[c], actor->attack_range)) {
-                    int d = combat_get_distance(actor_cell, &map[c]);
-                    if (d < attack_dist) {
-                        attack_dist = d;
-                        attack_target = &map[c];
-                    }
-                }
-            }
-            if (attack_target != NULL) {
-                combat_execute_at_cells(grid_config, map, actor_cell, attack_target);
+            int attack_target = spatial_index_nearest_enemy(map->spatial, map, actor,
+                                                            actor->attack_range);
+            if (attack_target != MAP_NO_CELL) {
+                command_log_attack(state->commands, map, actor_cell, attack_target);
             }
         }
     }
+    PROFILE_COUNTER("actors_processed", processed);
 
     // After AI processes, end the faction's turn
     game_end_current_turn(state);
@@ -287,6 +331,11 @@ Faction *game_get_current_faction(GameState *state) {
     return NULL;
 }
 
+uint64_t game_state_hash(GameState *state, Map *map) {
+    return map_hash(map) ^ zobrist_key(ZOBRIST_TURN, (uint32_t)state->turn_number,
+                                       (uint32_t)state->current_faction_index);
+}
+
 // ============================================================================
 // Unit Turn Management
 // ============================================================================
@@ -376,6 +425,34 @@ const char *game_get_phase_name(GamePhase phase) {
     }
 }
 
+void game_ai_search_defaults(AiSearchSettings *settings) {
+    settings->budget_ms = AI_SEARCH_DEFAULT_BUDGET_MS;
+    settings->max_playouts = 0;
+    settings->max_depth = 0;
+    settings->threads = AI_SEARCH_DEFAULT_THREADS;
+}
+
+bool game_parse_ai_mode(const char *name, AiMode *out) {
+    if (strcmp(name, "greedy") == 0) {
+        *out = AI_MODE_GREEDY;
+    } else if (strcmp(name, "mcts") == 0) {
+        *out = AI_MODE_MCTS;
+    } else if (strcmp(name, "alphabeta") == 0) {
+        *out = AI_MODE_ALPHABETA;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *game_ai_mode_name(AiMode mode) {
+    switch (mode) {
+        case AI_MODE_MCTS: return "mcts";
+        case AI_MODE_ALPHABETA: return "alphabeta";
+        default: return "greedy";
+    }
+}
+
 // ============================================================================
 // ============================================================================
 // Faction / troop utilities
@@ -385,3 +462,73 @@ int faction_count_alive(Faction *faction) {
     if (faction == NULL) return 0;
     return actor_array_count_alive(faction->actors, faction->actor_count);
 }
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Furthest cell along the path to `target_cell` that the actor's movement
+// pays for, stopping early once the target is in attack range. Returns
+// MAP_NO_CELL if not even the first step is affordable.
+static int ai_path_destination(Map *map, Actor *actor, int target_cell) {
+    int distance = combat_get_distance(map, actor->cell, target_cell);
+    int max_expansions = AI_PATH_EXPANSIONS_PER_CELL * (distance + actor->movement);
+    if (max_expansions > AI_PATH_MAX_EXPANSIONS) max_expansions = AI_PATH_MAX_EXPANSIONS;
+
+    int path[AI_PATH_MAX_CELLS];
+    int length = pathfinder_find(map->paths, map, actor->cell, target_cell,
+                                 max_expansions, path, AI_PATH_MAX_CELLS);
+
+    int dest = MAP_NO_CELL;
+    int budget = actor->movement;
+    for (int i = 1; i < length && path[i] != target_cell; i++) {
+        int cost = map_get_move_cost(map, path[i]);
+        if (cost > budget) break;
+        budget -= cost;
+        dest = path[i];
+        if (combat_get_distance(map, dest, target_cell) <= actor->attack_range) break;
+    }
+    return dest;
+}
+
+// Best-scoring cell within the actor's movement, or MAP_NO_CELL when no
+// cell beats staying where it is
+static int ai_scored_destination(Map *map, const FlowField *field, const InfluenceMap *influence,
+                                 Actor *actor) {
+    int start = actor->cell;
+    int reached = reachability_compute(map->reach, map, start, actor->movement, REACH_MOVEMENT);
+
+    int best = start;
+    int best_score = ai_score_cell(field, influence, actor, start);
+    for (int i = 0; i < reached; i++) {
+        int cell = map->reach->reached[i];
+        if (cell == start) continue;
+        int score = ai_score_cell(field, influence, actor, cell);
+        if (score > best_score) {
+            best = cell;
+            best_score = score;
+        }
+    }
+    return (best == start) ? MAP_NO_CELL : best;
+}
+
+// Higher is better
+static int ai_score_cell(const FlowField *field, const InfluenceMap *influence, Actor *actor, int cell) {
+    int distance = flow_field_distance(field, cell);
+    if (distance == FLOW_UNREACHABLE) return INT_MIN;
+
+    int exposure = ai_exposure(influence, actor, cell);
+    int score = -AI_DISTANCE_WEIGHT * distance - exposure;
+    if (exposure >= actor->curr_health) score -= AI_LETHAL_PENALTY;
+    return score;
+}
+
+// Enemy damage that could land on `cell` beyond what friendly units could
+// answer. The unit's own stamp covers its whole movement range, so it is
+// taken out of the support.
+static int ai_exposure(const InfluenceMap *influence, Actor *actor, int cell) {
+    int faction_id = actor->owner->id;
+    int allies = influence_map_support(influence, faction_id, cell) - actor->phys_attack;
+    int exposure = influence_map_threat(influence, faction_id, cell) - ((allies > 0) ? allies : 0);
+    return (exposure > 0) ? exposure : 0;
+}
@@ -3,7 +3,9 @@
 
 #include "types.h"
 #include "game/map.h"
+#include "game/command_log.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 // Game phase enum - tracks what phase the game is in
 typedef enum {
@@ -14,6 +16,32 @@ typedef enum {
     PHASE_VICTORY
 } GamePhase;
 
+// Which AI plays the non-player factions
+typedef enum {
+    AI_MODE_GREEDY,     // per-unit: walk towards the nearest enemy, strike what is in range
+    AI_MODE_MCTS,       // Monte Carlo tree search over the faction's moves and attacks
+    AI_MODE_ALPHABETA   // alpha-beta search for units in contact, greedy for the rest
+} AiMode;
+
+// Knobs for the search AIs; the greedy AI ignores them
+typedef struct AiSearchSettings {
+    int budget_ms;      // thinking time per faction turn; 0 for no deadline
+    int max_playouts;   // MCTS playouts per decision and worker; 0 for no cap
+    int max_depth;      // alpha-beta plies per decision; 0 to deepen until the deadline
+    int threads;        // search workers, each with its own tree
+} AiSearchSettings;
+
+// Search totals over the match so far, for speed reports
+typedef struct AiSearchStats {
+    long long playouts;
+    long long nodes;        // alpha-beta positions visited
+    long long tt_probes;    // transposition table lookups
+    long long tt_hits;      // lookups that found the position
+    long long depth_sum;    // deepest completed iteration, summed over decisions
+    double seconds;         // wall time spent searching
+    int searches;           // decisions searched
+} AiSearchStats;
+
 // Game state structure - holds all game state information
 typedef struct {
     GamePhase current_phase;
@@ -23,14 +51,19 @@ typedef struct {
     int turn_number;
     bool game_over;
     Faction *winner;
+    uint64_t seed;  // match seed; AI rolls are derived from it per turn and actor
+    AiMode ai_mode[MAX_FACTIONS];   // per faction, for its AI turns
+    AiSearchSettings ai_search;
+    AiSearchStats ai_stats;
+    CommandLog *commands;   // unit actions; undo reaches back to the start of the turn
 } GameState;
 
 // Troops are now stored directly on the Faction as `actors` and `actor_count`.
 
 // Game initialization
-GameState *game_state_create(Faction *factions, int num_factions);
+GameState *game_state_create(Faction *factions, int num_factions, uint64_t seed);
 void game_state_free(GameState *state);
-void game_state_init(GameState *state, Faction *factions, int num_factions);
+void game_state_init(GameState *state, Faction *factions, int num_factions, uint64_t seed);
 
 // Turn management
 void game_next_turn(GameState *state);
@@ -38,8 +71,19 @@ void game_end_current_turn(GameState *state);
 void game_start_faction_turn(GameState *state);
 Faction *game_get_current_faction(GameState *state);
 
+// Zobrist hash of the match: the map's (see map_hash) together with the
+// turn number and the faction to move. Equal states hash equal, so it keys
+// AI caches and serves as a per-turn checksum for replays.
+uint64_t game_state_hash(GameState *state, Map *map);
+
 // AI processing for non-player factions
-void game_process_ai_turn(GameState *state, Point *map, GridConfig *grid_config);
+void game_process_ai_turn(GameState *state, Map *map);
+
+void game_ai_search_defaults(AiSearchSettings *settings);
+
+// "greedy" / "mcts" / "alphabeta"; returns false for unknown names
+bool game_parse_ai_mode(const char *name, AiMode *out);
+const char *game_ai_mode_name(AiMode mode);
 
 // Unit turn management
 void game_reset_faction_units(Faction *faction);
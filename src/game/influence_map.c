@@ -0,0 +1,410 @@
+#include "game/influence_map.h"
+#include "game/map.h"
+#include "core/bitboard.h"
+#include "core/profiler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Initial zone search window size (cells); it grows with the reach
+#define INFLUENCE_WINDOW_INITIAL 256
+
+// Forward declarations for internal helper functions
+static void sync_cell(InfluenceMap *influence, Map *map, int cell);
+static void refresh_step(InfluenceMap *influence, Map *map, int cell, int x, int y);
+static bool ensure_stamps(InfluenceMap *influence, int count);
+static bool stamp_unit(InfluenceMap *influence, Map *map, int handle, int cell);
+static void unstamp_unit(InfluenceMap *influence, int handle);
+static bool collect_zone(InfluenceMap *influence, Map *map, Actor *actor, int cell, InfluenceStamp *stamp);
+static bool zone_reserve(InfluenceStamp *stamp, int capacity);
+static bool ensure_window(InfluenceMap *influence, int size);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+InfluenceMap *influence_map_create(int cell_count) {
+    InfluenceMap *influence = calloc(1, sizeof(InfluenceMap));
+    if (influence == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for influence map\n");
+        return NULL;
+    }
+
+    influence->cell_count = cell_count;
+    influence->total = calloc(cell_count, sizeof(int));
+    influence->anchor = calloc(cell_count, sizeof(uint16_t));
+    influence->step = calloc(cell_count, sizeof(uint8_t));
+
+    if (influence->total == NULL || influence->anchor == NULL || influence->step == NULL ||
+        !ensure_window(influence, INFLUENCE_WINDOW_INITIAL)) {
+        fprintf(stderr, "Error: Failed to allocate memory for influence map buffers\n");
+        influence_map_free(influence);
+        return NULL;
+    }
+
+    return influence;
+}
+
+void influence_map_free(InfluenceMap *influence) {
+    if (influence == NULL) return;
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        free(influence->layer[f]);
+    }
+    for (int i = 0; i < influence->stamp_count; i++) {
+        free(influence->stamps[i].cells);
+    }
+    free(influence->stamps);
+    free(influence->total);
+    free(influence->anchor);
+    free(influence->step);
+    free(influence->window_cell);
+    free(influence->window_step);
+    free(influence->window_cost);
+    free(influence->queue);
+    free(influence->flag);
+    free(influence);
+}
+
+InfluenceMap *influence_map_current(Map *map) {
+    if (map->influence == NULL) {
+        map->influence = influence_map_create(map->cell_count);
+        if (map->influence == NULL) return NULL;
+    }
+    influence_map_update(map->influence, map);
+    return map->influence;
+}
+
+// ============================================================================
+// Updates
+// ============================================================================
+
+void influence_map_rebuild(InfluenceMap *influence, Map *map) {
+    PROFILE_BEGIN("influence_rebuild");
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        if (influence->layer[f] != NULL) {
+            memset(influence->layer[f], 0, sizeof(int) * influence->cell_count);
+        }
+    }
+    memset(influence->total, 0, sizeof(int) * influence->cell_count);
+    memset(influence->anchor, 0, sizeof(uint16_t) * influence->cell_count);
+    for (int i = 0; i < influence->stamp_count; i++) {
+        influence->stamps[i].cell = MAP_NO_CELL;
+    }
+    for (int y = 0; y < map->height; y++) {
+        for (int x = 0; x < map->width; x++) {
+            refresh_step(influence, map, map_get_cell(map, x, y), x, y);
+        }
+    }
+
+    // Units on the map are exactly those whose cell holds their handle
+    influence->last_cells = 0;
+    for (int handle = 1; handle <= map->actor_count; handle++) {
+        Actor *actor = map->actors[handle - 1];
+        if (actor == NULL || actor->cell == MAP_NO_CELL) continue;
+        if (map->occupant[actor->cell] != handle) continue;
+        stamp_unit(influence, map, handle, actor->cell);
+    }
+
+    influence->built = true;
+    influence->synced = map_change_count(map);
+    influence->last_rebuilt = true;
+    PROFILE_END();
+}
+
+void influence_map_update(InfluenceMap *influence, Map *map) {
+    uint64_t now = map_change_count(map);
+    if (!influence->built || now - influence->synced > MAP_CHANGE_LOG_SIZE) {
+        influence_map_rebuild(influence, map);
+        return;
+    }
+    influence->last_rebuilt = false;
+    influence->last_cells = 0;
+    if (now == influence->synced) return;
+
+    PROFILE_BEGIN("influence_update");
+    for (uint64_t i = influence->synced; i < now; i++) {
+        sync_cell(influence, map, map_get_change(map, i));
+    }
+    influence->synced = now;
+    PROFILE_COUNTER("influence_cells", influence->last_cells);
+    PROFILE_END();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+int influence_map_threat(const InfluenceMap *influence, int faction_id, int cell) {
+    if (cell < 0 || cell >= influence->cell_count) return 0;
+    return influence->total[cell] - influence_map_support(influence, faction_id, cell);
+}
+
+int influence_map_support(const InfluenceMap *influence, int faction_id, int cell) {
+    if (cell < 0 || cell >= influence->cell_count) return 0;
+    if (faction_id < 0 || faction_id >= MAX_FACTIONS) return 0;
+    if (influence->layer[faction_id] == NULL) return 0;
+    return influence->layer[faction_id][cell];
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// A journaled cell: the unit stamped from it may have left, died or changed,
+// and the unit now on it may need stamping. Cells journaled more than once
+// settle on the first visit.
+static void sync_cell(InfluenceMap *influence, Map *map, int cell) {
+    refresh_step(influence, map, cell, map_cell_x(map, cell), map_cell_y(map, cell));
+
+    int stamped = influence->anchor[cell];
+    if (stamped != 0) {
+        Actor *actor = map->actors[stamped - 1];
+        InfluenceStamp *stamp = &influence->stamps[stamped - 1];
+        if (actor->cell != cell || map->occupant[cell] != stamped ||
+            actor->phys_attack != stamp->value) {
+            unstamp_unit(influence, stamped);
+        }
+    }
+
+    int occupant = map->occupant[cell];
+    if (occupant != 0 && influence->anchor[cell] != occupant) {
+        if (occupant <= influence->stamp_count && influence->stamps[occupant - 1].cell != MAP_NO_CELL) {
+            unstamp_unit(influence, occupant);
+        }
+        stamp_unit(influence, map, occupant, cell);
+    }
+}
+
+// Structures come and go through the journal; terrain is fixed once play starts
+static void refresh_step(InfluenceMap *influence, Map *map, int cell, int x, int y) {
+    int step = 0;
+    if (bitboard_test(map->passable_layer, x, y)) {
+        step = map_get_move_cost(map, cell);
+        if (step > UINT8_MAX) step = UINT8_MAX;
+    }
+    influence->step[cell] = (uint8_t)step;
+}
+
+static bool ensure_stamps(InfluenceMap *influence, int count) {
+    if (count <= influence->stamp_count) return true;
+
+    InfluenceStamp *stamps = realloc(influence->stamps, sizeof(InfluenceStamp) * count);
+    if (stamps == NULL) {
+        fprintf(stderr, "Error: Failed to grow influence map stamps\n");
+        return false;
+    }
+    for (int i = influence->stamp_count; i < count; i++) {
+        stamps[i].cell = MAP_NO_CELL;
+        stamps[i].faction_id = 0;
+        stamps[i].value = 0;
+        stamps[i].cells = NULL;
+        stamps[i].count = 0;
+        stamps[i].capacity = 0;
+    }
+    influence->stamps = stamps;
+    influence->stamp_count = count;
+    return true;
+}
+
+// Adds the unit's damage potential over its strike zone from `cell`
+static bool stamp_unit(InfluenceMap *influence, Map *map, int handle, int cell) {
+    Actor *actor = map->actors[handle - 1];
+    if (actor->owner == NULL) return false;
+    int faction_id = actor->owner->id;
+    if (faction_id < 0 || faction_id >= MAX_FACTIONS) return false;
+    if (!ensure_stamps(influence, map->actor_count)) return false;
+
+    if (influence->layer[faction_id] == NULL) {
+        influence->layer[faction_id] = calloc(influence->cell_count, sizeof(int));
+        if (influence->layer[faction_id] == NULL) {
+            fprintf(stderr, "Error: Failed to allocate influence layer\n");
+            return false;
+        }
+    }
+
+    InfluenceStamp *stamp = &influence->stamps[handle - 1];
+    if (!collect_zone(influence, map, actor, cell, stamp)) return false;
+
+    int value = actor->phys_attack;
+    int *layer = influence->layer[faction_id];
+    for (int i = 0; i < stamp->count; i++) {
+        int c = stamp->cells[i];
+        layer[c] += value;
+        influence->total[c] += value;
+    }
+    stamp->cell = cell;
+    stamp->faction_id = faction_id;
+    stamp->value = value;
+    influence->anchor[cell] = (uint16_t)handle;
+    influence->last_cells += stamp->count;
+    return true;
+}
+
+static void unstamp_unit(InfluenceMap *influence, int handle) {
+    InfluenceStamp *stamp = &influence->stamps[handle - 1];
+    int *layer = influence->layer[stamp->faction_id];
+    for (int i = 0; i < stamp->count; i++) {
+        int c = stamp->cells[i];
+        layer[c] -= stamp->value;
+        influence->total[c] -= stamp->value;
+    }
+    if (influence->anchor[stamp->cell] == handle) {
+        influence->anchor[stamp->cell] = 0;
+    }
+    influence->last_cells += stamp->count;
+    stamp->cell = MAP_NO_CELL;
+    stamp->count = 0;
+}
+
+// The cells `actor` can attack next turn from `cell`: everything its
+// movement reaches over terrain and structures, widened by its attack range.
+// Other units are ignored, so the zone only changes when the unit moves.
+// Steps cost at least one point, so the zone fits the diamond of radius
+// movement + attack range. It is searched in a window around that diamond
+// with a blocked border, so steps never need bounds checks.
+static bool collect_zone(InfluenceMap *influence, Map *map, Actor *actor, int cell, InfluenceStamp *stamp) {
+    stamp->count = 0;
+    int movement = (actor->movement > 0) ? actor->movement : 0;
+    int attack_range = (actor->attack_range > 0) ? actor->attack_range : 0;
+    int radius = movement + attack_range;
+    int width = 2 * radius + 3;
+    int size = width * width;
+    if (!ensure_window(influence, size)) return false;
+
+    int *window_cell = influence->window_cell;
+    int *window_step = influence->window_step;
+    int *window_cost = influence->window_cost;
+    uint8_t *flag = influence->flag;
+    for (int w = 0; w < size; w++) {
+        window_cell[w] = MAP_NO_CELL;
+        window_step[w] = 0;
+        window_cost[w] = -1;
+        flag[w] = 0;
+    }
+
+    // Step costs inside the diamond, clipped to the map. Slots run
+    // consecutively along a row within a chunk.
+    int center = (radius + 1) * width + radius + 1;
+    int origin_x = map_cell_x(map, cell);
+    int origin_y = map_cell_y(map, cell);
+    for (int dy = -radius; dy <= radius; dy++) {
+        int y = origin_y + dy;
+        if (y < 0 || y >= map->height) continue;
+        int span = radius - abs(dy);
+        int x_min = (origin_x - span < 0) ? 0 : origin_x - span;
+        int x_max = (origin_x + span >= map->width) ? map->width - 1 : origin_x + span;
+        int w = center + dy * width + (x_min - origin_x);
+        int c = map_get_cell(map, x_min, y);
+        for (int x = x_min; x <= x_max; x++, w++, c++) {
+            if (x > x_min && (x & (MAP_CHUNK_SIZE - 1)) == 0) c = map_get_cell(map, x, y);
+            window_cell[w] = c;
+            window_step[w] = influence->step[c];
+        }
+    }
+
+    // Movement: a label-correcting search over the window, each index
+    // queued at most once at a time
+    const int steps[4] = {-width, width, -1, 1};
+    int *queue = influence->queue;
+    int head = 0;
+    int tail = 0;
+    int queued = 0;
+    queue[tail++] = center;
+    queued++;
+    flag[center] = 1;
+    window_cost[center] = 0;
+    while (queued > 0) {
+        int w = queue[head];
+        if (++head == size) head = 0;
+        queued--;
+        flag[w] = 0;
+
+        for (int d = 0; d < 4; d++) {
+            int n = w + steps[d];
+            if (window_step[n] == 0) continue;
+
+            int cost = window_cost[w] + window_step[n];
+            if (cost > movement) continue;
+            if (window_cost[n] != -1 && window_cost[n] <= cost) continue;
+            window_cost[n] = cost;
+            if (!flag[n]) {
+                flag[n] = 1;
+                queue[tail] = n;
+                if (++tail == size) tail = 0;
+                queued++;
+            }
+        }
+    }
+
+    // Attack range: mark the attack diamond around every cell the unit can
+    // stand on (the search left every flag clear), then collect the marks.
+    // The queue is free again and holds the diamond's window offsets.
+    int *offsets = queue;
+    int offset_count = 0;
+    for (int ay = -attack_range; ay <= attack_range; ay++) {
+        int attack_span = attack_range - abs(ay);
+        for (int ax = -attack_span; ax <= attack_span; ax++) {
+            offsets[offset_count++] = ay * width + ax;
+        }
+    }
+    for (int dy = -movement; dy <= movement; dy++) {
+        int span = movement - abs(dy);
+        for (int dx = -span; dx <= span; dx++) {
+            int w = center + dy * width + dx;
+            if (window_cost[w] < 0) continue;
+            for (int k = 0; k < offset_count; k++) {
+                flag[w + offsets[k]] = 1;
+            }
+        }
+    }
+
+    if (!zone_reserve(stamp, 2 * radius * (radius + 1) + 1)) return false;
+    int *cells = stamp->cells;
+    int count = 0;
+    for (int dy = -radius; dy <= radius; dy++) {
+        int span = radius - abs(dy);
+        for (int dx = -span; dx <= span; dx++) {
+            int w = center + dy * width + dx;
+            if (flag[w] && window_cell[w] != MAP_NO_CELL) {
+                cells[count++] = window_cell[w];
+            }
+        }
+    }
+    stamp->count = count;
+    return true;
+}
+
+static bool zone_reserve(InfluenceStamp *stamp, int capacity) {
+    if (capacity <= stamp->capacity) return true;
+
+    int *cells = realloc(stamp->cells, sizeof(int) * capacity);
+    if (cells == NULL) {
+        fprintf(stderr, "Error: Failed to grow influence zone\n");
+        return false;
+    }
+    stamp->cells = cells;
+    stamp->capacity = capacity;
+    return true;
+}
+
+static bool ensure_window(InfluenceMap *influence, int size) {
+    if (size <= influence->window_capacity) return true;
+
+    int *cells = realloc(influence->window_cell, sizeof(int) * size);
+    if (cells != NULL) influence->window_cell = cells;
+    int *steps = realloc(influence->window_step, sizeof(int) * size);
+    if (steps != NULL) influence->window_step = steps;
+    int *costs = realloc(influence->window_cost, sizeof(int) * size);
+    if (costs != NULL) influence->window_cost = costs;
+    int *queue = realloc(influence->queue, sizeof(int) * size);
+    if (queue != NULL) influence->queue = queue;
+    uint8_t *flag = realloc(influence->flag, size);
+    if (flag != NULL) influence->flag = flag;
+
+    if (cells == NULL || steps == NULL || costs == NULL || queue == NULL || flag == NULL) {
+        fprintf(stderr, "Error: Failed to grow influence zone window\n");
+        return false;
+    }
+    influence->window_capacity = size;
+    return true;
+}
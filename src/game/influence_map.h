@@ -0,0 +1,70 @@
+#ifndef INFLUENCE_MAP_H_
+#define INFLUENCE_MAP_H_
+
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Where one unit's influence was last stamped
+typedef struct InfluenceStamp {
+    int cell;               // anchor cell, MAP_NO_CELL when not stamped
+    int faction_id;
+    int value;              // damage potential added to every cell of the zone
+    int *cells;             // the zone: cells the unit can strike next turn
+    int count;
+    int capacity;
+} InfluenceStamp;
+
+// Per-faction influence: for every cell, the summed damage potential of the
+// faction's units that can strike it next turn (move, then attack). A
+// faction's threat is everyone else's influence, its support its own.
+//
+// Each unit stamps its strike zone into its faction's layer and remembers
+// the zone, so the stamp comes off exactly even if the map changed since.
+// Updates follow the map's change journal and restamp only the units that
+// moved, died or appeared; the journal wrapping forces a rebuild. Zones
+// follow terrain and structures but ignore other units, so one unit's move
+// never touches another's stamp. Stat changes show up when a unit next moves.
+typedef struct InfluenceMap {
+    int cell_count;
+    int *layer[MAX_FACTIONS];   // per faction, NULL until it has a unit stamped
+    int *total;                 // all factions together
+    uint16_t *anchor;           // handle of the unit stamped from the cell, 0 if none
+    uint8_t *step;              // move cost into the cell, 0 where blocked
+    InfluenceStamp *stamps;     // per actor handle (handle h at h - 1)
+    int stamp_count;
+    bool built;
+    uint64_t synced;            // map change count the layers reflect
+
+    // Strike zone search scratch: a square window centred on the unit
+    int *window_cell;           // map cell, MAP_NO_CELL off the map or out of reach
+    int *window_step;           // `step` of the cell, 0 off the map
+    int *window_cost;           // movement spent to get there, -1 until reached
+    int *queue;                 // ring of window indices
+    uint8_t *flag;              // queued during the search, then in the zone
+    int window_capacity;
+
+    // Last update, for benchmarks and traces
+    bool last_rebuilt;
+    int last_cells;             // zone cells stamped or unstamped
+} InfluenceMap;
+
+// Lifecycle. cell_count is the map's slot count (map->cell_count).
+InfluenceMap *influence_map_create(int cell_count);
+void influence_map_free(InfluenceMap *influence);
+
+// Brings the layers up to date with the map, or rebuilds them when they
+// were never built or the journal has moved on too far
+void influence_map_update(InfluenceMap *influence, Map *map);
+void influence_map_rebuild(InfluenceMap *influence, Map *map);
+
+// The map's influence map, created on first use and updated before it is
+// returned. NULL if it cannot be allocated.
+InfluenceMap *influence_map_current(Map *map);
+
+// Enemy damage potential that can reach `cell` next turn, and the same for
+// `faction_id`'s own units
+int influence_map_threat(const InfluenceMap *influence, int faction_id, int cell);
+int influence_map_support(const InfluenceMap *influence, int faction_id, int cell);
+
+#endif
@@ -1,96 +1,263 @@
 #include "game/map.h"
+#include "game/reachability.h"
+#include "game/pathfinding.h"
+#include "game/flow_field.h"
+#include "game/influence_map.h"
+#include "game/spatial_index.h"
+#include "game/structure.h"
+#include "game/terrain.h"
+#include "game/actor.h"
+#include "game/zobrist.h"
+#include "core/bitboard.h"
+#include "core/grid_kernel.h"
+#include "core/parallel.h"
+#include "core/profiler.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
+// Handles are stored as uint16_t with 0 meaning "empty"
+#define MAP_MAX_HANDLES 65535
+
+// Terrain id used for the border of padded grids; matches every terrain
+#define MAP_TERRAIN_WILDCARD 0xFF
+
+// Shared state of one deep terrain pass, split into bands of chunk rows
+typedef struct DeepTerrainPass {
+    Map *map;
+    PaddedGrid *grid;
+    uint8_t *mask;
+    uint8_t deep[256];
+} DeepTerrainPass;
+
 // Forward declarations for internal helper functions
-static void calculate_range_recursive(GridConfig *grid_config, Point *map,
-                                      Point *current_cell, int remaining_range,
-                                      bool enable, bool is_attack_range);
+static void deep_gather_band(void *ctx, int chunk_row);
+static void deep_apply_band(void *ctx, int chunk_row);
+static void apply_range_flags(Map *map, int start_cell, int range, bool enable, ReachMode mode);
+static int register_actor(Map *map, Actor *actor);
+static int register_structure(Map *map, Structure *s);
+static bool is_valid_spawn_cell(Map *map, int cell);
+static void refresh_passability(Map *map, int cell);
+static void set_occupant(Map *map, int cell, Actor *actor);
+static void record_change(Map *map, int cell);
+static uint64_t chunk_terrain_hash(Map *map, int chunk);
 
 // ============================================================================
 // Map Creation and Initialization
 // ============================================================================
 
-Point *map_create(GridConfig *grid_config, Terrain default_terrain) {
-    int total_cells = grid_config->max_grid_cells_x * grid_config->max_grid_cells_y;
-    Point *map = malloc(sizeof(Point) * total_cells);
-    
+Map *map_create(GridConfig *grid_config, Terrain *terrains, int default_terrain) {
+    Map *map = calloc(1, sizeof(Map));
     if (map == NULL) {
         fprintf(stderr, "Error: Failed to allocate memory for map\n");
         return NULL;
     }
-    
-    map_init_cells(map, grid_config, default_terrain);
-    return map;
-}
 
-void map_free(Point *map) {
-    if (map != NULL) {
+    map->width = grid_config->max_grid_cells_x;
+    map->height = grid_config->max_grid_cells_y;
+    if (map->width <= 0 || map->height <= 0) {
+        fprintf(stderr, "Error: Invalid map size %dx%d\n", map->width, map->height);
         free(map);
+        return NULL;
     }
+    map->chunks_x = (map->width + MAP_CHUNK_SIZE - 1) >> MAP_CHUNK_SHIFT;
+    map->chunks_y = (map->height + MAP_CHUNK_SIZE - 1) >> MAP_CHUNK_SHIFT;
+    map->chunk_count = map->chunks_x * map->chunks_y;
+    map->cell_count = map->chunk_count * MAP_CHUNK_CELLS;
+    map->terrains = terrains;
+
+    map->terrain = malloc(sizeof(uint8_t) * map->cell_count);
+    map->occupant = malloc(sizeof(uint16_t) * map->cell_count);
+    map->structure = malloc(sizeof(uint16_t) * map->cell_count);
+    map->range_layer = bitboard_create(map->width, map->height);
+    map->attack_layer = bitboard_create(map->width, map->height);
+    map->strike_layer = bitboard_create(map->width, map->height);
+    map->target_layer = bitboard_create(map->width, map->height);
+    map->passable_layer = bitboard_create(map->width, map->height);
+    map->reach = reachability_create(map->width, map->height, map->cell_count);
+    map->paths = pathfinder_create(map->cell_count);
+    map->change_log = malloc(sizeof(int) * MAP_CHANGE_LOG_SIZE);
+    map->terrain_hash = malloc(sizeof(uint64_t) * map->chunk_count);
+    map->terrain_stale = malloc(sizeof(bool) * map->chunk_count);
+    map->spatial = spatial_index_create(map->width, map->height);
+
+    bool layers_ok = true;
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        map->occupancy_layer[f] = bitboard_create(map->width, map->height);
+        if (map->occupancy_layer[f] == NULL) layers_ok = false;
+    }
+
+    if (map->terrain == NULL || map->occupant == NULL || map->structure == NULL ||
+        map->range_layer == NULL || map->attack_layer == NULL ||
+        map->strike_layer == NULL || map->target_layer == NULL ||
+        map->passable_layer == NULL || map->reach == NULL || map->paths == NULL ||
+        map->spatial == NULL || map->change_log == NULL || map->terrain_hash == NULL ||
+        map->terrain_stale == NULL || !layers_ok) {
+        fprintf(stderr, "Error: Failed to allocate memory for map cells\n");
+        map_free(map);
+        return NULL;
+    }
+
+    map_init_cells(map, default_terrain);
+    return map;
 }
 
-void map_init_cells(Point *map, GridConfig *grid_config, Terrain default_terrain) {
-    for (int y = 0; y < grid_config->max_grid_cells_y; y++) {
-        for (int x = 0; x < grid_config->max_grid_cells_x; x++) {
-            int index = x + y * grid_config->max_grid_cells_x;
-            map[index].x = x;
-            map[index].y = y;
-            map[index].occupant = NULL;
-            map[index].in_range = false;
-            map[index].in_attack_range = false;
-            map[index].structure = NULL;
-            map[index].terrain = default_terrain;
+void map_free(Map *map) {
+    if (map == NULL) return;
+
+    // The map owns every structure still placed on it
+    for (int i = 0; i < map->structure_count; i++) {
+        structure_free(map->structures[i]);
+    }
+    // Actors outlive it, so they must stop folding into its hash
+    for (int i = 0; i < map->actor_count; i++) {
+        actor_attach_hash(map->actors[i], NULL);
+    }
+
+    free(map->terrain);
+    free(map->occupant);
+    free(map->structure);
+    bitboard_free(map->range_layer);
+    bitboard_free(map->attack_layer);
+    bitboard_free(map->strike_layer);
+    bitboard_free(map->target_layer);
+    bitboard_free(map->passable_layer);
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        bitboard_free(map->occupancy_layer[f]);
+    }
+    free(map->actors);
+    free(map->structures);
+    reachability_free(map->reach);
+    pathfinder_free(map->paths);
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        flow_field_free(map->flow[f]);
+    }
+    influence_map_free(map->influence);
+    free(map->change_log);
+    free(map->terrain_hash);
+    free(map->terrain_stale);
+    spatial_index_free(map->spatial);
+    free(map);
+}
+
+void map_init_cells(Map *map, int default_terrain) {
+    // Unused slots in edge chunks hold TERRAIN_NONE so they never look walkable
+    memset(map->terrain, TERRAIN_NONE, sizeof(uint8_t) * map->cell_count);
+    for (int chunk = 0; chunk < map->chunk_count; chunk++) {
+        int x0, y0, w, h;
+        map_get_chunk_bounds(map, chunk, &x0, &y0, &w, &h);
+        uint8_t *base = map->terrain + (size_t)chunk * MAP_CHUNK_CELLS;
+        for (int ly = 0; ly < h; ly++) {
+            memset(base + (ly << MAP_CHUNK_SHIFT), default_terrain, w);
         }
     }
+    memset(map->occupant, 0, sizeof(uint16_t) * map->cell_count);
+    memset(map->structure, 0, sizeof(uint16_t) * map->cell_count);
+
+    bitboard_clear(map->range_layer);
+    bitboard_clear(map->attack_layer);
+    bitboard_clear(map->strike_layer);
+    bitboard_clear(map->target_layer);
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        bitboard_clear(map->occupancy_layer[f]);
+    }
+    spatial_index_clear(map->spatial);
+
+    // Put every journal entry out of reach, so caches rebuild from scratch
+    map->change_count += MAP_CHANGE_LOG_SIZE + 1;
+
+    // Occupants and structures are gone; registered actors keep their part
+    for (int i = 0; i < map->actor_count; i++) {
+        actor_attach_hash(map->actors[i], NULL);
+    }
+    map->hash = 0;
+    for (int i = 0; i < map->actor_count; i++) {
+        actor_attach_hash(map->actors[i], &map->hash);
+    }
+    memset(map->terrain_stale, true, sizeof(bool) * map->chunk_count);
+
+    if (map->terrains[default_terrain].passable) {
+        bitboard_fill(map->passable_layer);
+    } else {
+        bitboard_clear(map->passable_layer);
+    }
 }
 
 // ============================================================================
 // Cell Access and Utilities
 // ============================================================================
 
-Point *map_get_cell(Point *map, GridConfig *grid_config, int x, int y) {
-    if (!map_is_valid_coords(grid_config, x, y)) {
-        return NULL;
+int map_get_cell(Map *map, int x, int y) {
+    if (!map_is_valid_coords(map, x, y)) {
+        return MAP_NO_CELL;
+    }
+    int chunk = (y >> MAP_CHUNK_SHIFT) * map->chunks_x + (x >> MAP_CHUNK_SHIFT);
+    int local = ((y & (MAP_CHUNK_SIZE - 1)) << MAP_CHUNK_SHIFT) | (x & (MAP_CHUNK_SIZE - 1));
+    return chunk * MAP_CHUNK_CELLS + local;
+}
+
+int map_cell_x(Map *map, int cell) {
+    int chunk = cell / MAP_CHUNK_CELLS;
+    return ((chunk % map->chunks_x) << MAP_CHUNK_SHIFT) | (cell & (MAP_CHUNK_SIZE - 1));
+}
+
+int map_cell_y(Map *map, int cell) {
+    int chunk = cell / MAP_CHUNK_CELLS;
+    return ((chunk / map->chunks_x) << MAP_CHUNK_SHIFT) |
+           ((cell >> MAP_CHUNK_SHIFT) & (MAP_CHUNK_SIZE - 1));
+}
+
+bool map_is_valid_cell(Map *map, int cell) {
+    if (cell < 0 || cell >= map->cell_count) return false;
+    return map_cell_x(map, cell) < map->width && map_cell_y(map, cell) < map->height;
+}
+
+int map_get_neighbor(Map *map, int cell, int dx, int dy) {
+    // Stay inside the chunk with plain index arithmetic when possible
+    int lx = (cell & (MAP_CHUNK_SIZE - 1)) + dx;
+    int ly = ((cell >> MAP_CHUNK_SHIFT) & (MAP_CHUNK_SIZE - 1)) + dy;
+    if (lx >= 0 && lx < MAP_CHUNK_SIZE && ly >= 0 && ly < MAP_CHUNK_SIZE) {
+        int neighbor = cell + dy * MAP_CHUNK_SIZE + dx;
+        return map_is_valid_cell(map, neighbor) ? neighbor : MAP_NO_CELL;
     }
-    return map + x + y * grid_config->max_grid_cells_x;
+    return map_get_cell(map, map_cell_x(map, cell) + dx, map_cell_y(map, cell) + dy);
 }
 
-Point *map_get_random_cell(Point *map, GridConfig *grid_config) {
-    int rand_x = rand() % grid_config->max_grid_cells_x;
-    int rand_y = rand() % grid_config->max_grid_cells_y;
-    return map + rand_x + rand_y * grid_config->max_grid_cells_x;
+int map_get_random_cell(Map *map, Rng *rng) {
+    int rand_x = rng_range(rng, map->width);
+    int rand_y = rng_range(rng, map->height);
+    return map_get_cell(map, rand_x, rand_y);
 }
 
-Point *map_get_random_spawn_cell(Point *map, GridConfig *grid_config) {
-    Point *cell = map_get_random_cell(map, grid_config);
+int map_get_random_spawn_cell(Map *map, Rng *rng) {
+    int cell = map_get_random_cell(map, rng);
     int max_attempts = 1000; // Prevent infinite loop
     int attempts = 0;
-    
+
     // Keep trying until we find a valid spawn location
-    while ((cell->terrain.id == 2 || cell->occupant != NULL) && attempts < max_attempts) {
-        cell = map_get_random_cell(map, grid_config);
+    while ((map->terrain[cell] == TERRAIN_SEA || map->occupant[cell] != 0) && attempts < max_attempts) {
+        cell = map_get_random_cell(map, rng);
         attempts++;
     }
-    
+
     if (attempts >= max_attempts) {
         fprintf(stderr, "Warning: Could not find valid spawn cell after %d attempts\n", max_attempts);
     }
-    
+
     return cell;
 }
 
-bool map_is_valid_coords(GridConfig *grid_config, int x, int y) {
-    return (x >= 0 && x < grid_config->max_grid_cells_x &&
-            y >= 0 && y < grid_config->max_grid_cells_y);
+bool map_is_valid_coords(Map *map, int x, int y) {
+    return (x >= 0 && x < map->width &&
+            y >= 0 && y < map->height);
 }
 
-Point * map_get_random_corner_cell(Point * mapArr, GridConfig * grid_config, int corner, int area_size) {
-    // 0: top left and then like the clock 
+int map_get_random_corner_cell(Map *map, Rng *rng, int corner, int area_size) {
+    // 0: top left and then like the clock
     // +1 so its at least one and in bounds
-    int x_offset = rand() % area_size + 1;
-    int y_offset = rand() % area_size + 1;
+    int x_offset = rng_range(rng, area_size) + 1;
+    int y_offset = rng_range(rng, area_size) + 1;
 
     int x_corner, y_corner;
 
@@ -98,43 +265,43 @@ Point * map_get_random_corner_cell(Point * mapArr, GridConfig * grid_config, int
     if ( corner == 0 ) {
         x_corner = 0;
         y_corner = 0;
-        return map_get_cell(mapArr, grid_config, x_corner + x_offset, y_corner + y_offset);
+        return map_get_cell(map, x_corner + x_offset, y_corner + y_offset);
     }
     // top right
     if ( corner == 1 ) {
-        x_corner = grid_config->max_grid_cells_x;
+        x_corner = map->width;
         y_corner = 0;
-        return map_get_cell(mapArr, grid_config, x_corner - x_offset, y_corner + y_offset);
+        return map_get_cell(map, x_corner - x_offset, y_corner + y_offset);
     }
     // bottom right
     if ( corner == 2 ) {
-        x_corner = grid_config->max_grid_cells_x;
-        y_corner = grid_config->max_grid_cells_y;
-        return map_get_cell(mapArr, grid_config, x_corner - x_offset, y_corner - y_offset);
+        x_corner = map->width;
+        y_corner = map->height;
+        return map_get_cell(map, x_corner - x_offset, y_corner - y_offset);
     }
     // bottom left
     if ( corner == 3 ) {
         x_corner = 0;
-        y_corner = grid_config->max_grid_cells_y;
-        return map_get_cell(mapArr, grid_config, x_corner + x_offset, y_corner - y_offset);
+        y_corner = map->height;
+        return map_get_cell(map, x_corner + x_offset, y_corner - y_offset);
     }
 
-    assert(false);     
-    // dummy for now
+    assert(false);
+    return MAP_NO_CELL;
 }
 
-Point * map_get_random_corner_spawn_cell(Point* mapArr, GridConfig* grid_config, int corner, int area_size, int max_attempts) {
+int map_get_random_corner_spawn_cell(Map *map, Rng *rng, int corner, int area_size, int max_attempts) {
     // First: try a number of random attempts within the corner area
     for (int i = 0; i < max_attempts; i++) {
-        Point *cell = map_get_random_corner_cell(mapArr, grid_config, corner, area_size);
-        if (cell != NULL && !map_is_cell_occupied(cell) && map_is_terrain_passable(cell->terrain)) {
+        int cell = map_get_random_corner_cell(map, rng, corner, area_size);
+        if (is_valid_spawn_cell(map, cell)) {
             return cell;
         }
     }
 
     // Second: deterministic scan of the corner area (guarantee we check every cell in area)
-    int max_x = grid_config->max_grid_cells_x - 1;
-    int max_y = grid_config->max_grid_cells_y - 1;
+    int max_x = map->width - 1;
+    int max_y = map->height - 1;
     int start_x, start_y, end_x, end_y;
 
     if (corner == 0) {
@@ -157,18 +324,18 @@ Point * map_get_random_corner_spawn_cell(Point* mapArr, GridConfig* grid_config,
 
     for (int y = start_y; y <= end_y; y++) {
         for (int x = start_x; x <= end_x; x++) {
-            Point *cell = map_get_cell(mapArr, grid_config, x, y);
-            if (cell != NULL && !map_is_cell_occupied(cell) && map_is_terrain_passable(cell->terrain)) {
+            int cell = map_get_cell(map, x, y);
+            if (is_valid_spawn_cell(map, cell)) {
                 return cell;
             }
         }
     }
 
     // Third: fallback to scanning the entire map for any valid spawn cell
-    for (int y = 0; y <= max_y; y++) {
-        for (int x = 0; x <= max_x; x++) {
-            Point *cell = map_get_cell(mapArr, grid_config, x, y);
-            if (cell != NULL && !map_is_cell_occupied(cell) && map_is_terrain_passable(cell->terrain)) {
+    for (int y = 0; y < map->height; y++) {
+        for (int x = 0; x < map->width; x++) {
+            int cell = map_get_cell(map, x, y);
+            if (is_valid_spawn_cell(map, cell)) {
                 return cell;
             }
         }
@@ -176,24 +343,27 @@ Point * map_get_random_corner_spawn_cell(Point* mapArr, GridConfig* grid_config,
 
     // If we still didn't find anything (extremely unlikely), return (0,0)
     fprintf(stderr, "Warning: No valid spawn cell found; returning (0,0)\n");
-    return map_get_cell(mapArr, grid_config, 0, 0);
+    return map_get_cell(map, 0, 0);
 }
 
-bool map_all_8_neighs_terrain(Point * mapArr, GridConfig* grid, Point * cell, Terrain terrain) {
-    int cell_x = cell->x;
-    int cell_y = cell->y;
-    Terrain cell_terrain = cell->terrain;
+bool map_all_8_neighs_terrain(Map *map, int cell) {
+    int cell_x = map_cell_x(map, cell);
+    int cell_y = map_cell_y(map, cell);
+    int cell_terrain = map->terrain[cell];
+    int deep_terrain = map->terrains[cell_terrain].deep_version;
+
+    // deep version is none
+    if (deep_terrain == TERRAIN_NONE) {
+        return false;
+    }
 
     // wtf was this why couldnt i declare it with a star
     int offset[3] = {-1, 0, 1};
     for (int l = 0; l < 3; l++) {
         for (int k = 0; k < 3; k++) {
-            Point * neigh = map_get_cell(mapArr, grid, cell_x + offset[k], cell_y + offset[l]);
-            if (neigh != NULL && neigh->terrain.id != cell_terrain.id && neigh->terrain.id != cell->terrain.deep_version->id) {
-                return false;
-            }
-            // deep version is none
-            if (cell->terrain.deep_version->id == -1) {
+            int neigh = map_get_cell(map, cell_x + offset[k], cell_y + offset[l]);
+            if (neigh != MAP_NO_CELL && map->terrain[neigh] != cell_terrain &&
+                map->terrain[neigh] != deep_terrain) {
                 return false;
             }
         }
@@ -203,176 +373,337 @@ bool map_all_8_neighs_terrain(Point * mapArr, GridConfig* grid, Point * cell, Te
 }
 
 // ============================================================================
-// Range Calculations
+// Chunk Layout
 // ============================================================================
 
-void map_calculate_movement_range(GridConfig *grid_config, Point *map,
-                                   Point *start_cell, int range, bool enable) {
-    // Don't calculate range if starting from impassable terrain (e.g., sea)
-    if (!map_is_terrain_passable(start_cell->terrain)) {
-        return;
+void map_get_chunk_bounds(Map *map, int chunk, int *out_x, int *out_y, int *out_w, int *out_h) {
+    int x = (chunk % map->chunks_x) << MAP_CHUNK_SHIFT;
+    int y = (chunk / map->chunks_x) << MAP_CHUNK_SHIFT;
+    *out_x = x;
+    *out_y = y;
+    *out_w = (x + MAP_CHUNK_SIZE > map->width) ? map->width - x : MAP_CHUNK_SIZE;
+    *out_h = (y + MAP_CHUNK_SIZE > map->height) ? map->height - y : MAP_CHUNK_SIZE;
+}
+
+void map_refresh_chunk(Map *map, int chunk) {
+    int x0, y0, w, h;
+    map_get_chunk_bounds(map, chunk, &x0, &y0, &w, &h);
+    int base = chunk * MAP_CHUNK_CELLS;
+    for (int ly = 0; ly < h; ly++) {
+        for (int lx = 0; lx < w; lx++) {
+            refresh_passability(map, base + (ly << MAP_CHUNK_SHIFT) + lx);
+        }
     }
-    
-    // The recursive range calculation treats occupied cells as blockers.
-    // Temporarily clear the starting cell's occupant so the unit's own tile
-    // doesn't block range generation.
-    Actor *saved_occupant = start_cell->occupant;
-    start_cell->occupant = NULL;
-    calculate_range_recursive(grid_config, map, start_cell, range, enable, false);
-    start_cell->occupant = saved_occupant;
+    map->terrain_stale[chunk] = true;
+}
+
+// ============================================================================
+// Per-cell Field Accessors
+// ============================================================================
+
+Terrain *map_get_terrain(Map *map, int cell) {
+    return &map->terrains[map->terrain[cell]];
+}
+
+int map_get_terrain_type(Map *map, int cell) {
+    return map->terrain[cell];
+}
+
+void map_set_terrain(Map *map, int cell, int terrain_type) {
+    map->terrain[cell] = (uint8_t)terrain_type;
+    map->terrain_stale[cell / MAP_CHUNK_CELLS] = true;
+    refresh_passability(map, cell);
+}
+
+Actor *map_get_occupant(Map *map, int cell) {
+    uint16_t handle = map->occupant[cell];
+    return (handle != 0) ? map->actors[handle - 1] : NULL;
 }
 
-void map_calculate_attack_range(GridConfig *grid_config, Point *map,
-                                Point *start_cell, int range, bool enable) {
-    calculate_range_recursive(grid_config, map, start_cell, range, enable, true);
+Actor *map_get_actor(Map *map, int handle) {
+    return (handle > 0 && handle <= map->actor_count) ? map->actors[handle - 1] : NULL;
 }
 
-void map_clear_range_flags(Point *map, GridConfig *grid_config) {
-    int total_cells = grid_config->max_grid_cells_x * grid_config->max_grid_cells_y;
-    
-    for (int i = 0; i < total_cells; i++) {
-        map[i].in_range = false;
-        map[i].in_attack_range = false;
+// ============================================================================
+// State Hash
+// ============================================================================
+
+uint64_t map_hash(Map *map) {
+    uint64_t hash = map->hash;
+    for (int chunk = 0; chunk < map->chunk_count; chunk++) {
+        if (map->terrain_stale[chunk]) {
+            map->terrain_hash[chunk] = chunk_terrain_hash(map, chunk);
+            map->terrain_stale[chunk] = false;
+        }
+        hash ^= map->terrain_hash[chunk];
     }
+    return hash;
 }
 
 // ============================================================================
-// Terrain Generation
+// Actor Placement
 // ============================================================================
 
-void map_spread_terrain(GridConfig *grid_config, Point *map,
-                       Point *start_cell, int range, Terrain terrain) {
-    // Set current cell's terrain
-    start_cell->terrain = terrain;
-    
-    // Base case: stop spreading
-    if (range == 0) {
-        return;
+bool map_move_actor(Map *map, Actor *actor, int dest_cell) {
+    if (actor == NULL || dest_cell == MAP_NO_CELL) return false;
+    if (actor->cell == dest_cell) return true;
+    if (map_is_cell_occupied(map, dest_cell)) return false;
+
+    if (actor->cell != MAP_NO_CELL) {
+        set_occupant(map, actor->cell, NULL);
     }
-    
-    int x = start_cell->x;
-    int y = start_cell->y;
-    
-    // Spread to adjacent cells (up, down, left, right)
-    Point *neighbor;
-    
-    // Up
-    if ((neighbor = map_get_cell(map, grid_config, x, y - 1)) != NULL) {
-        map_spread_terrain(grid_config, map, neighbor, range - 1, terrain);
+    set_occupant(map, dest_cell, actor);
+    actor->cell = dest_cell;
+    return true;
+}
+
+void map_remove_actor(Map *map, Actor *actor) {
+    if (actor == NULL || actor->cell == MAP_NO_CELL) return;
+    set_occupant(map, actor->cell, NULL);
+    actor->cell = MAP_NO_CELL;
+}
+
+// ============================================================================
+// Range Layers
+// ============================================================================
+
+bool map_is_in_range(Map *map, int cell) {
+    return bitboard_test(map->range_layer, map_cell_x(map, cell), map_cell_y(map, cell));
+}
+
+bool map_is_in_attack_range(Map *map, int cell) {
+    return bitboard_test(map->attack_layer, map_cell_x(map, cell), map_cell_y(map, cell));
+}
+
+// ============================================================================
+// Range Calculations
+// ============================================================================
+
+void map_calculate_movement_range(Map *map, int start_cell, int range, bool enable) {
+    // Don't calculate range if starting from impassable terrain (e.g., sea)
+    if (!map_is_terrain_passable(map_get_terrain(map, start_cell))) {
+        return;
     }
-    
-    // Down
-    if ((neighbor = map_get_cell(map, grid_config, x, y + 1)) != NULL) {
-        map_spread_terrain(grid_config, map, neighbor, range - 1, terrain);
+
+    // The search always expands from its origin, so the unit's own tile
+    // never blocks range generation.
+    apply_range_flags(map, start_cell, range, enable, REACH_MOVEMENT);
+}
+
+void map_calculate_attack_range(Map *map, int start_cell, int range, bool enable) {
+    apply_range_flags(map, start_cell, range, enable, REACH_ATTACK);
+}
+
+void map_clear_range_flags(Map *map) {
+    // Only the selection's layers are touched
+    bitboard_clear(map->range_layer);
+    bitboard_clear(map->attack_layer);
+    bitboard_clear(map->strike_layer);
+    bitboard_clear(map->target_layer);
+}
+
+int map_calculate_strike_targets(Map *map, int start_cell, int attack_range, int faction_id) {
+    Bitboard *zone = map->strike_layer;
+    Bitboard *scratch = map->target_layer;
+
+    // Every cell the unit can stop on, then one dilation per range step.
+    // Attacks ignore terrain, so each step is a plain four-way grow.
+    bitboard_copy(zone, map->range_layer);
+    bitboard_set(zone, map_cell_x(map, start_cell), map_cell_y(map, start_cell));
+    for (int step = 0; step < attack_range; step++) {
+        bitboard_dilate(scratch, zone);
+        bitboard_copy(zone, scratch);
     }
-    
-    // Left
-    if ((neighbor = map_get_cell(map, grid_config, x - 1, y)) != NULL) {
-        map_spread_terrain(grid_config, map, neighbor, range - 1, terrain);
+
+    bitboard_clear(scratch);
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        if (f == faction_id) continue;
+        bitboard_or(scratch, scratch, map->occupancy_layer[f]);
     }
-    
-    // Right
-    if ((neighbor = map_get_cell(map, grid_config, x + 1, y)) != NULL) {
-        map_spread_terrain(grid_config, map, neighbor, range - 1, terrain);
+    bitboard_and(map->target_layer, scratch, zone);
+    return bitboard_count(map->target_layer);
+}
+
+// ============================================================================
+// Terrain Generation
+// ============================================================================
+
+void map_spread_terrain(Map *map, int start_cell, int range, int terrain_type) {
+    // Paints every cell within Manhattan distance `range`, clipped to the map.
+    // The map is a rectangle, so this is exactly the set the old four-way flood
+    // reached, but each cell is written once instead of ~4^range times.
+    int x = map_cell_x(map, start_cell);
+    int y = map_cell_y(map, start_cell);
+
+    int min_y = (y - range < 0) ? 0 : y - range;
+    int max_y = (y + range >= map->height) ? map->height - 1 : y + range;
+
+    for (int row = min_y; row <= max_y; row++) {
+        int span = range - abs(row - y);
+        int min_x = (x - span < 0) ? 0 : x - span;
+        int max_x = (x + span >= map->width) ? map->width - 1 : x + span;
+
+        // Split the span at chunk edges; inside a chunk the row is contiguous
+        for (int col = min_x; col <= max_x; ) {
+            int chunk_end = (col | (MAP_CHUNK_SIZE - 1));
+            int seg_end = (chunk_end < max_x) ? chunk_end : max_x;
+            int first = map_get_cell(map, col, row);
+            for (int k = 0; k <= seg_end - col; k++) {
+                map_set_terrain(map, first + k, terrain_type);
+            }
+            col = seg_end + 1;
+        }
     }
 }
 
-void map_generate_biome_cores(GridConfig *grid_config, Point *map,
-                              BiomeConfig config) {
+void map_generate_biome_cores(Map *map, Rng *rng, BiomeConfig config) {
     // Generate random number of cores (0 to max_cores)
-    int num_cores = rand() % (config.max_cores + 1);
-    
+    int num_cores = rng_range(rng, config.max_cores + 1);
+
     for (int i = 0; i < num_cores; i++) {
-        Point *core = map_get_random_cell(map, grid_config);
-        int range = (rand() % config.max_range) + 1;
-        map_spread_terrain(grid_config, map, core, range, config.terrain);
+        int core = map_get_random_cell(map, rng);
+        int range = rng_range(rng, config.max_range) + 1;
+        map_spread_terrain(map, core, range, config.terrain);
     }
 }
 
-void map_generate_all_biomes(GridConfig *grid_config, Point *map,
-                             BiomeConfig *biome_configs, int num_biomes, int layers) {
+void map_generate_all_biomes(Map *map, Rng *rng, BiomeConfig *biome_configs, int num_biomes, int layers) {
     for (int layer = 0; layer < layers; layer++) {
         for (int i = 0; i < num_biomes; i++) {
-            map_generate_biome_cores(grid_config, map, biome_configs[i]);
+            map_generate_biome_cores(map, rng, biome_configs[i]);
         }
     }
 
 }
 
-void map_generate_deep_ter(Point *map, GridConfig * grid) {
-    for (int i = 0; i < grid->max_grid_cells_x*grid->max_grid_cells_y; i++) {
-        Point* cell = map + i;
-        if (map_all_8_neighs_terrain(map, grid, cell, cell->terrain)) {
-        cell->terrain = *(cell->terrain.deep_version);
-        }
-    }
-    return;
+void map_generate_deep_ter(Map *map) {
+    map_generate_deep_ter_threads(map, 0);
 }
 
-void map_generate_bases (Point* map, GridConfig* grid) {
+void map_generate_deep_ter_threads(Map *map, int threads) {
+    // Same rule as map_all_8_neighs_terrain, evaluated on a snapshot so the
+    // result does not depend on scan order. Off-map neighbours always match.
+    DeepTerrainPass pass;
+    pass.map = map;
+    pass.grid = padded_grid_create(map->width, map->height);
+    pass.mask = malloc(sizeof(uint8_t) * map->width * map->height);
+    if (pass.grid == NULL || pass.mask == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for deep terrain pass\n");
+        padded_grid_free(pass.grid);
+        free(pass.mask);
+        return;
+    }
+
+    memset(pass.deep, 0, sizeof(pass.deep));
+    for (int t = 0; t < TERRAIN_COUNT; t++) {
+        pass.deep[t] = (uint8_t)map->terrains[t].deep_version;
+    }
+
+    // Gather chunk rows into the row-major snapshot, then run the kernel and
+    // apply the mask. Each task owns one row of chunks, so tasks never share
+    // a snapshot row or a bitboard word; the kernel stage only starts once
+    // the whole snapshot is filled.
+    padded_grid_fill_border(pass.grid, MAP_TERRAIN_WILDCARD);
+    parallel_for(map->chunks_y, threads, deep_gather_band, &pass);
+    parallel_for(map->chunks_y, threads, deep_apply_band, &pass);
 
+    padded_grid_free(pass.grid);
+    free(pass.mask);
 }
 
 // ============================================================================
 // Terrain Queries
 // ============================================================================
 
-bool map_is_terrain_passable(Terrain terrain) {
+bool map_is_terrain_passable(Terrain *terrain) {
     // Sea (id == 2) is not passable for ground units
     // You can expand this with more terrain rules
-    return terrain.passable;
+    return terrain->passable;
 }
 
-bool map_is_cell_occupied(Point *cell) {
-    return cell->occupant != NULL;
+int map_get_move_cost(Map *map, int cell) {
+    // Every step costs at least one point so the search always terminates
+    int cost = map_get_terrain(map, cell)->move_cost;
+    return (cost > 0) ? cost : 1;
 }
 
-bool map_can_unit_enter_cell(Point *cell, Actor *unit) {
+bool map_is_cell_occupied(Map *map, int cell) {
+    return map->occupant[cell] != 0;
+}
+
+bool map_can_unit_enter_cell(Map *map, int cell, Actor *unit) {
+    (void)unit;
+
     // Check if cell is already occupied
-    if (map_is_cell_occupied(cell)) {
+    if (map_is_cell_occupied(map, cell)) {
         return false;
     }
-    
-    // Check if terrain is passable
+
+    // Terrain and blocking structures are folded into the passability layer
     // (In the future, you might check unit->can_fly or unit->movement_type here)
-    if (!map_is_terrain_passable(cell->terrain)) {
-        return false;
-    }
+    return bitboard_test(map->passable_layer, map_cell_x(map, cell), map_cell_y(map, cell));
+}
 
-    // Check if a structure blocks entry
-    if (cell->structure != NULL && !cell->structure->passable) {
-        return false;
+// ============================================================================
+// Change Journal
+// ============================================================================
+
+uint64_t map_change_count(Map *map) {
+    return map->change_count;
+}
+
+int map_get_change(Map *map, uint64_t index) {
+    if (index >= map->change_count || map->change_count - index > MAP_CHANGE_LOG_SIZE) {
+        return MAP_NO_CELL;
     }
-    
-    return true;
+    return map->change_log[index % MAP_CHANGE_LOG_SIZE];
 }
 
 // ============================================================================
 // Structure placement
 // ============================================================================
 
-bool map_place_structure(Point *map, GridConfig *grid_config, int x, int y, Structure *s) {
-    if (!map_is_valid_coords(grid_config, x, y)) return false;
-    Point *cell = map_get_cell(map, grid_config, x, y);
-    if (!cell) return false;
-    cell->structure = s;
+bool map_place_structure(Map *map, int x, int y, Structure *s) {
+    int cell = map_get_cell(map, x, y);
+    if (cell == MAP_NO_CELL) return false;
+    int handle = register_structure(map, s);
+    if (handle == 0) return false;
+    if (map->structure[cell] != 0) {
+        map->hash ^= zobrist_key(ZOBRIST_STRUCTURE, (uint32_t)cell, map->structure[cell]);
+    }
+    map->structure[cell] = (uint16_t)handle;
+    s->cell = cell;
+    map->hash ^= zobrist_key(ZOBRIST_STRUCTURE, (uint32_t)cell, (uint32_t)handle);
+    refresh_passability(map, cell);
+    record_change(map, cell);
     return true;
 }
 
-Structure *map_remove_structure(Point *map, GridConfig *grid_config, int x, int y) {
-    if (!map_is_valid_coords(grid_config, x, y)) return NULL;
-    Point *cell = map_get_cell(map, grid_config, x, y);
-    if (!cell) return NULL;
-    Structure *old = cell->structure;
-    cell->structure = NULL;
+Structure *map_remove_structure(Map *map, int x, int y) {
+    int cell = map_get_cell(map, x, y);
+    if (cell == MAP_NO_CELL) return NULL;
+    Structure *old = map_get_structure(map, cell);
+    if (old != NULL) {
+        // Ownership goes back to the caller
+        map->structures[map->structure[cell] - 1] = NULL;
+        old->cell = MAP_NO_CELL;
+        map->hash ^= zobrist_key(ZOBRIST_STRUCTURE, (uint32_t)cell, map->structure[cell]);
+        map->structure[cell] = 0;
+        refresh_passability(map, cell);
+        record_change(map, cell);
+    }
     return old;
 }
 
-Structure *map_get_structure_at(Point *map, GridConfig *grid_config, int x, int y) {
-    if (!map_is_valid_coords(grid_config, x, y)) return NULL;
-    Point *cell = map_get_cell(map, grid_config, x, y);
-    if (!cell) return NULL;
-    return cell->structure;
+Structure *map_get_structure_at(Map *map, int x, int y) {
+    int cell = map_get_cell(map, x, y);
+    if (cell == MAP_NO_CELL) return NULL;
+    return map_get_structure(map, cell);
+}
+
+Structure *map_get_structure(Map *map, int cell) {
+    uint16_t handle = map->structure[cell];
+    return (handle != 0) ? map->structures[handle - 1] : NULL;
 }
 
 
@@ -380,62 +711,162 @@ Structure *map_get_structure_at(Point *map, GridConfig *grid_config, int x, int
 // Internal Helper Functions
 // ============================================================================
 
-static void calculate_range_recursive(GridConfig *grid_config, Point *map,
-                                      Point *current_cell, int remaining_range,
-                                      bool enable, bool is_attack_range) {
-
-    // Movement range can't traverse impassable terrain, occupied cells, or blocking structures.
-    if (!is_attack_range) {
-        if (!map_is_terrain_passable(current_cell->terrain)) {
-            return;
+static void deep_gather_band(void *ctx, int chunk_row) {
+    DeepTerrainPass *pass = ctx;
+    Map *map = pass->map;
+    for (int cx = 0; cx < map->chunks_x; cx++) {
+        int chunk = chunk_row * map->chunks_x + cx;
+        int x0, y0, w, h;
+        map_get_chunk_bounds(map, chunk, &x0, &y0, &w, &h);
+        const uint8_t *base = map->terrain + (size_t)chunk * MAP_CHUNK_CELLS;
+        for (int ly = 0; ly < h; ly++) {
+            padded_grid_store(pass->grid, x0, y0 + ly, base + (ly << MAP_CHUNK_SHIFT), w);
         }
-        if (current_cell->structure != NULL && !current_cell->structure->passable) {
-            return;
-        }
-        if (map_is_cell_occupied(current_cell)) {
-            return;
+    }
+}
+
+static void deep_apply_band(void *ctx, int chunk_row) {
+    DeepTerrainPass *pass = ctx;
+    Map *map = pass->map;
+    int band_y0 = chunk_row * MAP_CHUNK_SIZE;
+    int band_y1 = (band_y0 + MAP_CHUNK_SIZE < map->height) ? band_y0 + MAP_CHUNK_SIZE : map->height;
+    uint8_t *band_mask = pass->mask + (size_t)band_y0 * map->width;
+    grid_kernel_uniform3x3_rows(pass->grid, pass->deep, MAP_TERRAIN_WILDCARD,
+                                band_y0, band_y1, band_mask);
+
+    for (int cx = 0; cx < map->chunks_x; cx++) {
+        int chunk = chunk_row * map->chunks_x + cx;
+        int x0, y0, w, h;
+        map_get_chunk_bounds(map, chunk, &x0, &y0, &w, &h);
+        int base = chunk * MAP_CHUNK_CELLS;
+        for (int ly = 0; ly < h; ly++) {
+            const uint8_t *mask_row = pass->mask + (size_t)(y0 + ly) * map->width + x0;
+            for (int lx = 0; lx < w; lx++) {
+                int cell = base + (ly << MAP_CHUNK_SHIFT) + lx;
+                uint8_t deep_terrain = pass->deep[map->terrain[cell]];
+                if (mask_row[lx] && deep_terrain != TERRAIN_NONE) {
+                    map_set_terrain(map, cell, deep_terrain);
+                }
+            }
         }
     }
+}
 
-    // Set the appropriate flag for this cell
-    if (is_attack_range) {
-        current_cell->in_attack_range = enable;
-    } else {
-        current_cell->in_range = enable;
+static void apply_range_flags(Map *map, int start_cell, int range, bool enable, ReachMode mode) {
+    Bitboard *layer = (mode == REACH_ATTACK) ? map->attack_layer : map->range_layer;
+
+    PROFILE_BEGIN("range_search");
+    int count = reachability_compute(map->reach, map, start_cell, range, mode);
+    for (int i = 0; i < count; i++) {
+        int cell = map->reach->reached[i];
+        bitboard_assign(layer, map_cell_x(map, cell), map_cell_y(map, cell), enable);
+    }
+    PROFILE_COUNTER("cells_visited", count);
+    PROFILE_END();
+}
+
+static void set_occupant(Map *map, int cell, Actor *actor) {
+    int x = map_cell_x(map, cell);
+    int y = map_cell_y(map, cell);
+    record_change(map, cell);
+
+    Actor *previous = map_get_occupant(map, cell);
+    if (previous != NULL) {
+        bitboard_reset(map->occupancy_layer[previous->owner->id], x, y);
+        spatial_index_remove(map->spatial, x, y, previous->owner->id);
+        map->hash ^= zobrist_key(ZOBRIST_OCCUPANT, (uint32_t)cell, map->occupant[cell]);
     }
-    
-    // Base case: no more range to spread
-    if (remaining_range == 0) {
+
+    if (actor == NULL) {
+        map->occupant[cell] = 0;
         return;
     }
-    
-    int x = current_cell->x;
-    int y = current_cell->y;
-    
-    // Recursively calculate range for all adjacent cells
-    Point *neighbor;
-    
-    // Up
-    if ((neighbor = map_get_cell(map, grid_config, x, y - 1)) != NULL) {
-        calculate_range_recursive(grid_config, map, neighbor, 
-                                 remaining_range - 1, enable, is_attack_range);
-    }
-    
-    // Down
-    if ((neighbor = map_get_cell(map, grid_config, x, y + 1)) != NULL) {
-        calculate_range_recursive(grid_config, map, neighbor, 
-                                 remaining_range - 1, enable, is_attack_range);
-    }
-    
-    // Left
-    if ((neighbor = map_get_cell(map, grid_config, x - 1, y)) != NULL) {
-        calculate_range_recursive(grid_config, map, neighbor, 
-                                 remaining_range - 1, enable, is_attack_range);
-    }
-    
-    // Right
-    if ((neighbor = map_get_cell(map, grid_config, x + 1, y)) != NULL) {
-        calculate_range_recursive(grid_config, map, neighbor, 
-                                 remaining_range - 1, enable, is_attack_range);
+    map->occupant[cell] = (uint16_t)register_actor(map, actor);
+    map->hash ^= zobrist_key(ZOBRIST_OCCUPANT, (uint32_t)cell, map->occupant[cell]);
+    bitboard_set(map->occupancy_layer[actor->owner->id], x, y);
+    spatial_index_add(map->spatial, x, y, actor->owner->id);
+}
+
+static int register_actor(Map *map, Actor *actor) {
+    // Already registered with this map
+    if (actor->id > 0 && actor->id <= map->actor_count && map->actors[actor->id - 1] == actor) {
+        return actor->id;
+    }
+
+    if (map->actor_count >= map->actor_capacity) {
+        if (map->actor_capacity >= MAP_MAX_HANDLES) {
+            fprintf(stderr, "Error: Map actor handle table is full\n");
+            return 0;
+        }
+        int new_capacity = (map->actor_capacity == 0) ? 64 : map->actor_capacity * 2;
+        if (new_capacity > MAP_MAX_HANDLES) new_capacity = MAP_MAX_HANDLES;
+        Actor **actors = realloc(map->actors, sizeof(Actor *) * new_capacity);
+        if (actors == NULL) {
+            fprintf(stderr, "Error: Failed to grow map actor table\n");
+            return 0;
+        }
+        map->actors = actors;
+        map->actor_capacity = new_capacity;
+    }
+
+    map->actors[map->actor_count++] = actor;
+    actor->id = map->actor_count;
+    actor_attach_hash(actor, &map->hash);
+    return actor->id;
+}
+
+static int register_structure(Map *map, Structure *s) {
+    if (s == NULL) return 0;
+
+    if (map->structure_count >= map->structure_capacity) {
+        if (map->structure_capacity >= MAP_MAX_HANDLES) {
+            fprintf(stderr, "Error: Map structure handle table is full\n");
+            return 0;
+        }
+        int new_capacity = (map->structure_capacity == 0) ? 16 : map->structure_capacity * 2;
+        if (new_capacity > MAP_MAX_HANDLES) new_capacity = MAP_MAX_HANDLES;
+        Structure **structures = realloc(map->structures, sizeof(Structure *) * new_capacity);
+        if (structures == NULL) {
+            fprintf(stderr, "Error: Failed to grow map structure table\n");
+            return 0;
+        }
+        map->structures = structures;
+        map->structure_capacity = new_capacity;
+    }
+
+    map->structures[map->structure_count++] = s;
+    return map->structure_count;
+}
+
+static void record_change(Map *map, int cell) {
+    map->change_log[map->change_count % MAP_CHANGE_LOG_SIZE] = cell;
+    map->change_count++;
+}
+
+// XOR of the terrain keys of the chunk's cells on the map
+static uint64_t chunk_terrain_hash(Map *map, int chunk) {
+    int x0, y0, w, h;
+    map_get_chunk_bounds(map, chunk, &x0, &y0, &w, &h);
+    int base = chunk * MAP_CHUNK_CELLS;
+    uint64_t hash = 0;
+    for (int ly = 0; ly < h; ly++) {
+        for (int lx = 0; lx < w; lx++) {
+            int cell = base + (ly << MAP_CHUNK_SHIFT) + lx;
+            hash ^= zobrist_key(ZOBRIST_TERRAIN, (uint32_t)cell, map->terrain[cell]);
+        }
     }
+    return hash;
+}
+
+// Passable means terrain and structure allow entry; occupancy is tracked separately
+static void refresh_passability(Map *map, int cell) {
+    Structure *structure = map_get_structure(map, cell);
+    bool passable = map_is_terrain_passable(map_get_terrain(map, cell)) &&
+                    (structure == NULL || structure->passable);
+    bitboard_assign(map->passable_layer, map_cell_x(map, cell), map_cell_y(map, cell), passable);
+}
+
+static bool is_valid_spawn_cell(Map *map, int cell) {
+    return cell != MAP_NO_CELL && !map_is_cell_occupied(map, cell) &&
+           map_is_terrain_passable(map_get_terrain(map, cell));
 }
@@ -2,45 +2,104 @@
 #define MAP_H_
 
 #include "types.h"
+#include "core/bitboard.h"
+#include "core/rng.h"
 #include <stdbool.h>
 
+// Sentinel for "no cell" (out of bounds, nothing selected, ...)
+#define MAP_NO_CELL (-1)
+
+// Cells are stored in MAP_CHUNK_SIZE x MAP_CHUNK_SIZE chunks, each a run of
+// MAP_CHUNK_CELLS consecutive slots in local row-major order. Edge chunks
+// of maps that are not a multiple of the chunk size have unused slots.
+#define MAP_CHUNK_SHIFT 5
+#define MAP_CHUNK_SIZE (1 << MAP_CHUNK_SHIFT)
+#define MAP_CHUNK_CELLS (MAP_CHUNK_SIZE * MAP_CHUNK_SIZE)
+
+// Largest width or height a map may have, from --map-size or a map file
+#define MAX_MAP_SIDE 4096
+
 // Map management functions
-Point *map_create(GridConfig *grid_config, Terrain default_terrain);
-void map_free(Point *map);
-void map_init_cells(Point *map, GridConfig *grid_config, Terrain default_terrain);
+Map *map_create(GridConfig *grid_config, Terrain *terrains, int default_terrain);
+void map_free(Map *map);
+void map_init_cells(Map *map, int default_terrain);
 
 // Cell access and utilities
-Point *map_get_cell(Point *map, GridConfig *grid_config, int x, int y);
-Point *map_get_random_cell(Point *map, GridConfig *grid_config);
-Point *map_get_random_spawn_cell(Point *map, GridConfig *grid_config);
-bool map_is_valid_coords(GridConfig *grid_config, int x, int y);
-Point * map_get_random_corner_cell(Point * mapArr, GridConfig * grid_config, int corner, int area_size);
-Point * map_get_random_corner_spawn_cell(Point* mapArr, GridConfig* grid_config, int corner, int area_size, int max_attempts);
-bool map_all_8_neighs_terrain(Point * mapArr, GridConfig* grid, Point * cell, Terrain terrain);
+int map_get_cell(Map *map, int x, int y);
+int map_cell_x(Map *map, int cell);
+int map_cell_y(Map *map, int cell);
+int map_get_random_cell(Map *map, Rng *rng);
+int map_get_random_spawn_cell(Map *map, Rng *rng);
+bool map_is_valid_coords(Map *map, int x, int y);
+int map_get_random_corner_cell(Map *map, Rng *rng, int corner, int area_size);
+int map_get_random_corner_spawn_cell(Map *map, Rng *rng, int corner, int area_size, int max_attempts);
+bool map_all_8_neighs_terrain(Map *map, int cell);
+bool map_is_valid_cell(Map *map, int cell);
+int map_get_neighbor(Map *map, int cell, int dx, int dy);
+
+// Chunk layout: chunk c owns slots [c * MAP_CHUNK_CELLS, (c + 1) * MAP_CHUNK_CELLS)
+void map_get_chunk_bounds(Map *map, int chunk, int *out_x, int *out_y, int *out_w, int *out_h);
+void map_refresh_chunk(Map *map, int chunk);
+
+// Per-cell field accessors
+Terrain *map_get_terrain(Map *map, int cell);
+int map_get_terrain_type(Map *map, int cell);
+void map_set_terrain(Map *map, int cell, int terrain_type);
+Actor *map_get_occupant(Map *map, int cell);
+Actor *map_get_actor(Map *map, int handle); // by occupant handle (Actor::id), NULL if unknown
+bool map_is_in_range(Map *map, int cell);
+bool map_is_in_attack_range(Map *map, int cell);
+
+
+// Actor placement: the only way occupants change, keeps Actor::cell in sync.
+// map_move_actor also places actors that are not on the map yet.
+bool map_move_actor(Map *map, Actor *actor, int dest_cell);
+void map_remove_actor(Map *map, Actor *actor);
+
+// Zobrist hash of terrain, occupants, structures and the hit points and
+// turn flags of every actor placed on the map so far. Occupant, structure
+// and actor changes update it with a couple of XORs through the map and
+// actor APIs. Terrain is repainted in bulk, by parallel generation bands,
+// so it is hashed per chunk instead: an edit marks its chunk, and the next
+// call rehashes marked chunks before folding one word per chunk.
+uint64_t map_hash(Map *map);
+
+// Change journal: every occupant or structure change appends its cell, so
+// caches built from the map can catch up on what changed since. Change i is
+// kept until change i + MAP_CHANGE_LOG_SIZE overwrites it. Terrain edits are
+// not journaled; they only happen while a map is generated or loaded.
+#define MAP_CHANGE_LOG_SIZE 4096
+uint64_t map_change_count(Map *map);
+int map_get_change(Map *map, uint64_t index); // MAP_NO_CELL once overwritten
 
 // Range and pathfinding calculations
-void map_calculate_movement_range(GridConfig *grid_config, Point *map, 
-                                   Point *start_cell, int range, bool enable);
-void map_calculate_attack_range(GridConfig *grid_config, Point *map, 
-                                Point *start_cell, int range, bool enable);
-void map_clear_range_flags(Point *map, GridConfig *grid_config);
+void map_calculate_movement_range(Map *map, int start_cell, int range, bool enable);
+void map_calculate_attack_range(Map *map, int start_cell, int range, bool enable);
+void map_clear_range_flags(Map *map);
+
+// Enemies a unit at start_cell can strike this turn: its movement range
+// (already in range_layer) plus start_cell, grown by attack_range one
+// word-shift step at a time, intersected with every other faction's
+// occupancy. Fills strike_layer and target_layer; returns the target count.
+int map_calculate_strike_targets(Map *map, int start_cell, int attack_range, int faction_id);
 
 // Terrain generation
-void map_spread_terrain(GridConfig *grid_config, Point *map, 
-                       Point *start_cell, int range, Terrain terrain);
-void map_generate_biome_cores(GridConfig *grid_config, Point *map, 
-                              BiomeConfig config);
-void map_generate_all_biomes(GridConfig *grid_config, Point *map, 
-                             BiomeConfig *biome_configs, int num_biomes, int layers);
-void map_generate_deep_ter(Point *map, GridConfig * grid);
+void map_spread_terrain(Map *map, int start_cell, int range, int terrain_type);
+void map_generate_biome_cores(Map *map, Rng *rng, BiomeConfig config);
+void map_generate_all_biomes(Map *map, Rng *rng, BiomeConfig *biome_configs, int num_biomes, int layers);
+void map_generate_deep_ter(Map *map);
+// threads <= 0 uses the default worker count; the result never depends on it
+void map_generate_deep_ter_threads(Map *map, int threads);
 
 // Terrain queries
-bool map_is_terrain_passable(Terrain terrain);
-bool map_is_cell_occupied(Point *cell);
-bool map_can_unit_enter_cell(Point *cell, Actor *unit);
+bool map_is_terrain_passable(Terrain *terrain);
+int map_get_move_cost(Map *map, int cell);
+bool map_is_cell_occupied(Map *map, int cell);
+bool map_can_unit_enter_cell(Map *map, int cell, Actor *unit);
 
 // Structure placement and queries
-bool map_place_structure(Point *map, GridConfig *grid_config, int x, int y, Structure *s);
-Structure *map_remove_structure(Point *map, GridConfig *grid_config, int x, int y);
-Structure *map_get_structure_at(Point *map, GridConfig *grid_config, int x, int y);
+bool map_place_structure(Map *map, int x, int y, Structure *s);
+Structure *map_remove_structure(Map *map, int x, int y);
+Structure *map_get_structure_at(Map *map, int x, int y);
+Structure *map_get_structure(Map *map, int cell);
 #endif
@@ -0,0 +1,347 @@
+#include "game/map_generation.h"
+#include "game/map.h"
+#include "core/parallel.h"
+#include "core/rng.h"
+#include "core/noise.h"
+#include "core/profiler.h"
+#include "game/terrain.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Noise backend shape: wavelength of the first octave (as a shift) and
+// octave count per field. Features keep their size on larger maps.
+#define NOISE_ELEVATION_SHIFT 4
+#define NOISE_ELEVATION_OCTAVES 3
+#define NOISE_MOISTURE_SHIFT 3
+#define NOISE_MOISTURE_OCTAVES 2
+
+// Terrain thresholds, in permille of each field's range
+#define NOISE_DEEP_SEA_LEVEL 270
+#define NOISE_SEA_LEVEL 330
+#define NOISE_HILL_LEVEL 620
+#define NOISE_MOUNTAIN_LEVEL 680
+#define NOISE_FOREST_LEVEL 580
+#define NOISE_DEEP_FOREST_LEVEL 680
+
+// One biome core, stored with the region (chunk) that rolled it
+typedef struct BiomeStamp {
+    int order;          // layer * num_biomes + biome: global paint order
+    uint16_t range;
+    uint8_t x, y;       // local to the region's chunk
+    uint8_t terrain;
+} BiomeStamp;
+
+// A stamp gathered by a painting task, sortable into global order
+typedef struct StampRef {
+    const BiomeStamp *stamp;
+    int region;
+    int index;
+} StampRef;
+
+// Shared state of the biome stage
+typedef struct BiomePass {
+    Map *map;
+    const MapGenSettings *settings;
+    BiomeStamp *stamps;   // region_capacity stamps per region
+    int *stamp_counts;
+    int region_capacity;
+    int reach;            // how many chunks away a stamp can paint
+} BiomePass;
+
+// Shared state of the noise backend
+typedef struct NoisePass {
+    Map *map;
+    NoiseLayer elevation;
+    NoiseLayer moisture;
+    int levels[6];      // the NOISE_*_LEVEL thresholds in raw field units
+} NoisePass;
+
+// Forward declarations for internal helper functions
+static int region_layers(Map *map, const MapGenSettings *settings, int region_cells);
+static void roll_region(void *ctx, int region);
+static void paint_band(void *ctx, int chunk_row);
+static int gather_stamps(BiomePass *pass, int chunk, StampRef *out);
+static void paint_stamp(Map *map, int chunk, int gx, int gy, int range, int terrain);
+static int compare_stamp_refs(const void *a, const void *b);
+static void noise_band(void *ctx, int chunk_row);
+static int noise_terrain(const int *levels, int elevation, int moisture);
+
+// ============================================================================
+// Pipeline
+// ============================================================================
+
+void map_generation_run(Map *map, const MapGenSettings *settings) {
+    PROFILE_BEGIN("map_generation");
+    if (settings->generator == MAP_GENERATOR_NOISE) {
+        PROFILE_BEGIN("noise_terrain");
+        map_generation_noise(map, settings);
+        PROFILE_END();
+    } else {
+        PROFILE_BEGIN("biomes");
+        map_generation_biomes(map, settings);
+        PROFILE_END();
+        PROFILE_BEGIN("deep_terrain");
+        map_generation_deep_terrain(map, settings);
+        PROFILE_END();
+    }
+    PROFILE_END();
+}
+
+void map_generation_biomes(Map *map, const MapGenSettings *settings) {
+    if (settings->num_biomes <= 0 || settings->layers <= 0) return;
+
+    // Chunk 0 is always the largest region, so it bounds every region's stamp count
+    int x0, y0, w, h;
+    map_get_chunk_bounds(map, 0, &x0, &y0, &w, &h);
+    int cores_per_layer = 0;
+    int max_range = 1;
+    for (int i = 0; i < settings->num_biomes; i++) {
+        cores_per_layer += settings->biomes[i].max_cores;
+        if (settings->biomes[i].max_range > max_range) max_range = settings->biomes[i].max_range;
+    }
+
+    BiomePass pass;
+    pass.map = map;
+    pass.settings = settings;
+    pass.region_capacity = region_layers(map, settings, w * h) * cores_per_layer;
+    pass.reach = (max_range + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+    if (pass.region_capacity == 0) return;
+
+    pass.stamps = malloc(sizeof(BiomeStamp) * (size_t)pass.region_capacity * map->chunk_count);
+    pass.stamp_counts = calloc(map->chunk_count, sizeof(int));
+    if (pass.stamps == NULL || pass.stamp_counts == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for biome stamps\n");
+        free(pass.stamps);
+        free(pass.stamp_counts);
+        return;
+    }
+
+    // Roll every region's cores, then paint each row of chunks with all the
+    // stamps that reach it. Seams need no extra pass: a chunk replays its
+    // neighbours' stamps too, in the same global order a single thread uses.
+    parallel_for(map->chunk_count, settings->threads, roll_region, &pass);
+    parallel_for(map->chunks_y, settings->threads, paint_band, &pass);
+
+    free(pass.stamps);
+    free(pass.stamp_counts);
+}
+
+void map_generation_deep_terrain(Map *map, const MapGenSettings *settings) {
+    map_generate_deep_ter_threads(map, settings->threads);
+}
+
+void map_generation_noise(Map *map, const MapGenSettings *settings) {
+    NoisePass *pass = malloc(sizeof(NoisePass));
+    if (pass == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for noise generation\n");
+        return;
+    }
+    pass->map = map;
+    noise_layer_init(&pass->elevation, rng_mix(settings->seed, 1),
+                     NOISE_ELEVATION_OCTAVES, NOISE_ELEVATION_SHIFT);
+    noise_layer_init(&pass->moisture, rng_mix(settings->seed, 2),
+                     NOISE_MOISTURE_OCTAVES, NOISE_MOISTURE_SHIFT);
+
+    int elevation_max = noise_layer_max(&pass->elevation);
+    int moisture_max = noise_layer_max(&pass->moisture);
+    pass->levels[0] = NOISE_DEEP_SEA_LEVEL * elevation_max / 1000;
+    pass->levels[1] = NOISE_SEA_LEVEL * elevation_max / 1000;
+    pass->levels[2] = NOISE_MOUNTAIN_LEVEL * elevation_max / 1000;
+    pass->levels[3] = NOISE_HILL_LEVEL * elevation_max / 1000;
+    pass->levels[4] = NOISE_DEEP_FOREST_LEVEL * moisture_max / 1000;
+    pass->levels[5] = NOISE_FOREST_LEVEL * moisture_max / 1000;
+
+    parallel_for(map->chunks_y, settings->threads, noise_band, pass);
+    free(pass);
+}
+
+bool map_generation_parse_generator(const char *name, MapGenerator *out) {
+    if (strcmp(name, "cores") == 0) {
+        *out = MAP_GENERATOR_CORES;
+    } else if (strcmp(name, "noise") == 0) {
+        *out = MAP_GENERATOR_NOISE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *map_generation_generator_name(MapGenerator generator) {
+    return (generator == MAP_GENERATOR_NOISE) ? "noise" : "cores";
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// The map's layer count, shared out by area (rounded up)
+static int region_layers(Map *map, const MapGenSettings *settings, int region_cells) {
+    long long map_cells = (long long)map->width * map->height;
+    return (int)(((long long)settings->layers * region_cells + map_cells - 1) / map_cells);
+}
+
+static void roll_region(void *ctx, int region) {
+    BiomePass *pass = ctx;
+    const MapGenSettings *settings = pass->settings;
+
+    int x0, y0, w, h;
+    map_get_chunk_bounds(pass->map, region, &x0, &y0, &w, &h);
+    int layers = region_layers(pass->map, settings, w * h);
+
+    Rng rng;
+    rng_seed(&rng, rng_mix(settings->seed, (uint64_t)region), RNG_STREAM_MAP);
+
+    BiomeStamp *stamps = pass->stamps + (size_t)region * pass->region_capacity;
+    int count = 0;
+    for (int layer = 0; layer < layers; layer++) {
+        for (int i = 0; i < settings->num_biomes; i++) {
+            const BiomeConfig *config = &settings->biomes[i];
+            int num_cores = rng_range(&rng, config->max_cores + 1);
+            for (int c = 0; c < num_cores; c++) {
+                BiomeStamp *stamp = &stamps[count++];
+                stamp->order = layer * settings->num_biomes + i;
+                stamp->x = (uint8_t)rng_range(&rng, w);
+                stamp->y = (uint8_t)rng_range(&rng, h);
+                stamp->range = (uint16_t)(rng_range(&rng, config->max_range) + 1);
+                stamp->terrain = (uint8_t)config->terrain;
+            }
+        }
+    }
+    pass->stamp_counts[region] = count;
+}
+
+// Paints one row of chunks. Rows of chunks cover whole map rows, so no two
+// tasks write the same cell or the same passability word.
+static void paint_band(void *ctx, int chunk_row) {
+    BiomePass *pass = ctx;
+    Map *map = pass->map;
+
+    int side = 2 * pass->reach + 1;
+    StampRef *refs = malloc(sizeof(StampRef) * (size_t)pass->region_capacity * side * side);
+    if (refs == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for biome painting\n");
+        return;
+    }
+
+    for (int cx = 0; cx < map->chunks_x; cx++) {
+        int chunk = chunk_row * map->chunks_x + cx;
+        int count = gather_stamps(pass, chunk, refs);
+        qsort(refs, count, sizeof(StampRef), compare_stamp_refs);
+
+        for (int i = 0; i < count; i++) {
+            const BiomeStamp *stamp = refs[i].stamp;
+            int rx, ry, rw, rh;
+            map_get_chunk_bounds(map, refs[i].region, &rx, &ry, &rw, &rh);
+            paint_stamp(map, chunk, rx + stamp->x, ry + stamp->y, stamp->range, stamp->terrain);
+        }
+    }
+    free(refs);
+}
+
+// Collects the stamps of nearby regions whose diamond overlaps the chunk
+static int gather_stamps(BiomePass *pass, int chunk, StampRef *out) {
+    Map *map = pass->map;
+    int x0, y0, w, h;
+    map_get_chunk_bounds(map, chunk, &x0, &y0, &w, &h);
+    int cx = chunk % map->chunks_x;
+    int cy = chunk / map->chunks_x;
+
+    int count = 0;
+    for (int ry = cy - pass->reach; ry <= cy + pass->reach; ry++) {
+        if (ry < 0 || ry >= map->chunks_y) continue;
+        for (int rx = cx - pass->reach; rx <= cx + pass->reach; rx++) {
+            if (rx < 0 || rx >= map->chunks_x) continue;
+
+            int region = ry * map->chunks_x + rx;
+            int ox, oy, ow, oh;
+            map_get_chunk_bounds(map, region, &ox, &oy, &ow, &oh);
+            const BiomeStamp *stamps = pass->stamps + (size_t)region * pass->region_capacity;
+
+            for (int i = 0; i < pass->stamp_counts[region]; i++) {
+                int gx = ox + stamps[i].x;
+                int gy = oy + stamps[i].y;
+                int dx = (gx < x0) ? x0 - gx : (gx >= x0 + w) ? gx - (x0 + w - 1) : 0;
+                int dy = (gy < y0) ? y0 - gy : (gy >= y0 + h) ? gy - (y0 + h - 1) : 0;
+                if (dx + dy > stamps[i].range) continue;
+
+                out[count].stamp = &stamps[i];
+                out[count].region = region;
+                out[count].index = i;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+// map_spread_terrain clipped to one chunk
+static void paint_stamp(Map *map, int chunk, int gx, int gy, int range, int terrain) {
+    int x0, y0, w, h;
+    map_get_chunk_bounds(map, chunk, &x0, &y0, &w, &h);
+    int base = chunk * MAP_CHUNK_CELLS;
+
+    int min_y = (gy - range < y0) ? y0 : gy - range;
+    int max_y = (gy + range >= y0 + h) ? y0 + h - 1 : gy + range;
+    for (int row = min_y; row <= max_y; row++) {
+        int span = range - abs(row - gy);
+        int min_x = (gx - span < x0) ? x0 : gx - span;
+        int max_x = (gx + span >= x0 + w) ? x0 + w - 1 : gx + span;
+        int first = base + ((row - y0) << MAP_CHUNK_SHIFT) - x0;
+        for (int col = min_x; col <= max_x; col++) {
+            map_set_terrain(map, first + col, terrain);
+        }
+    }
+}
+
+static int compare_stamp_refs(const void *a, const void *b) {
+    const StampRef *ra = a;
+    const StampRef *rb = b;
+    if (ra->stamp->order != rb->stamp->order) return (ra->stamp->order < rb->stamp->order) ? -1 : 1;
+    if (ra->region != rb->region) return (ra->region < rb->region) ? -1 : 1;
+    return (ra->index < rb->index) ? -1 : (ra->index > rb->index) ? 1 : 0;
+}
+
+// Fills one row of chunks, a map row at a time
+static void noise_band(void *ctx, int chunk_row) {
+    NoisePass *pass = ctx;
+    Map *map = pass->map;
+
+    int16_t *elevation = malloc(sizeof(int16_t) * noise_row_capacity(&pass->elevation, map->width));
+    int16_t *moisture = malloc(sizeof(int16_t) * noise_row_capacity(&pass->moisture, map->width));
+    if (elevation == NULL || moisture == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for noise rows\n");
+        free(elevation);
+        free(moisture);
+        return;
+    }
+
+    int y0 = chunk_row * MAP_CHUNK_SIZE;
+    int y1 = (y0 + MAP_CHUNK_SIZE < map->height) ? y0 + MAP_CHUNK_SIZE : map->height;
+    for (int y = y0; y < y1; y++) {
+        noise_fill_row(&pass->elevation, y, map->width, elevation);
+        noise_fill_row(&pass->moisture, y, map->width, moisture);
+
+        // Within a chunk the row is contiguous
+        for (int x0 = 0; x0 < map->width; x0 += MAP_CHUNK_SIZE) {
+            int x1 = (x0 + MAP_CHUNK_SIZE < map->width) ? x0 + MAP_CHUNK_SIZE : map->width;
+            int first = map_get_cell(map, x0, y) - x0;
+            for (int x = x0; x < x1; x++) {
+                map_set_terrain(map, first + x, noise_terrain(pass->levels, elevation[x], moisture[x]));
+            }
+        }
+    }
+    free(elevation);
+    free(moisture);
+}
+
+// Elevation decides water and high ground; moisture grows forests on the rest
+static int noise_terrain(const int *levels, int elevation, int moisture) {
+    if (elevation < levels[0]) return TERRAIN_DEEP_SEA;
+    if (elevation < levels[1]) return TERRAIN_SEA;
+    if (elevation > levels[2]) return TERRAIN_MOUNTAINS;
+    if (elevation > levels[3]) return TERRAIN_ARCTIC;
+    if (moisture > levels[4]) return TERRAIN_DEEP_FOREST;
+    if (moisture > levels[5]) return TERRAIN_FOREST;
+    return TERRAIN_PLAINS;
+}
@@ -0,0 +1,42 @@
+#ifndef MAP_GENERATION_H_
+#define MAP_GENERATION_H_
+
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Terrain backends
+typedef enum {
+    MAP_GENERATOR_CORES,        // random biome cores plus the deep terrain pass
+    MAP_GENERATOR_NOISE         // elevation and moisture noise mapped to terrain
+} MapGenerator;
+
+// Settings for the threaded generation pipeline
+typedef struct MapGenSettings {
+    MapGenerator generator;
+    uint64_t seed;              // match seed
+    const BiomeConfig *biomes;  // cores backend only
+    int num_biomes;
+    int layers;                 // biome layers over the whole map, as for map_generate_all_biomes
+    int threads;                // worker threads; <= 0 uses the default count
+} MapGenSettings;
+
+// Generates the map's terrain with the selected backend on worker threads.
+// The map depends only on the seed, the backend and the map size, never on
+// the thread count.
+void map_generation_run(Map *map, const MapGenSettings *settings);
+
+// Cores backend stages, for callers (and benchmarks) that run them separately.
+// Every chunk is a region with its own seed derived from the match seed.
+void map_generation_biomes(Map *map, const MapGenSettings *settings);
+void map_generation_deep_terrain(Map *map, const MapGenSettings *settings);
+
+// Noise backend: fills every cell from two fractal noise fields, one row of
+// chunks per task. Deep variants come straight from the thresholds.
+void map_generation_noise(Map *map, const MapGenSettings *settings);
+
+// "cores" / "noise"; returns false for unknown names
+bool map_generation_parse_generator(const char *name, MapGenerator *out);
+const char *map_generation_generator_name(MapGenerator generator);
+
+#endif
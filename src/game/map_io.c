@@ -0,0 +1,163 @@
+#include "game/map_io.h"
+#include "game/map.h"
+#include "game/terrain.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAP_IO_MAGIC "EIRM"
+#define MAP_IO_VERSION 1
+#define MAP_IO_HEADER_SIZE 20 // magic, version, width, height, chunk size
+
+// Forward declarations for internal helper functions
+static void put_u32(uint8_t *out, uint32_t value);
+static uint32_t get_u32(const uint8_t *in);
+static bool seek_chunk(FILE *file, int chunk);
+
+// ============================================================================
+// Whole Maps
+// ============================================================================
+
+bool map_io_save(Map *map, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open %s for writing\n", path);
+        return false;
+    }
+
+    bool ok = map_io_write_header(map, file);
+    for (int chunk = 0; ok && chunk < map->chunk_count; chunk++) {
+        ok = map_io_write_chunk(map, file, chunk);
+    }
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to save map to %s\n", path);
+    }
+    return ok;
+}
+
+Map *map_io_load(const char *path, Terrain *terrains) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open %s for reading\n", path);
+        return NULL;
+    }
+
+    int width, height;
+    if (!map_io_read_header(file, &width, &height)) {
+        fclose(file);
+        return NULL;
+    }
+
+    GridConfig grid = {0};
+    grid.max_grid_cells_x = width;
+    grid.max_grid_cells_y = height;
+    Map *map = map_create(&grid, terrains, TERRAIN_PLAINS);
+    if (map == NULL) {
+        fclose(file);
+        return NULL;
+    }
+
+    for (int chunk = 0; chunk < map->chunk_count; chunk++) {
+        if (!map_io_read_chunk(map, file, chunk)) {
+            fprintf(stderr, "Error: Failed to load map from %s\n", path);
+            map_free(map);
+            fclose(file);
+            return NULL;
+        }
+    }
+
+    fclose(file);
+    return map;
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+bool map_io_write_header(Map *map, FILE *file) {
+    uint8_t header[MAP_IO_HEADER_SIZE];
+    memcpy(header, MAP_IO_MAGIC, 4);
+    put_u32(header + 4, MAP_IO_VERSION);
+    put_u32(header + 8, (uint32_t)map->width);
+    put_u32(header + 12, (uint32_t)map->height);
+    put_u32(header + 16, MAP_CHUNK_SIZE);
+
+    if (fseek(file, 0, SEEK_SET) != 0) return false;
+    return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+bool map_io_read_header(FILE *file, int *out_width, int *out_height) {
+    uint8_t header[MAP_IO_HEADER_SIZE];
+    if (fseek(file, 0, SEEK_SET) != 0 || fread(header, 1, sizeof(header), file) != sizeof(header)) {
+        fprintf(stderr, "Error: Map file is truncated\n");
+        return false;
+    }
+    if (memcmp(header, MAP_IO_MAGIC, 4) != 0 || get_u32(header + 4) != MAP_IO_VERSION) {
+        fprintf(stderr, "Error: Not a supported map file\n");
+        return false;
+    }
+    if (get_u32(header + 16) != MAP_CHUNK_SIZE) {
+        fprintf(stderr, "Error: Map file uses chunk size %u, expected %d\n",
+                get_u32(header + 16), MAP_CHUNK_SIZE);
+        return false;
+    }
+
+    // Bounded before the int conversion so a corrupt size cannot overflow map_create
+    uint32_t width = get_u32(header + 8);
+    uint32_t height = get_u32(header + 12);
+    if (width == 0 || height == 0 || width > MAX_MAP_SIDE || height > MAX_MAP_SIDE) {
+        fprintf(stderr, "Error: Map file size %ux%u is outside 1..%d\n", width, height, MAX_MAP_SIDE);
+        return false;
+    }
+    *out_width = (int)width;
+    *out_height = (int)height;
+    return true;
+}
+
+bool map_io_write_chunk(Map *map, FILE *file, int chunk) {
+    if (chunk < 0 || chunk >= map->chunk_count || !seek_chunk(file, chunk)) return false;
+    const uint8_t *terrain = map->terrain + (size_t)chunk * MAP_CHUNK_CELLS;
+    return fwrite(terrain, 1, MAP_CHUNK_CELLS, file) == MAP_CHUNK_CELLS;
+}
+
+bool map_io_read_chunk(Map *map, FILE *file, int chunk) {
+    if (chunk < 0 || chunk >= map->chunk_count || !seek_chunk(file, chunk)) return false;
+
+    uint8_t record[MAP_CHUNK_CELLS];
+    if (fread(record, 1, MAP_CHUNK_CELLS, file) != MAP_CHUNK_CELLS) {
+        fprintf(stderr, "Error: Map chunk %d is truncated\n", chunk);
+        return false;
+    }
+    for (int i = 0; i < MAP_CHUNK_CELLS; i++) {
+        if (record[i] >= TERRAIN_COUNT) {
+            fprintf(stderr, "Error: Map chunk %d has invalid terrain %d\n", chunk, record[i]);
+            return false;
+        }
+    }
+
+    memcpy(map->terrain + (size_t)chunk * MAP_CHUNK_CELLS, record, MAP_CHUNK_CELLS);
+    map_refresh_chunk(map, chunk);
+    return true;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Fixed little-endian layout so files move between platforms
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static bool seek_chunk(FILE *file, int chunk) {
+    long offset = MAP_IO_HEADER_SIZE + (long)chunk * MAP_CHUNK_CELLS;
+    return fseek(file, offset, SEEK_SET) == 0;
+}
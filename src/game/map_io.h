@@ -0,0 +1,22 @@
+#ifndef MAP_IO_H_
+#define MAP_IO_H_
+
+#include "types.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// Terrain files are a small header followed by one fixed-size record per
+// chunk in chunk order, so single chunks can be read or rewritten in place.
+// Only terrain is stored; units and structures belong to the match.
+
+// Whole maps
+bool map_io_save(Map *map, const char *path);
+Map *map_io_load(const char *path, Terrain *terrains);
+
+// Streaming: `file` must hold a header matching the map's size
+bool map_io_write_header(Map *map, FILE *file);
+bool map_io_read_header(FILE *file, int *out_width, int *out_height);
+bool map_io_write_chunk(Map *map, FILE *file, int chunk);
+bool map_io_read_chunk(Map *map, FILE *file, int chunk);
+
+#endif
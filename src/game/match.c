@@ -0,0 +1,176 @@
+#include "game/match.h"
+#include "game/map.h"
+#include "game/map_io.h"
+#include "game/actor.h"
+#include "game/biome_config.h"
+#include "game/faction_init.h"
+#include "game/spawning.h"
+#include "game/structure_generation.h"
+#include "core/rng.h"
+#include "core/profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Forward declarations for internal helper functions
+static Map *create_map(Match *match, const MatchSettings *settings);
+static bool create_troops(Match *match, int troops);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+void match_settings_default(MatchSettings *settings) {
+    settings->map_width = MATCH_DEFAULT_MAP_WIDTH;
+    settings->map_height = MATCH_DEFAULT_MAP_HEIGHT;
+    settings->load_map_path = NULL;
+    settings->seed = 0;
+    settings->generator = MAP_GENERATOR_CORES;
+    settings->threads = 0;
+    settings->troops = MATCH_DEFAULT_TROOPS;
+    settings->ai_mode = AI_MODE_GREEDY;
+    settings->ai_faction = -1;
+    game_ai_search_defaults(&settings->ai_search);
+}
+
+Match *match_create(const MatchSettings *settings) {
+    Match *match = calloc(1, sizeof(Match));
+    if (match == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for match\n");
+        return NULL;
+    }
+
+    // One stream per subsystem, so e.g. a new spawn roll never changes the map.
+    // Map generation derives its own per-region streams from the seed.
+    Rng structure_rng, spawn_rng;
+    rng_seed(&structure_rng, settings->seed, RNG_STREAM_STRUCTURES);
+    rng_seed(&spawn_rng, settings->seed, RNG_STREAM_SPAWNING);
+
+    PROFILE_BEGIN("terrain_init");
+    terrain_init_all(match->terrains);
+    PROFILE_END();
+    match->map = create_map(match, settings);
+    if (match->map == NULL) {
+        match_free(match);
+        return NULL;
+    }
+
+    match->num_factions = faction_init_default(match->factions, MATCH_FACTIONS);
+    if (!create_troops(match, settings->troops)) {
+        match_free(match);
+        return NULL;
+    }
+
+    // Place faction troops into their corners
+    spawning_place_faction_in_corner(match->map, &spawn_rng, &match->factions[DARKUS], 0, 4, 16);
+    spawning_place_faction_in_corner(match->map, &spawn_rng, &match->factions[VENTUS], 2, 4, 16);
+
+    // Place Warg Lairs first, then spawn Gaia wargs around those lairs
+    int lairs = structure_generation_place_warg_lairs(match->map, &structure_rng);
+    if (lairs > 0) {
+        int gaia_warg_count = 0;
+        Actor *gaia_wargs = structure_generation_spawn_wargs_around_lairs(match->map, &structure_rng,
+                                                                          &match->factions[GAIA],
+                                                                          &gaia_warg_count);
+        if (gaia_wargs != NULL && gaia_warg_count > 0) {
+            match->factions[GAIA].actors = gaia_wargs;
+            match->factions[GAIA].actor_count = gaia_warg_count;
+        } else {
+            free(gaia_wargs);
+        }
+    }
+
+    match->state = game_state_create(match->factions, match->num_factions, settings->seed);
+    if (match->state == NULL) {
+        match_free(match);
+        return NULL;
+    }
+    for (int i = 0; i < match->num_factions; i++) {
+        if (settings->ai_faction == -1 || settings->ai_faction == i) {
+            match->state->ai_mode[i] = settings->ai_mode;
+        }
+    }
+    match->state->ai_search = settings->ai_search;
+    return match;
+}
+
+void match_free(Match *match) {
+    if (match == NULL) return;
+    map_free(match->map);
+    factions_free_actors(match->factions, match->num_factions);
+    game_state_free(match->state);
+    free(match);
+}
+
+// ============================================================================
+// AI Matches
+// ============================================================================
+
+void match_set_all_ai(Match *match) {
+    for (int i = 0; i < match->num_factions; i++) {
+        match->factions[i].playable = false;
+    }
+    // The first faction already holds the turn; re-enter it as an AI turn
+    game_start_faction_turn(match->state);
+}
+
+Faction *match_play_ai(Match *match, int turn_cap) {
+    GameState *state = match->state;
+    while (!game_is_over(state) && state->turn_number <= turn_cap) {
+        if (!game_is_ai_turn(state)) break; // a player faction would wait forever
+        game_process_ai_turn(state, match->map);
+    }
+    return game_is_over(state) ? state->winner : NULL;
+}
+
+int match_turns_played(const Match *match, int turn_cap) {
+    int turns = match->state->turn_number;
+    return (turns > turn_cap) ? turn_cap : turns;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// A saved terrain file or a freshly generated map
+static Map *create_map(Match *match, const MatchSettings *settings) {
+    if (settings->load_map_path != NULL) {
+        return map_io_load(settings->load_map_path, match->terrains);
+    }
+
+    GridConfig size = {0};
+    size.max_grid_cells_x = settings->map_width;
+    size.max_grid_cells_y = settings->map_height;
+    Map *map = map_create(&size, match->terrains, TERRAIN_PLAINS);
+    if (map == NULL) return NULL;
+
+    // Create biome configurations; scale the layer count with the map area
+    BiomeConfig biome_configs[3];
+    int num_biomes = biome_config_get_default(biome_configs, 3);
+    int layers = 7 * (map->width * map->height) / (MATCH_DEFAULT_MAP_WIDTH * MATCH_DEFAULT_MAP_HEIGHT);
+    if (layers < 7) layers = 7;
+
+    MapGenSettings gen = {0};
+    gen.generator = settings->generator;
+    gen.seed = settings->seed;
+    gen.biomes = biome_configs;
+    gen.num_biomes = num_biomes;
+    gen.layers = layers;
+    gen.threads = settings->threads;
+    map_generation_run(map, &gen);
+    return map;
+}
+
+static bool create_troops(Match *match, int troops) {
+    ActorTemplate militia;
+    actor_get_default_militia_template(&militia);
+
+    Faction *darkus = &match->factions[DARKUS];
+    Faction *ventus = &match->factions[VENTUS];
+    darkus->actors = actor_array_create_from_template(troops, darkus, SPRITE_UNIT_DARKUS_MILITIA, &militia);
+    ventus->actors = actor_array_create_from_template(troops, ventus, SPRITE_UNIT_VENTUS_MILITIA, &militia);
+    if (darkus->actors == NULL || ventus->actors == NULL) return false;
+
+    darkus->actor_count = troops;
+    ventus->actor_count = troops;
+    return true;
+}
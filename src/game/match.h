@@ -0,0 +1,57 @@
+#ifndef MATCH_H_
+#define MATCH_H_
+
+#include "types.h"
+#include "game/terrain.h"
+#include "game/game_logic.h"
+#include "game/map_generation.h"
+#include <stdint.h>
+
+// Default battlefield size; override at startup with --map-size WxH
+#define MATCH_DEFAULT_MAP_WIDTH 30
+#define MATCH_DEFAULT_MAP_HEIGHT 20
+#define MATCH_DEFAULT_TROOPS 6
+#define MATCH_FACTIONS 3
+
+typedef struct MatchSettings {
+    int map_width;
+    int map_height;
+    const char *load_map_path;  // play on this terrain file instead of generating
+    uint64_t seed;              // same seed, same map and match
+    MapGenerator generator;     // terrain backend for generated maps
+    int threads;                // generation worker threads; <= 0 uses the default count
+    int troops;                 // militia per player faction
+    AiMode ai_mode;             // AI for the non-player factions
+    int ai_faction;             // only this faction uses ai_mode, the rest greedy; -1 for all
+    AiSearchSettings ai_search; // used by the search AIs
+} MatchSettings;
+
+// Everything one match owns. Nothing here touches the window, so matches
+// can be set up and played headless, several at once on different threads.
+typedef struct Match {
+    Terrain terrains[TERRAIN_COUNT]; // the map points into this table
+    Faction factions[MATCH_FACTIONS];
+    int num_factions;
+    Map *map;
+    GameState *state;
+} Match;
+
+void match_settings_default(MatchSettings *settings);
+
+// Builds the map, factions, troops, lairs and game state. Returns NULL on
+// failure.
+Match *match_create(const MatchSettings *settings);
+void match_free(Match *match);
+
+// Hands every faction to the AI
+void match_set_all_ai(Match *match);
+
+// Plays AI turns until one faction is left or turn_cap turns have been
+// played. Every faction must be AI controlled. Returns the winner, or NULL
+// for a draw at the cap.
+Faction *match_play_ai(Match *match, int turn_cap);
+
+// Turns actually played, at most turn_cap
+int match_turns_played(const Match *match, int turn_cap);
+
+#endif
@@ -0,0 +1,614 @@
+#include "game/mcts.h"
+#include "core/rng.h"
+#include "core/log.h"
+#include "core/parallel.h"
+#include "core/profiler.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Faction turns a playout runs past the leaf before it is scored
+#define MCTS_PLAYOUT_TURNS 6
+
+// Weight of closing in on the enemy in a playout's score, against the
+// share of hit points; keeps searches that see no fighting from idling
+#define MCTS_ENGAGE_WEIGHT 0.1
+
+// UCT exploration constant, for scores in [0, 1]
+#define MCTS_EXPLORATION 0.3
+
+// Playout units wander to a random reachable cell one time in this many
+#define MCTS_WANDER_ODDS 8
+
+#define MCTS_MAX_ACTIONS 1024       // per decision
+#define MCTS_MAX_DEPTH 256          // decisions from the root to a leaf
+#define MCTS_NODES_INITIAL 4096
+#define MCTS_MAX_NODES (1 << 21)    // past this, leaves are played out but not expanded
+#define MCTS_MAX_THREADS 64
+
+#define MCTS_UNREACHABLE UINT16_MAX
+
+typedef struct MctsNode {
+    CompactAction action;      // the decision that led here
+    uint8_t faction;        // the faction that made it
+    uint16_t child_count;
+    int first_child;        // -1 until expanded
+    int visits;
+    double reward;          // summed scores of `faction`
+} MctsNode;
+
+// One search tree and the scratch its playouts use
+typedef struct MctsWorker {
+    const CompactState *root;
+    const uint16_t *fields; // per faction, path cost to the nearest enemy at the root
+    const AiSearchSettings *settings;
+    uint64_t deadline;      // profiler_now_ns() value; 0 for none
+    Rng rng;
+
+    MctsNode *nodes;
+    int node_count;
+    int node_capacity;
+    long long playouts;
+
+    CompactState state;
+    CompactAction actions[MCTS_MAX_ACTIONS];
+
+    // Cell coordinates, so distances take no division
+    uint8_t cell_x[COMPACT_MAX_CELLS];
+    uint8_t cell_y[COMPACT_MAX_CELLS];
+
+    CompactReach reach;
+} MctsWorker;
+
+typedef struct MctsJob {
+    MctsWorker **workers;
+} MctsJob;
+
+// Forward declarations for internal helper functions
+static void search_task(void *ctx, int task);
+static void search_iteration(MctsWorker *worker);
+static int select_child(const MctsWorker *worker, int node);
+static bool expand(MctsWorker *worker, int node);
+static int generate_actions(MctsWorker *worker, const CompactState *state, int unit);
+static void playout(MctsWorker *worker, double *scores);
+static void playout_action(MctsWorker *worker, const CompactState *state, int unit, CompactAction *out);
+static void approach(MctsWorker *worker, const CompactState *state, int unit, int nearest,
+                     int nearest_distance, CompactAction *out);
+static int nearest_enemy(const MctsWorker *worker, const CompactState *state, int unit, int *out_distance);
+static void build_fields(const CompactState *state, uint16_t *fields);
+static int weakest_target(const MctsWorker *worker, const CompactState *state, int unit, int from);
+static int distance(const MctsWorker *worker, int cell_a, int cell_b);
+static bool is_terminal(const CompactState *state);
+static void score_factions(const MctsWorker *worker, const CompactState *state, double *scores);
+static int count_ready_units(const CompactState *state);
+
+// ============================================================================
+// Search
+// ============================================================================
+
+bool mcts_search(const CompactState *state, const AiSearchSettings *settings, uint64_t seed,
+                 uint64_t budget_ns, CompactAction *out, AiSearchStats *stats) {
+    if (compact_state_next_unit(state) == -1 || is_terminal(state)) return false;
+
+    int threads = settings->threads;
+    if (threads < 1) threads = 1;
+    if (threads > MCTS_MAX_THREADS) threads = MCTS_MAX_THREADS;
+
+    uint64_t start = profiler_now_ns();
+    uint64_t deadline = (budget_ns > 0) ? start + budget_ns : 0;
+
+    // Shared, read-only guides for units too far away to search
+    uint16_t *fields = malloc(sizeof(uint16_t) * state->faction_count * state->cell_count);
+    if (fields == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for search distance fields\n");
+        return false;
+    }
+    build_fields(state, fields);
+
+    MctsWorker *workers[MCTS_MAX_THREADS];
+    int created = 0;
+    for (; created < threads; created++) {
+        MctsWorker *worker = malloc(sizeof(MctsWorker));
+        MctsNode *nodes = (worker != NULL) ? malloc(sizeof(MctsNode) * MCTS_NODES_INITIAL) : NULL;
+        if (nodes == NULL) {
+            free(worker);
+            break;
+        }
+        worker->root = state;
+        worker->fields = fields;
+        worker->settings = settings;
+        worker->deadline = deadline;
+        rng_seed(&worker->rng, rng_mix(seed, (uint64_t)created), RNG_STREAM_SEARCH);
+        worker->nodes = nodes;
+        worker->node_count = 0;
+        worker->node_capacity = MCTS_NODES_INITIAL;
+        worker->playouts = 0;
+        memset(&worker->reach, 0, sizeof(worker->reach));
+        for (int cell = 0; cell < state->cell_count; cell++) {
+            worker->cell_x[cell] = (uint8_t)(cell % state->width);
+            worker->cell_y[cell] = (uint8_t)(cell / state->width);
+        }
+        workers[created] = worker;
+    }
+    if (created == 0) {
+        fprintf(stderr, "Error: Failed to allocate memory for search workers\n");
+        free(fields);
+        return false;
+    }
+
+    MctsJob job = {workers};
+    parallel_for(created, created, search_task, &job);
+
+    // Every tree expanded the same root actions in the same order, so the
+    // children line up; the most visited decision wins
+    const MctsWorker *first = workers[0];
+    const MctsNode *root = &first->nodes[0];
+    int best = -1;
+    long long best_visits = -1;
+    double best_reward = 0.0;
+    long long playouts = 0;
+    for (int c = 0; c < root->child_count; c++) {
+        long long visits = 0;
+        double reward = 0.0;
+        for (int w = 0; w < created; w++) {
+            const MctsNode *child = &workers[w]->nodes[workers[w]->nodes[0].first_child + c];
+            visits += child->visits;
+            reward += child->reward;
+        }
+        if (visits > best_visits || (visits == best_visits && reward > best_reward)) {
+            best = c;
+            best_visits = visits;
+            best_reward = reward;
+        }
+    }
+    *out = first->nodes[root->first_child + best].action;
+
+    for (int w = 0; w < created; w++) {
+        playouts += workers[w]->playouts;
+        free(workers[w]->nodes);
+        free(workers[w]);
+    }
+    free(fields);
+
+    if (stats != NULL) {
+        stats->playouts += playouts;
+        stats->seconds += (double)(profiler_now_ns() - start) * 1e-9;
+        stats->searches++;
+    }
+    return true;
+}
+
+bool mcts_play_turn(GameState *state, Map *map) {
+    CompactState *compact = malloc(sizeof(CompactState));
+    if (compact == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for search state\n");
+        return false;
+    }
+    if (!compact_state_capture(compact, state, map)) {
+        free(compact);
+        return false;
+    }
+
+    PROFILE_BEGIN("mcts_turn");
+    const AiSearchSettings *settings = &state->ai_search;
+    uint64_t start = profiler_now_ns();
+    uint64_t budget = (uint64_t)(settings->budget_ms > 0 ? settings->budget_ms : 0) * 1000000ULL;
+    long long playouts_before = state->ai_stats.playouts;
+
+    // Each decision gets an equal share of what is left of the turn budget
+    for (int decision = 0; ; decision++) {
+        int ready = count_ready_units(compact);
+        if (ready == 0) break;
+
+        uint64_t budget_ns = 0;
+        if (budget > 0) {
+            uint64_t spent = profiler_now_ns() - start;
+            budget_ns = (spent < budget) ? (budget - spent) / (uint64_t)ready : 1;
+        }
+
+        uint64_t seed = rng_mix(rng_mix(state->seed, (uint64_t)state->turn_number),
+                                (uint64_t)(compact->current_faction * 1024 + decision));
+        CompactAction action;
+        if (!mcts_search(compact, settings, seed, budget_ns, &action, &state->ai_stats)) break;
+        compact_state_commit(state, map, compact, &action);
+
+        if (!compact_state_capture(compact, state, map)) break;
+    }
+
+    long long playouts = state->ai_stats.playouts - playouts_before;
+    double seconds = (double)(profiler_now_ns() - start) * 1e-9;
+    log_info("%s searched %lld playouts in %.1f ms (%.0f playouts/s)\n",
+             game_get_current_faction(state)->name, playouts, seconds * 1e3,
+             seconds > 0.0 ? playouts / seconds : 0.0);
+    PROFILE_COUNTER("mcts_playouts", playouts);
+    PROFILE_END();
+
+    free(compact);
+    return true;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Grows one tree until the playout cap or the deadline. At least one
+// playout always runs, so the root is expanded and every answer is legal.
+static void search_task(void *ctx, int task) {
+    MctsJob *job = ctx;
+    MctsWorker *worker = job->workers[task];
+
+    MctsNode *root = &worker->nodes[worker->node_count++];
+    memset(root, 0, sizeof(MctsNode));
+    root->first_child = -1;
+    root->faction = worker->root->current_faction;
+
+    // A forced decision needs no more than the one playout
+    int cap = worker->settings->max_playouts;
+    do {
+        search_iteration(worker);
+    } while (worker->nodes[0].child_count > 1 && (cap <= 0 || worker->playouts < cap) &&
+             (worker->deadline == 0 || profiler_now_ns() < worker->deadline));
+}
+
+// Selection, expansion, playout and backpropagation, once
+static void search_iteration(MctsWorker *worker) {
+    CompactState *state = &worker->state;
+    compact_state_clone(state, worker->root);
+
+    int path[MCTS_MAX_DEPTH];
+    int depth = 0;
+    int node = 0;
+    path[depth++] = 0;
+
+    // Walk down through expanded nodes, stopping at the first unvisited child
+    while (worker->nodes[node].first_child != -1 && worker->nodes[node].child_count > 0 &&
+           depth < MCTS_MAX_DEPTH) {
+        node = select_child(worker, node);
+        compact_state_apply(state, &worker->nodes[node].action);
+        path[depth++] = node;
+        if (worker->nodes[node].visits == 0) break;
+    }
+
+    // A leaf seen before gets children; play out from the first of them
+    MctsNode *leaf = &worker->nodes[node];
+    if (leaf->first_child == -1 && (node == 0 || leaf->visits > 0) && depth < MCTS_MAX_DEPTH &&
+        !is_terminal(state) && expand(worker, node)) {
+        node = worker->nodes[node].first_child;
+        compact_state_apply(state, &worker->nodes[node].action);
+        path[depth++] = node;
+    }
+
+    double scores[MAX_FACTIONS];
+    playout(worker, scores);
+    worker->playouts++;
+
+    for (int i = 0; i < depth; i++) {
+        MctsNode *n = &worker->nodes[path[i]];
+        n->visits++;
+        n->reward += scores[n->faction];
+    }
+}
+
+// UCT; unvisited children first, in generation order
+static int select_child(const MctsWorker *worker, int node) {
+    const MctsNode *parent = &worker->nodes[node];
+    double log_visits = log((double)(parent->visits > 0 ? parent->visits : 1));
+    int best = parent->first_child;
+    double best_value = -1.0;
+    for (int c = 0; c < parent->child_count; c++) {
+        int index = parent->first_child + c;
+        const MctsNode *child = &worker->nodes[index];
+        if (child->visits == 0) return index;
+
+        double value = child->reward / child->visits +
+                       MCTS_EXPLORATION * sqrt(log_visits / child->visits);
+        if (value > best_value) {
+            best = index;
+            best_value = value;
+        }
+    }
+    return best;
+}
+
+// Adds a child per decision the next unit can make. Returns false when
+// there is none or the node pool is full.
+static bool expand(MctsWorker *worker, int node) {
+    const CompactState *state = &worker->state;
+    int unit = compact_state_next_unit(state);
+    if (unit == -1) return false;
+
+    // A unit no enemy can meet this turn or the next only closes in
+    const CompactUnit *u = &state->units[unit];
+    int nearest_distance;
+    int nearest = nearest_enemy(worker, state, unit, &nearest_distance);
+    int count;
+    if (nearest != -1 && nearest_distance > COMPACT_CONTACT_DISTANCE(u)) {
+        worker->actions[0] = (CompactAction){(int16_t)unit, u->cell, -1};
+        if (u->flags & COMPACT_CAN_MOVE) {
+            approach(worker, state, unit, nearest, nearest_distance, &worker->actions[0]);
+        }
+        count = 1;
+    } else {
+        count = generate_actions(worker, state, unit);
+    }
+    if (count == 0) return false;
+
+    if (worker->node_count + count > worker->node_capacity) {
+        if (worker->node_count + count > MCTS_MAX_NODES) return false;
+        int new_capacity = worker->node_capacity * 2;
+        while (new_capacity < worker->node_count + count) new_capacity *= 2;
+        MctsNode *nodes = realloc(worker->nodes, sizeof(MctsNode) * new_capacity);
+        if (nodes == NULL) return false;
+        worker->nodes = nodes;
+        worker->node_capacity = new_capacity;
+    }
+
+    int first = worker->node_count;
+    for (int i = 0; i < count; i++) {
+        MctsNode *child = &worker->nodes[first + i];
+        child->action = worker->actions[i];
+        child->faction = state->current_faction;
+        child->child_count = 0;
+        child->first_child = -1;
+        child->visits = 0;
+        child->reward = 0.0;
+    }
+    worker->node_count += count;
+    worker->nodes[node].first_child = first;
+    worker->nodes[node].child_count = (uint16_t)count;
+    return true;
+}
+
+// Every cell in movement range (staying put first), with one decision per
+// enemy that can be struck from it, or a plain move when none can
+static int generate_actions(MctsWorker *worker, const CompactState *state, int unit) {
+    const CompactUnit *u = &state->units[unit];
+    compact_state_reach(state, unit, &worker->reach);
+
+    int count = 0;
+    for (int r = 0; r < worker->reach.count && count < MCTS_MAX_ACTIONS; r++) {
+        int dest = worker->reach.cells[r];
+        int attacks = 0;
+        if (u->flags & COMPACT_CAN_ACT) {
+            for (int e = 0; e < state->unit_count && count < MCTS_MAX_ACTIONS; e++) {
+                const CompactUnit *enemy = &state->units[e];
+                if (enemy->cell == COMPACT_NO_CELL || enemy->faction == u->faction) continue;
+                if (distance(worker, dest, enemy->cell) > u->attack_range) continue;
+                worker->actions[count++] = (CompactAction){(int16_t)unit, (int16_t)dest, (int16_t)e};
+                attacks++;
+            }
+        }
+        if (attacks == 0 && count < MCTS_MAX_ACTIONS) {
+            worker->actions[count++] = (CompactAction){(int16_t)unit, (int16_t)dest, -1};
+        }
+    }
+    return count;
+}
+
+// Fills `scores` with each faction's share of the hit points left after
+// MCTS_PLAYOUT_TURNS more faction turns of the playout policy
+static void playout(MctsWorker *worker, double *scores) {
+    CompactState *state = &worker->state;
+    int turns = 0;
+    bool over = is_terminal(state);
+    while (turns < MCTS_PLAYOUT_TURNS && !over) {
+        int unit = compact_state_next_unit(state);
+        if (unit == -1) break;
+
+        int faction = state->current_faction;
+        int turn_number = state->turn_number;
+        CompactAction action;
+        playout_action(worker, state, unit, &action);
+        compact_state_apply(state, &action);
+        if (state->current_faction != faction || state->turn_number != turn_number) turns++;
+        if (action.target >= 0) over = is_terminal(state);
+    }
+    score_factions(worker, state, scores);
+}
+
+// Strike the weakest enemy in range; otherwise walk towards the nearest
+// enemy (now and then somewhere random) and strike from there
+static void playout_action(MctsWorker *worker, const CompactState *state, int unit, CompactAction *out) {
+    const CompactUnit *u = &state->units[unit];
+    out->unit = (int16_t)unit;
+    out->dest = u->cell;
+    out->target = -1;
+
+    if (u->flags & COMPACT_CAN_ACT) {
+        int target = weakest_target(worker, state, unit, u->cell);
+        if (target != -1) {
+            out->target = (int16_t)target;
+            return;
+        }
+    }
+    if (!(u->flags & COMPACT_CAN_MOVE)) return;
+
+    int nearest_distance;
+    int nearest = nearest_enemy(worker, state, unit, &nearest_distance);
+    if (nearest == -1) return;
+
+    if (rng_range(&worker->rng, MCTS_WANDER_ODDS) == 0) {
+        compact_state_reach(state, unit, &worker->reach);
+        out->dest = worker->reach.cells[rng_range(&worker->rng, worker->reach.count)];
+        if ((u->flags & COMPACT_CAN_ACT) && nearest_distance <= u->movement + u->attack_range) {
+            out->target = (int16_t)weakest_target(worker, state, unit, out->dest);
+        }
+    } else {
+        approach(worker, state, unit, nearest, nearest_distance, out);
+    }
+}
+
+// Moves `unit` to the cell in range closest to enemy `nearest`, then
+// strikes the weakest enemy there. Far from contact, "closest" follows the
+// faction's distance field, so units walk around water and walls.
+static void approach(MctsWorker *worker, const CompactState *state, int unit, int nearest,
+                     int nearest_distance, CompactAction *out) {
+    const CompactUnit *u = &state->units[unit];
+    const uint16_t *field = worker->fields + u->faction * state->cell_count;
+    compact_state_reach(state, unit, &worker->reach);
+
+    if (nearest_distance > COMPACT_CONTACT_DISTANCE(u) && field[u->cell] != MCTS_UNREACHABLE) {
+        int best = field[u->cell];
+        for (int r = 1; r < worker->reach.count; r++) {
+            int cell = worker->reach.cells[r];
+            if (field[cell] < best) {
+                out->dest = (int16_t)cell;
+                best = field[cell];
+            }
+        }
+        return;
+    }
+
+    int goal = state->units[nearest].cell;
+    int best = nearest_distance;
+    for (int r = 1; r < worker->reach.count; r++) {
+        int cell = worker->reach.cells[r];
+        int d = distance(worker, cell, goal);
+        if (d < best) {
+            out->dest = (int16_t)cell;
+            best = d;
+        }
+    }
+
+    if ((u->flags & COMPACT_CAN_ACT) && nearest_distance <= u->movement + u->attack_range) {
+        out->target = (int16_t)weakest_target(worker, state, unit, out->dest);
+    }
+}
+
+// Fills one field per faction with the path cost from every cell to the
+// nearest enemy unit, over terrain and structures but through other units.
+// Cells nothing can reach hold MCTS_UNREACHABLE.
+static void build_fields(const CompactState *state, uint16_t *fields) {
+    int16_t queue[COMPACT_MAX_CELLS];
+    bool queued[COMPACT_MAX_CELLS];
+
+    for (int f = 0; f < state->faction_count; f++) {
+        uint16_t *field = fields + f * state->cell_count;
+        memset(queued, 0, sizeof(bool) * state->cell_count);
+        int head = 0;
+        int tail = 0;
+        int pending = 0;
+        for (int cell = 0; cell < state->cell_count; cell++) {
+            field[cell] = MCTS_UNREACHABLE;
+        }
+        for (int i = 0; i < state->unit_count; i++) {
+            const CompactUnit *enemy = &state->units[i];
+            if (enemy->cell == COMPACT_NO_CELL || enemy->faction == f || queued[enemy->cell]) continue;
+            field[enemy->cell] = 0;
+            queued[enemy->cell] = true;
+            queue[tail++] = enemy->cell;
+            pending++;
+        }
+
+        // FIFO label correcting: a cell is worth its step cost plus the
+        // cheapest neighbour's value
+        while (pending > 0) {
+            int cell = queue[head];
+            if (++head == COMPACT_MAX_CELLS) head = 0;
+            pending--;
+            queued[cell] = false;
+
+            int x = cell % state->width;
+            int neighbors[4] = {
+                (cell >= state->width) ? cell - state->width : -1,
+                (cell + state->width < state->cell_count) ? cell + state->width : -1,
+                (x > 0) ? cell - 1 : -1,
+                (x + 1 < state->width) ? cell + 1 : -1
+            };
+            int step = compact_state_move_cost(state, cell);
+            for (int d = 0; d < 4; d++) {
+                int next = neighbors[d];
+                if (next < 0 || state->move_cost[state->cells[next].terrain] == 0) continue;
+                const CompactCell *c = &state->cells[next];
+                if (c->structure != 0 && !state->structures[c->structure - 1].passable) continue;
+
+                int value = field[cell] + step;
+                if (value >= field[next]) continue;
+                field[next] = (uint16_t)value;
+                if (!queued[next]) {
+                    queued[next] = true;
+                    queue[tail] = (int16_t)next;
+                    if (++tail == COMPACT_MAX_CELLS) tail = 0;
+                    pending++;
+                }
+            }
+        }
+    }
+}
+
+// Closest enemy of `unit` as the crow flies, or -1
+static int nearest_enemy(const MctsWorker *worker, const CompactState *state, int unit, int *out_distance) {
+    const CompactUnit *u = &state->units[unit];
+    int nearest = -1;
+    *out_distance = 0;
+    for (int e = 0; e < state->unit_count; e++) {
+        const CompactUnit *enemy = &state->units[e];
+        if (enemy->cell == COMPACT_NO_CELL || enemy->faction == u->faction) continue;
+        int d = distance(worker, u->cell, enemy->cell);
+        if (nearest == -1 || d < *out_distance) {
+            nearest = e;
+            *out_distance = d;
+        }
+    }
+    return nearest;
+}
+
+// Enemy within `unit`'s attack range of `from` with the least health, or -1
+static int weakest_target(const MctsWorker *worker, const CompactState *state, int unit, int from) {
+    const CompactUnit *u = &state->units[unit];
+    int best = -1;
+    for (int e = 0; e < state->unit_count; e++) {
+        const CompactUnit *enemy = &state->units[e];
+        if (enemy->cell == COMPACT_NO_CELL || enemy->faction == u->faction) continue;
+        if (distance(worker, from, enemy->cell) > u->attack_range) continue;
+        if (best == -1 || enemy->health < state->units[best].health) best = e;
+    }
+    return best;
+}
+
+static int distance(const MctsWorker *worker, int cell_a, int cell_b) {
+    return abs(worker->cell_x[cell_a] - worker->cell_x[cell_b]) +
+           abs(worker->cell_y[cell_a] - worker->cell_y[cell_b]);
+}
+
+static bool is_terminal(const CompactState *state) {
+    return compact_state_factions_alive(state) <= 1;
+}
+
+// Each faction's share of the hit points left, plus a little for how far
+// its units have come along the faction's distance field
+static void score_factions(const MctsWorker *worker, const CompactState *state, double *scores) {
+    int health[MAX_FACTIONS] = {0};
+    int gap[MAX_FACTIONS] = {0};
+    int units[MAX_FACTIONS] = {0};
+    int total = 0;
+    int span = state->width + state->height;
+    for (int i = 0; i < state->unit_count; i++) {
+        const CompactUnit *u = &state->units[i];
+        if (u->cell == COMPACT_NO_CELL) continue;
+        health[u->faction] += u->health;
+        total += u->health;
+
+        int left = worker->fields[u->faction * state->cell_count + u->cell];
+        gap[u->faction] += (left < span) ? left : span;
+        units[u->faction]++;
+    }
+
+    for (int f = 0; f < MAX_FACTIONS; f++) {
+        double share = (total > 0) ? (double)health[f] / total : 0.0;
+        double engage = (units[f] > 0) ? 1.0 - (double)gap[f] / (units[f] * span) : 0.0;
+        scores[f] = (1.0 - MCTS_ENGAGE_WEIGHT) * share + MCTS_ENGAGE_WEIGHT * engage;
+    }
+}
+
+static int count_ready_units(const CompactState *state) {
+    int count = 0;
+    for (int i = 0; i < state->unit_count; i++) {
+        const CompactUnit *u = &state->units[i];
+        if (u->faction == state->current_faction && u->cell != COMPACT_NO_CELL && u->flags != 0) {
+            count++;
+        }
+    }
+    return count;
+}
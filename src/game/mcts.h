@@ -0,0 +1,33 @@
+#ifndef MCTS_H_
+#define MCTS_H_
+
+#include "types.h"
+#include "game/game_logic.h"
+#include "game/compact_state.h"
+#include <stdbool.h>
+
+// Monte Carlo tree search AI. A faction's turn is a sequence of unit
+// decisions, each a move plus an optional attack; the tree branches on them
+// and runs on across the following factions' turns. Units no enemy can meet
+// within two turns get a single decision, closing in along a distance field.
+// Playouts continue from each new leaf on a cloned compact state with a
+// fast greedy policy for MCTS_PLAYOUT_TURNS faction turns, then score every
+// faction by its share of the hit points left and, a little, by how far it
+// has closed in. Each worker grows its own tree from its own seed (root
+// parallelism) and the root visit counts are summed. With a playout cap and
+// no deadline, a search is reproducible for a given worker count.
+
+// Decides `state` (the compact copy of the match) one decision at a time:
+// fills `out` with the best action for the next unit to act. `budget_ns`
+// bounds the search (0 for none); settings->max_playouts caps each worker.
+// Returns false when no unit of the current faction can act or only one
+// faction is left standing.
+bool mcts_search(const CompactState *state, const AiSearchSettings *settings, uint64_t seed,
+                 uint64_t budget_ns, CompactAction *out, AiSearchStats *stats);
+
+// Plays the current faction's turn on the map with MCTS, splitting the turn
+// budget over its units. Returns false, having done nothing, when the match
+// does not fit a compact state; the caller then falls back to another AI.
+bool mcts_play_turn(GameState *state, Map *map);
+
+#endif
@@ -0,0 +1,225 @@
+#include "game/pathfinding.h"
+#include "game/map.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Initial open list capacity; it grows on demand and is kept between searches
+#define PATH_HEAP_INITIAL 1024
+
+// Up, down, left, right (same order as the range searches)
+static const int NEIGHBOR_DX[4] = {0, 0, -1, 1};
+static const int NEIGHBOR_DY[4] = {-1, 1, 0, 0};
+
+// Forward declarations for internal helper functions
+static uint64_t heap_key(int f, int g);
+static bool heap_less(const PathHeapEntry *a, const PathHeapEntry *b);
+static bool heap_push(PathFinder *finder, int cell, int f, int g);
+static PathHeapEntry heap_pop(PathFinder *finder);
+static int write_path(const PathFinder *finder, int end, int *out, int max_len);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+PathFinder *pathfinder_create(int cell_count) {
+    PathFinder *finder = malloc(sizeof(PathFinder));
+    if (finder == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for path finder\n");
+        return NULL;
+    }
+
+    finder->cell_count = cell_count;
+    finder->generation = 0;
+    finder->heap_size = 0;
+    finder->expanded = 0;
+    finder->reached_goal = false;
+    finder->heap_capacity = PATH_HEAP_INITIAL;
+
+    finder->g = malloc(sizeof(int) * cell_count);
+    finder->prev = malloc(sizeof(int) * cell_count);
+    finder->stamp = calloc(cell_count, sizeof(unsigned int));
+    finder->heap = malloc(sizeof(PathHeapEntry) * finder->heap_capacity);
+
+    if (finder->g == NULL || finder->prev == NULL || finder->stamp == NULL || finder->heap == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for path finder buffers\n");
+        pathfinder_free(finder);
+        return NULL;
+    }
+
+    return finder;
+}
+
+void pathfinder_free(PathFinder *finder) {
+    if (finder == NULL) return;
+    free(finder->g);
+    free(finder->prev);
+    free(finder->stamp);
+    free(finder->heap);
+    free(finder);
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+int pathfinder_find(PathFinder *finder, Map *map, int start, int goal,
+                    int max_expansions, int *out, int max_len) {
+    finder->expanded = 0;
+    finder->reached_goal = false;
+    finder->heap_size = 0;
+    if (!map_is_valid_cell(map, start) || !map_is_valid_cell(map, goal) || max_len <= 0) {
+        return 0;
+    }
+
+    // Bumping the generation invalidates every cell without touching the arrays
+    finder->generation++;
+    if (finder->generation == 0) {
+        memset(finder->stamp, 0, sizeof(unsigned int) * finder->cell_count);
+        finder->generation = 1;
+    }
+
+    int goal_x = map_cell_x(map, goal);
+    int goal_y = map_cell_y(map, goal);
+    int start_h = abs(map_cell_x(map, start) - goal_x) + abs(map_cell_y(map, start) - goal_y);
+
+    finder->stamp[start] = finder->generation;
+    finder->g[start] = 0;
+    finder->prev[start] = -1;
+    heap_push(finder, start, start_h, 0);
+
+    // Fallback end point: the expanded cell with the lowest estimate, then the lowest cost
+    int best = start;
+    int best_h = start_h;
+
+    while (finder->heap_size > 0) {
+        PathHeapEntry entry = heap_pop(finder);
+        int cell = entry.cell;
+        int g = entry.g;
+
+        // Stale entry: the cell was pushed again with a lower cost. The
+        // estimate is consistent, so a cell's first pop is final.
+        if (finder->g[cell] != g) continue;
+
+        if (cell == goal) {
+            finder->reached_goal = true;
+            best = goal;
+            break;
+        }
+
+        int cell_x = map_cell_x(map, cell);
+        int cell_y = map_cell_y(map, cell);
+        int h = abs(cell_x - goal_x) + abs(cell_y - goal_y);
+        if (h < best_h || (h == best_h && g < finder->g[best])) {
+            best = cell;
+            best_h = h;
+        }
+
+        finder->expanded++;
+        if (max_expansions > 0 && finder->expanded >= max_expansions) break;
+
+        for (int d = 0; d < 4; d++) {
+            int n_x = cell_x + NEIGHBOR_DX[d];
+            int n_y = cell_y + NEIGHBOR_DY[d];
+            int n_index = map_get_cell(map, n_x, n_y);
+            if (n_index == MAP_NO_CELL) continue;
+            if (n_index != goal && !map_can_unit_enter_cell(map, n_index, NULL)) continue;
+
+            int new_g = g + map_get_move_cost(map, n_index);
+            if (finder->stamp[n_index] == finder->generation && finder->g[n_index] <= new_g) {
+                continue;
+            }
+
+            finder->stamp[n_index] = finder->generation;
+            finder->g[n_index] = new_g;
+            finder->prev[n_index] = cell;
+            if (!heap_push(finder, n_index, new_g + abs(n_x - goal_x) + abs(n_y - goal_y), new_g)) {
+                finder->heap_size = 0; // out of memory: settle for the best cell so far
+                break;
+            }
+        }
+    }
+
+    return write_path(finder, best, out, max_len);
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Lower f first; on ties the higher g (closer to the goal) sorts first
+static uint64_t heap_key(int f, int g) {
+    return ((uint64_t)(uint32_t)f << 32) | (uint32_t)(INT32_MAX - g);
+}
+
+// The key lives in the entry, so sifting never touches the per-cell arrays.
+// Equal keys fall back to the lower cell index, so searches are deterministic.
+static bool heap_less(const PathHeapEntry *a, const PathHeapEntry *b) {
+    if (a->key != b->key) return a->key < b->key;
+    return a->cell < b->cell;
+}
+
+static bool heap_push(PathFinder *finder, int cell, int f, int g) {
+    if (finder->heap_size == finder->heap_capacity) {
+        int new_capacity = finder->heap_capacity * 2;
+        PathHeapEntry *heap = realloc(finder->heap, sizeof(PathHeapEntry) * new_capacity);
+        if (heap == NULL) {
+            fprintf(stderr, "Error: Failed to grow path finder open list\n");
+            return false;
+        }
+        finder->heap = heap;
+        finder->heap_capacity = new_capacity;
+    }
+
+    PathHeapEntry entry = {heap_key(f, g), cell, g};
+    int slot = finder->heap_size++;
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (!heap_less(&entry, &finder->heap[parent])) break;
+        finder->heap[slot] = finder->heap[parent];
+        slot = parent;
+    }
+    finder->heap[slot] = entry;
+    return true;
+}
+
+static PathHeapEntry heap_pop(PathFinder *finder) {
+    PathHeapEntry top = finder->heap[0];
+    PathHeapEntry last = finder->heap[--finder->heap_size];
+    int size = finder->heap_size;
+    if (size == 0) return top;
+
+    // Sift the last entry down from the root
+    int slot = 0;
+    for (;;) {
+        int child = 2 * slot + 1;
+        if (child >= size) break;
+        if (child + 1 < size && heap_less(&finder->heap[child + 1], &finder->heap[child])) {
+            child++;
+        }
+        if (!heap_less(&finder->heap[child], &last)) break;
+        finder->heap[slot] = finder->heap[child];
+        slot = child;
+    }
+    finder->heap[slot] = last;
+    return top;
+}
+
+static int write_path(const PathFinder *finder, int end, int *out, int max_len) {
+    int length = 0;
+    for (int c = end; c != -1; c = finder->prev[c]) {
+        length++;
+    }
+
+    // Drop the tail beyond max_len, then fill the rest back to front
+    int c = end;
+    for (int skip = length - max_len; skip > 0; skip--) {
+        c = finder->prev[c];
+    }
+    int written = (length < max_len) ? length : max_len;
+    for (int i = written - 1; i >= 0; i--) {
+        out[i] = c;
+        c = finder->prev[c];
+    }
+    return written;
+}
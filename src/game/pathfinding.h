@@ -0,0 +1,51 @@
+#ifndef PATHFINDING_H_
+#define PATHFINDING_H_
+
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Open list entry: the sort key travels with the cell
+typedef struct PathHeapEntry {
+    uint64_t key;           // f in the high half, then higher g first
+    int cell;
+    int g;                  // cost when pushed; stale once the cell's cost drops
+} PathHeapEntry;
+
+// Reusable scratch for A* over the grid with a binary-heap open list.
+// Improving a cell pushes it again and the stale entry is skipped when it
+// surfaces. Step costs are the terrain move costs and blocked cells follow
+// map_can_unit_enter_cell, as for movement range searches.
+typedef struct PathFinder {
+    int cell_count;
+
+    int *g;                 // cost from the start (valid when stamp matches)
+    int *prev;              // predecessor cell index, -1 for the start
+    unsigned int *stamp;    // generation in which the cell was opened
+    unsigned int generation;
+
+    PathHeapEntry *heap;    // open list, lowest key first
+    int heap_size;
+    int heap_capacity;
+
+    int expanded;           // cells expanded by the last search
+    bool reached_goal;      // whether the last path ends at the goal
+} PathFinder;
+
+// Lifecycle. cell_count is the map's slot count (map->cell_count).
+PathFinder *pathfinder_create(int cell_count);
+void pathfinder_free(PathFinder *finder);
+
+// Finds a cheapest path from `start` to `goal`. The goal itself may be
+// occupied (a unit to walk up to); every other cell on the path must be
+// enterable. Stops after `max_expansions` cells (<= 0 for no limit).
+//
+// Writes the path from the start (inclusive) into `out`, truncated to its
+// first `max_len` cells, and returns the number of cells written. When the
+// goal cannot be reached within the limit, the path ends at the expanded
+// cell closest to the goal instead, so callers can still head towards it.
+// Returns 0 for invalid input.
+int pathfinder_find(PathFinder *finder, Map *map, int start, int goal,
+                    int max_expansions, int *out, int max_len);
+
+#endif
@@ -0,0 +1,191 @@
+#include "game/reachability.h"
+#include "game/map.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Up, down, left, right (same order the old recursive flood used)
+static const int NEIGHBOR_DX[4] = {0, 0, -1, 1};
+static const int NEIGHBOR_DY[4] = {-1, 1, 0, 0};
+
+// Forward declarations for internal helper functions
+static bool ensure_bucket_capacity(ReachMap *reach, int max_cost);
+static void push_entry(ReachMap *reach, int *entry_count, int cost, int cell_index);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+ReachMap *reachability_create(int width, int height, int cell_count) {
+    ReachMap *reach = malloc(sizeof(ReachMap));
+    if (reach == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for reach map\n");
+        return NULL;
+    }
+
+    int cells = cell_count;
+    reach->width = width;
+    reach->height = height;
+    reach->cell_count = cells;
+    reach->generation = 0;
+    reach->reached_count = 0;
+
+    // Each successful relaxation pushes one entry, so 4 per cell plus the origin
+    reach->entry_capacity = cells * 4 + 1;
+
+    reach->cost = malloc(sizeof(int) * cells);
+    reach->prev = malloc(sizeof(int) * cells);
+    reach->stamp = calloc(cells, sizeof(unsigned int));
+    reach->reached = malloc(sizeof(int) * cells);
+    reach->entry_cell = malloc(sizeof(int) * reach->entry_capacity);
+    reach->entry_next = malloc(sizeof(int) * reach->entry_capacity);
+    reach->bucket_head = NULL;
+    reach->bucket_capacity = 0;
+
+    if (reach->cost == NULL || reach->prev == NULL || reach->stamp == NULL ||
+        reach->reached == NULL || reach->entry_cell == NULL || reach->entry_next == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for reach map buffers\n");
+        reachability_free(reach);
+        return NULL;
+    }
+
+    return reach;
+}
+
+void reachability_free(ReachMap *reach) {
+    if (reach == NULL) return;
+    free(reach->cost);
+    free(reach->prev);
+    free(reach->stamp);
+    free(reach->reached);
+    free(reach->entry_cell);
+    free(reach->entry_next);
+    free(reach->bucket_head);
+    free(reach);
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+int reachability_compute(ReachMap *reach, Map *map, int start_cell,
+                         int max_cost, ReachMode mode) {
+    reach->reached_count = 0;
+    if (start_cell == MAP_NO_CELL || max_cost < 0) return 0;
+    if (!ensure_bucket_capacity(reach, max_cost)) return 0;
+
+    // Bumping the generation invalidates every cell without touching the arrays
+    reach->generation++;
+    if (reach->generation == 0) {
+        memset(reach->stamp, 0, sizeof(unsigned int) * reach->cell_count);
+        reach->generation = 1;
+    }
+
+    for (int c = 0; c <= max_cost; c++) {
+        reach->bucket_head[c] = -1;
+    }
+
+    int entry_count = 0;
+    int origin = start_cell;
+
+    reach->stamp[origin] = reach->generation;
+    reach->cost[origin] = 0;
+    reach->prev[origin] = -1;
+    push_entry(reach, &entry_count, 0, origin);
+
+    for (int c = 0; c <= max_cost; c++) {
+        for (int e = reach->bucket_head[c]; e != -1; e = reach->entry_next[e]) {
+            int cell_index = reach->entry_cell[e];
+
+            // Stale entry: the cell was later reached more cheaply
+            if (reach->cost[cell_index] != c) continue;
+
+            reach->reached[reach->reached_count++] = cell_index;
+
+            for (int d = 0; d < 4; d++) {
+                int n_index = map_get_neighbor(map, cell_index, NEIGHBOR_DX[d], NEIGHBOR_DY[d]);
+                if (n_index == MAP_NO_CELL) continue;
+
+                int step = 1;
+                if (mode == REACH_MOVEMENT) {
+                    if (!map_can_unit_enter_cell(map, n_index, NULL)) continue;
+                    step = map_get_move_cost(map, n_index);
+                }
+
+                int new_cost = c + step;
+                if (new_cost > max_cost) continue;
+                if (reach->stamp[n_index] == reach->generation &&
+                    reach->cost[n_index] <= new_cost) {
+                    continue;
+                }
+
+                reach->stamp[n_index] = reach->generation;
+                reach->cost[n_index] = new_cost;
+                reach->prev[n_index] = cell_index;
+                push_entry(reach, &entry_count, new_cost, n_index);
+            }
+        }
+    }
+
+    return reach->reached_count;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+bool reachability_is_reached(ReachMap *reach, int cell_index) {
+    if (cell_index < 0 || cell_index >= reach->cell_count) return false;
+    return reach->stamp[cell_index] == reach->generation;
+}
+
+int reachability_get_cost(ReachMap *reach, int cell_index) {
+    if (!reachability_is_reached(reach, cell_index)) return -1;
+    return reach->cost[cell_index];
+}
+
+int reachability_get_prev(ReachMap *reach, int cell_index) {
+    if (!reachability_is_reached(reach, cell_index)) return -1;
+    return reach->prev[cell_index];
+}
+
+int reachability_build_path(ReachMap *reach, int target, int *out, int max_len) {
+    if (!reachability_is_reached(reach, target)) return 0;
+
+    int length = 0;
+    for (int c = target; c != -1; c = reach->prev[c]) {
+        length++;
+    }
+    if (length > max_len) return 0;
+
+    int i = length - 1;
+    for (int c = target; c != -1; c = reach->prev[c]) {
+        out[i--] = c;
+    }
+    return length;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static bool ensure_bucket_capacity(ReachMap *reach, int max_cost) {
+    if (max_cost < reach->bucket_capacity) return true;
+
+    int new_capacity = max_cost + 1;
+    int *buckets = realloc(reach->bucket_head, sizeof(int) * new_capacity);
+    if (buckets == NULL) {
+        fprintf(stderr, "Error: Failed to grow reach map buckets\n");
+        return false;
+    }
+    reach->bucket_head = buckets;
+    reach->bucket_capacity = new_capacity;
+    return true;
+}
+
+static void push_entry(ReachMap *reach, int *entry_count, int cost, int cell_index) {
+    int e = (*entry_count)++;
+    reach->entry_cell[e] = cell_index;
+    reach->entry_next[e] = reach->bucket_head[cost];
+    reach->bucket_head[cost] = e;
+}
@@ -0,0 +1,54 @@
+#ifndef REACHABILITY_H_
+#define REACHABILITY_H_
+
+#include "types.h"
+#include <stdbool.h>
+
+// How a search treats terrain and occupants
+typedef enum {
+    REACH_MOVEMENT, // pays per-terrain move costs, blocked by impassable/occupied cells
+    REACH_ATTACK    // every step costs 1, nothing blocks
+} ReachMode;
+
+// Reusable scratch for bucket-queue (Dial) Dijkstra over the grid.
+// Results stay valid until the next call to reachability_compute.
+typedef struct ReachMap {
+    int width;
+    int height;
+    int cell_count;
+
+    int *cost;              // accumulated cost per cell (valid when stamp matches)
+    int *prev;              // predecessor cell index, -1 for the origin
+    unsigned int *stamp;    // generation in which the cell was reached
+    unsigned int generation;
+
+    int *reached;           // reached cell indices in settle order
+    int reached_count;
+
+    // Bucket queue: one singly linked list of entries per cost value
+    int *bucket_head;
+    int bucket_capacity;
+    int *entry_cell;
+    int *entry_next;
+    int entry_capacity;
+} ReachMap;
+
+// Lifecycle. cell_count is the map's slot count (map->cell_count), which
+// covers every index a map cell can have.
+ReachMap *reachability_create(int width, int height, int cell_count);
+void reachability_free(ReachMap *reach);
+
+// Run a search from `start` up to `max_cost`. Returns the number of reached cells.
+int reachability_compute(ReachMap *reach, Map *map, int start_cell,
+                         int max_cost, ReachMode mode);
+
+// Queries on the last search
+bool reachability_is_reached(ReachMap *reach, int cell_index);
+int reachability_get_cost(ReachMap *reach, int cell_index);
+int reachability_get_prev(ReachMap *reach, int cell_index);
+
+// Writes the cell indices from the origin to `target` (inclusive) into `out`.
+// Returns the path length, or 0 if the target was not reached or does not fit.
+int reachability_build_path(ReachMap *reach, int target, int *out, int max_len);
+
+#endif
@@ -0,0 +1,422 @@
+#include "game/replay.h"
+#include "game/map.h"
+#include "game/game_logic.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define REPLAY_MAGIC "EIRP"
+#define REPLAY_VERSION 1
+#define REPLAY_HEADER_SIZE 52 // magic, version, seed, size, generator, troops, AI, checksum, path length
+#define REPLAY_BUFFER_SIZE 65536
+
+// One tag byte, then a fixed payload per tag
+typedef enum {
+    REPLAY_RECORD_MOVE = 1,  // actor u16, from i32, to i32
+    REPLAY_RECORD_ATTACK,    // from i32, to i32
+    REPLAY_RECORD_WAIT,      // actor u16
+    REPLAY_RECORD_UNDO,
+    REPLAY_RECORD_REDO,
+    REPLAY_RECORD_TURN,      // checksum u64 once the next faction has the turn
+    REPLAY_RECORD_END        // the recording was stopped, not cut short
+} ReplayRecord;
+
+struct ReplayWriter {
+    FILE *file;
+    Match *match;
+    size_t used;
+    bool failed;            // reported once, then records are dropped
+    uint8_t buffer[REPLAY_BUFFER_SIZE];
+};
+
+struct Replay {
+    uint8_t *data;
+    size_t size;
+    size_t start;           // first record
+    size_t pos;             // next record
+    bool complete;
+    bool diverged;
+    uint64_t checksum;      // game_state_hash() when the recording started
+    char *map_path;         // settings.load_map_path points here
+    MatchSettings settings;
+};
+
+// Forward declarations for internal helper functions
+static uint8_t *reserve(ReplayWriter *writer, size_t bytes);
+static void flush(ReplayWriter *writer);
+static int record_size(uint8_t tag);
+static ReplayStep diverged(Replay *replay, Match *match, const char *reason);
+static void put_u16(uint8_t *out, uint16_t value);
+static void put_u32(uint8_t *out, uint32_t value);
+static void put_u64(uint8_t *out, uint64_t value);
+static uint16_t get_u16(const uint8_t *in);
+static uint32_t get_u32(const uint8_t *in);
+static uint64_t get_u64(const uint8_t *in);
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+ReplayWriter *replay_record_start(Match *match, const MatchSettings *settings, const char *path) {
+    ReplayWriter *writer = malloc(sizeof(ReplayWriter));
+    if (writer == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for replay writer\n");
+        return NULL;
+    }
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        fprintf(stderr, "Error: Could not open %s for writing\n", path);
+        free(writer);
+        return NULL;
+    }
+    // The buffer below already batches records; each flush goes straight out
+    setvbuf(writer->file, NULL, _IONBF, 0);
+    writer->match = match;
+    writer->used = 0;
+    writer->failed = false;
+
+    const char *map_path = (settings->load_map_path != NULL) ? settings->load_map_path : "";
+    size_t path_length = strlen(map_path);
+    uint8_t header[REPLAY_HEADER_SIZE];
+    memcpy(header, REPLAY_MAGIC, 4);
+    put_u32(header + 4, REPLAY_VERSION);
+    put_u64(header + 8, settings->seed);
+    put_u32(header + 16, (uint32_t)settings->map_width);
+    put_u32(header + 20, (uint32_t)settings->map_height);
+    put_u32(header + 24, (uint32_t)settings->generator);
+    put_u32(header + 28, (uint32_t)settings->troops);
+    put_u32(header + 32, (uint32_t)settings->ai_mode);
+    put_u32(header + 36, (uint32_t)settings->ai_faction);
+    put_u64(header + 40, game_state_hash(match->state, match->map));
+    put_u32(header + 48, (uint32_t)path_length);
+    if (fwrite(header, 1, sizeof(header), writer->file) != sizeof(header) ||
+        fwrite(map_path, 1, path_length, writer->file) != path_length) {
+        fprintf(stderr, "Error: Failed to write replay header to %s\n", path);
+        fclose(writer->file);
+        free(writer);
+        return NULL;
+    }
+
+    match->state->commands->recorder = writer;
+    return writer;
+}
+
+void replay_record_stop(ReplayWriter *writer) {
+    if (writer == NULL) return;
+    reserve(writer, 1)[0] = REPLAY_RECORD_END;
+    flush(writer);
+    if (fclose(writer->file) != 0 && !writer->failed) {
+        fprintf(stderr, "Error: Failed to finish the replay file\n");
+    }
+    writer->match->state->commands->recorder = NULL;
+    free(writer);
+}
+
+void replay_record_command(ReplayWriter *writer, const Command *command) {
+    uint8_t *out;
+    switch ((CommandType)command->type) {
+        case COMMAND_MOVE:
+            out = reserve(writer, 11);
+            out[0] = REPLAY_RECORD_MOVE;
+            put_u16(out + 1, command->actor);
+            put_u32(out + 3, (uint32_t)command->from);
+            put_u32(out + 7, (uint32_t)command->to);
+            break;
+        case COMMAND_ATTACK:
+            out = reserve(writer, 9);
+            out[0] = REPLAY_RECORD_ATTACK;
+            put_u32(out + 1, (uint32_t)command->from);
+            put_u32(out + 5, (uint32_t)command->to);
+            break;
+        case COMMAND_WAIT:
+            out = reserve(writer, 3);
+            out[0] = REPLAY_RECORD_WAIT;
+            put_u16(out + 1, command->actor);
+            break;
+    }
+}
+
+void replay_record_undo(ReplayWriter *writer) {
+    reserve(writer, 1)[0] = REPLAY_RECORD_UNDO;
+}
+
+void replay_record_redo(ReplayWriter *writer) {
+    reserve(writer, 1)[0] = REPLAY_RECORD_REDO;
+}
+
+void replay_record_turn(ReplayWriter *writer) {
+    uint8_t *out = reserve(writer, 9);
+    out[0] = REPLAY_RECORD_TURN;
+    put_u64(out + 1, game_state_hash(writer->match->state, writer->match->map));
+    flush(writer);
+}
+
+// ============================================================================
+// Playback
+// ============================================================================
+
+Replay *replay_open(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open %s for reading\n", path);
+        return NULL;
+    }
+    Replay *replay = calloc(1, sizeof(Replay));
+    if (replay == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for replay\n");
+        fclose(file);
+        return NULL;
+    }
+
+    // Replays are small, so the whole file is read up front
+    size_t capacity = 0;
+    for (;;) {
+        if (replay->size == capacity) {
+            capacity = (capacity == 0) ? REPLAY_BUFFER_SIZE : capacity * 2;
+            uint8_t *data = realloc(replay->data, capacity);
+            if (data == NULL) {
+                fprintf(stderr, "Error: Failed to allocate memory for replay\n");
+                fclose(file);
+                replay_free(replay);
+                return NULL;
+            }
+            replay->data = data;
+        }
+        size_t got = fread(replay->data + replay->size, 1, capacity - replay->size, file);
+        if (got == 0) break;
+        replay->size += got;
+    }
+    fclose(file);
+
+    const uint8_t *header = replay->data;
+    if (replay->size < REPLAY_HEADER_SIZE || memcmp(header, REPLAY_MAGIC, 4) != 0 ||
+        get_u32(header + 4) != REPLAY_VERSION) {
+        fprintf(stderr, "Error: %s is not a supported replay file\n", path);
+        replay_free(replay);
+        return NULL;
+    }
+    uint32_t path_length = get_u32(header + 48);
+    if (path_length > replay->size - REPLAY_HEADER_SIZE) {
+        fprintf(stderr, "Error: Replay file %s is truncated\n", path);
+        replay_free(replay);
+        return NULL;
+    }
+
+    MatchSettings *settings = &replay->settings;
+    match_settings_default(settings);
+    settings->seed = get_u64(header + 8);
+    settings->map_width = (int)get_u32(header + 16);
+    settings->map_height = (int)get_u32(header + 20);
+    settings->generator = (MapGenerator)get_u32(header + 24);
+    settings->troops = (int)get_u32(header + 28);
+    settings->ai_mode = (AiMode)get_u32(header + 32);
+    settings->ai_faction = (int)get_u32(header + 36);
+    replay->checksum = get_u64(header + 40);
+    if (path_length > 0) {
+        replay->map_path = malloc(path_length + 1);
+        if (replay->map_path == NULL) {
+            fprintf(stderr, "Error: Failed to allocate memory for replay\n");
+            replay_free(replay);
+            return NULL;
+        }
+        memcpy(replay->map_path, replay->data + REPLAY_HEADER_SIZE, path_length);
+        replay->map_path[path_length] = '\0';
+        settings->load_map_path = replay->map_path;
+    }
+    replay->start = REPLAY_HEADER_SIZE + path_length;
+
+    // Walk the records once so playback can trust their sizes. A recording
+    // cut short by a crash may end in the middle of a record; what came
+    // before still plays.
+    size_t pos = replay->start;
+    while (pos < replay->size) {
+        int size = record_size(replay->data[pos]);
+        if (size == 0) {
+            fprintf(stderr, "Error: Replay file %s has an unknown record at byte %zu\n", path, pos);
+            replay_free(replay);
+            return NULL;
+        }
+        if ((size_t)size > replay->size - pos) break;
+        if (replay->data[pos] == REPLAY_RECORD_END) {
+            replay->complete = true;
+            pos += (size_t)size;
+            break;
+        }
+        pos += (size_t)size;
+    }
+    replay->size = pos;
+    replay->pos = replay->start;
+    return replay;
+}
+
+void replay_free(Replay *replay) {
+    if (replay == NULL) return;
+    free(replay->data);
+    free(replay->map_path);
+    free(replay);
+}
+
+const MatchSettings *replay_settings(const Replay *replay) {
+    return &replay->settings;
+}
+
+Match *replay_create_match(Replay *replay) {
+    Match *match = match_create(&replay->settings);
+    if (match == NULL) return NULL;
+
+    uint64_t checksum = game_state_hash(match->state, match->map);
+    if (checksum != replay->checksum) {
+        fprintf(stderr, "Error: Replay starts from a different match (checksum %016llx, expected %016llx); "
+                        "was the map generator or the map file changed?\n",
+                (unsigned long long)checksum, (unsigned long long)replay->checksum);
+        match_free(match);
+        return NULL;
+    }
+    replay->pos = replay->start;
+    replay->diverged = false;
+    return match;
+}
+
+ReplayStep replay_step(Replay *replay, Match *match) {
+    if (replay->diverged) return REPLAY_STEP_DIVERGED;
+    if (replay->pos >= replay->size) return REPLAY_STEP_END;
+
+    GameState *state = match->state;
+    Map *map = match->map;
+    const uint8_t *record = replay->data + replay->pos;
+    ReplayStep step = REPLAY_STEP_ACTION;
+    switch ((ReplayRecord)record[0]) {
+        case REPLAY_RECORD_MOVE: {
+            Actor *actor = map_get_actor(map, get_u16(record + 1));
+            int from = (int32_t)get_u32(record + 3);
+            int to = (int32_t)get_u32(record + 7);
+            if (actor == NULL || actor->cell != from || !command_log_move(state->commands, map, actor, to)) {
+                return diverged(replay, match, "the recorded move is not possible");
+            }
+            break;
+        }
+        case REPLAY_RECORD_ATTACK: {
+            int from = (int32_t)get_u32(record + 1);
+            int to = (int32_t)get_u32(record + 5);
+            if (command_log_attack(state->commands, map, from, to).attacker == NULL) {
+                return diverged(replay, match, "the recorded attack is not possible");
+            }
+            break;
+        }
+        case REPLAY_RECORD_WAIT: {
+            Actor *actor = map_get_actor(map, get_u16(record + 1));
+            if (actor == NULL) return diverged(replay, match, "the waiting unit is gone");
+            command_log_wait(state->commands, actor);
+            break;
+        }
+        case REPLAY_RECORD_UNDO:
+            if (!command_log_undo(state->commands, map)) return diverged(replay, match, "nothing to undo");
+            break;
+        case REPLAY_RECORD_REDO:
+            if (!command_log_redo(state->commands, map)) return diverged(replay, match, "nothing to redo");
+            break;
+        case REPLAY_RECORD_TURN: {
+            game_end_current_turn(state);
+            uint64_t checksum = game_state_hash(state, map);
+            if (checksum != get_u64(record + 1)) {
+                char reason[96];
+                snprintf(reason, sizeof(reason), "checksum %016llx after the turn passed, recorded %016llx",
+                         (unsigned long long)checksum, (unsigned long long)get_u64(record + 1));
+                return diverged(replay, match, reason);
+            }
+            step = REPLAY_STEP_TURN;
+            break;
+        }
+        case REPLAY_RECORD_END:
+            replay->pos = replay->size;
+            return REPLAY_STEP_END;
+    }
+    replay->pos += (size_t)record_size(record[0]);
+    return step;
+}
+
+bool replay_is_complete(const Replay *replay) {
+    return replay->complete;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Room for `bytes` more in the buffer, writing it out first if it is full.
+// After a write error records land in the buffer and are dropped.
+static uint8_t *reserve(ReplayWriter *writer, size_t bytes) {
+    if (writer->used + bytes > REPLAY_BUFFER_SIZE) {
+        flush(writer);
+    }
+    uint8_t *out = writer->buffer + writer->used;
+    writer->used += bytes;
+    return out;
+}
+
+static void flush(ReplayWriter *writer) {
+    if (writer->used > 0 && !writer->failed &&
+        fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        fprintf(stderr, "Error: Failed to write to the replay file; recording stops here\n");
+        writer->failed = true;
+    }
+    writer->used = 0;
+}
+
+// Bytes taken by a record with this tag, 0 for an unknown tag
+static int record_size(uint8_t tag) {
+    switch ((ReplayRecord)tag) {
+        case REPLAY_RECORD_MOVE: return 11;
+        case REPLAY_RECORD_ATTACK: return 9;
+        case REPLAY_RECORD_WAIT: return 3;
+        case REPLAY_RECORD_UNDO: return 1;
+        case REPLAY_RECORD_REDO: return 1;
+        case REPLAY_RECORD_TURN: return 9;
+        case REPLAY_RECORD_END: return 1;
+    }
+    return 0;
+}
+
+static ReplayStep diverged(Replay *replay, Match *match, const char *reason) {
+    fprintf(stderr, "Error: Replay diverges on turn %d (%s) at byte %zu: %s\n", match->state->turn_number,
+            game_get_current_faction(match->state)->name, replay->pos, reason);
+    replay->diverged = true;
+    return REPLAY_STEP_DIVERGED;
+}
+
+static void put_u16(uint8_t *out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void put_u64(uint8_t *out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint16_t get_u16(const uint8_t *in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= (uint32_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t get_u64(const uint8_t *in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= (uint64_t)in[i] << (8 * i);
+    }
+    return value;
+}
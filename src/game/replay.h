@@ -0,0 +1,65 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "types.h"
+#include "game/match.h"
+#include "game/command_log.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// A replay file is the match setup (seed, map size, generator, troops and,
+// for saved terrain, the map file) followed by every unit action as it was
+// performed, player and AI alike, undos and redos included. Each passed
+// turn adds the game_state_hash() of the match once the next faction has
+// the turn, so playback notices the first turn where it no longer matches.
+// Playback applies the recorded actions; it never asks the AI again, so a
+// replay comes out the same whatever budget or thread count the AI had.
+#define REPLAY_DEFAULT_PATH "last_match.replay"
+
+// Recording. Records collect in memory and reach the file once per faction
+// turn, so a crash loses at most the turn in progress.
+typedef struct ReplayWriter ReplayWriter;
+
+// Starts recording `match`, which `settings` created, to `path`. Hooks into
+// the match's command log and turn logic. Returns NULL if the file cannot
+// be written.
+ReplayWriter *replay_record_start(Match *match, const MatchSettings *settings, const char *path);
+
+// Marks the recording complete, writes what is left and detaches it
+void replay_record_stop(ReplayWriter *writer);
+
+// Hooks for the command log and game_next_turn
+void replay_record_command(ReplayWriter *writer, const Command *command);
+void replay_record_undo(ReplayWriter *writer);
+void replay_record_redo(ReplayWriter *writer);
+void replay_record_turn(ReplayWriter *writer);
+
+// Playback
+typedef struct Replay Replay;
+
+typedef enum {
+    REPLAY_STEP_ACTION,   // one action applied, or taken back or redone
+    REPLAY_STEP_TURN,     // the turn passed and its checksum matched
+    REPLAY_STEP_END,      // nothing left to play
+    REPLAY_STEP_DIVERGED  // the match no longer follows the recording
+} ReplayStep;
+
+// Reads a whole replay file. Returns NULL if it is missing or not a replay.
+Replay *replay_open(const char *path);
+void replay_free(Replay *replay);
+
+// The settings the recorded match was created with
+const MatchSettings *replay_settings(const Replay *replay);
+
+// Builds the recorded match and checks it starts out as recorded. Returns
+// NULL on failure. Playback starts from the first record.
+Match *replay_create_match(Replay *replay);
+
+// Plays the next record on `match`. Divergence is reported on stderr.
+ReplayStep replay_step(Replay *replay, Match *match);
+
+// Whether the file ended with the recording's end marker; a game that
+// crashed leaves it out
+bool replay_is_complete(const Replay *replay);
+
+#endif
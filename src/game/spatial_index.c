@@ -0,0 +1,242 @@
+#include "game/spatial_index.h"
+#include "game/map.h"
+#include "core/bitboard.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Forward declarations for internal helper functions
+static int search_nearest(SpatialIndex *index, Map *map, int origin, int faction_id,
+                          int k, int max_dist, int *out_cells, int *out_dists);
+static void scan_bucket(SpatialIndex *index, Map *map, int bx, int by, int ox, int oy,
+                        int faction_id, int k, int max_dist,
+                        int *cells, int *dists, int *found);
+static int bucket_distance(int bx, int by, int ox, int oy);
+static int enemy_count(SpatialIndex *index, int bucket, int faction_id);
+static bool is_enemy_at(Map *map, int cell, int x, int y, int faction_id);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+SpatialIndex *spatial_index_create(int width, int height) {
+    SpatialIndex *index = malloc(sizeof(SpatialIndex));
+    if (index == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for spatial index\n");
+        return NULL;
+    }
+
+    index->width = width;
+    index->height = height;
+    index->buckets_x = (width + SPATIAL_BUCKET_SIZE - 1) / SPATIAL_BUCKET_SIZE;
+    index->buckets_y = (height + SPATIAL_BUCKET_SIZE - 1) / SPATIAL_BUCKET_SIZE;
+
+    int buckets = index->buckets_x * index->buckets_y;
+    index->total = calloc(buckets, sizeof(uint8_t));
+    index->counts = calloc((size_t)buckets * MAX_FACTIONS, sizeof(uint8_t));
+    if (index->total == NULL || index->counts == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for spatial index buckets\n");
+        spatial_index_free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void spatial_index_free(SpatialIndex *index) {
+    if (index == NULL) return;
+    free(index->total);
+    free(index->counts);
+    free(index);
+}
+
+void spatial_index_clear(SpatialIndex *index) {
+    int buckets = index->buckets_x * index->buckets_y;
+    memset(index->total, 0, sizeof(uint8_t) * buckets);
+    memset(index->counts, 0, sizeof(uint8_t) * buckets * MAX_FACTIONS);
+}
+
+// ============================================================================
+// Maintenance
+// ============================================================================
+
+void spatial_index_add(SpatialIndex *index, int x, int y, int faction_id) {
+    int bucket = (y / SPATIAL_BUCKET_SIZE) * index->buckets_x + x / SPATIAL_BUCKET_SIZE;
+    index->total[bucket]++;
+    index->counts[bucket * MAX_FACTIONS + faction_id]++;
+}
+
+void spatial_index_remove(SpatialIndex *index, int x, int y, int faction_id) {
+    int bucket = (y / SPATIAL_BUCKET_SIZE) * index->buckets_x + x / SPATIAL_BUCKET_SIZE;
+    index->total[bucket]--;
+    index->counts[bucket * MAX_FACTIONS + faction_id]--;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+int spatial_index_nearest_enemy(SpatialIndex *index, Map *map, Actor *actor, int max_dist) {
+    int cell = MAP_NO_CELL;
+    int dist = 0;
+    if (actor == NULL || actor->cell == MAP_NO_CELL) return MAP_NO_CELL;
+    search_nearest(index, map, actor->cell, actor->owner->id, 1, max_dist, &cell, &dist);
+    return cell;
+}
+
+int spatial_index_k_nearest_enemies(SpatialIndex *index, Map *map, Actor *actor,
+                                    int k, int max_dist, int *out) {
+    if (actor == NULL || actor->cell == MAP_NO_CELL || k <= 0) return 0;
+
+    int *dists = malloc(sizeof(int) * k);
+    if (dists == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for k-nearest query\n");
+        return 0;
+    }
+    int found = search_nearest(index, map, actor->cell, actor->owner->id, k, max_dist, out, dists);
+    free(dists);
+    return found;
+}
+
+int spatial_index_enemies_within(SpatialIndex *index, Map *map, int cell,
+                                 int faction_id, int range, int *out, int max_out) {
+    if (cell == MAP_NO_CELL || range < 0) return 0;
+
+    int ox = map_cell_x(map, cell);
+    int oy = map_cell_y(map, cell);
+    int min_x = (ox - range < 0) ? 0 : ox - range;
+    int max_x = (ox + range >= index->width) ? index->width - 1 : ox + range;
+    int min_y = (oy - range < 0) ? 0 : oy - range;
+    int max_y = (oy + range >= index->height) ? index->height - 1 : oy + range;
+
+    int min_bx = min_x / SPATIAL_BUCKET_SIZE;
+    int max_bx = max_x / SPATIAL_BUCKET_SIZE;
+    int count = 0;
+
+    // Row-major over the diamond's bounding box, skipping enemy-free buckets
+    for (int y = min_y; y <= max_y && count < max_out; y++) {
+        int by = y / SPATIAL_BUCKET_SIZE;
+        int row_span = range - abs(y - oy);
+
+        for (int bx = min_bx; bx <= max_bx && count < max_out; bx++) {
+            if (enemy_count(index, by * index->buckets_x + bx, faction_id) == 0) continue;
+
+            int x0 = bx * SPATIAL_BUCKET_SIZE;
+            int x1 = x0 + SPATIAL_BUCKET_SIZE - 1;
+            if (x0 < ox - row_span) x0 = ox - row_span;
+            if (x1 > ox + row_span) x1 = ox + row_span;
+            if (x0 < min_x) x0 = min_x;
+            if (x1 > max_x) x1 = max_x;
+
+            for (int x = x0; x <= x1 && count < max_out; x++) {
+                int c = map_get_cell(map, x, y);
+                if (is_enemy_at(map, c, x, y, faction_id)) {
+                    out[count++] = c;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// Visits buckets in rings of growing Chebyshev distance around the origin's
+// bucket. Every bucket in ring R is at least (R - 1) * SIZE + 1 cells away,
+// so the search stops once the k-th best is strictly closer than that.
+static int search_nearest(SpatialIndex *index, Map *map, int origin, int faction_id,
+                          int k, int max_dist, int *out_cells, int *out_dists) {
+    int ox = map_cell_x(map, origin);
+    int oy = map_cell_y(map, origin);
+    int bx0 = ox / SPATIAL_BUCKET_SIZE;
+    int by0 = oy / SPATIAL_BUCKET_SIZE;
+
+    int max_ring = bx0;
+    if (index->buckets_x - 1 - bx0 > max_ring) max_ring = index->buckets_x - 1 - bx0;
+    if (by0 > max_ring) max_ring = by0;
+    if (index->buckets_y - 1 - by0 > max_ring) max_ring = index->buckets_y - 1 - by0;
+
+    int found = 0;
+    for (int ring = 0; ring <= max_ring; ring++) {
+        int bound = (ring == 0) ? 0 : (ring - 1) * SPATIAL_BUCKET_SIZE + 1;
+        if (found == k && out_dists[k - 1] < bound) break;
+        if (max_dist >= 0 && bound > max_dist) break;
+
+        for (int by = by0 - ring; by <= by0 + ring; by++) {
+            if (by < 0 || by >= index->buckets_y) continue;
+
+            // Full rows on the ring's top and bottom edge, only the two ends elsewhere
+            bool edge_row = (by == by0 - ring || by == by0 + ring);
+            int step = (edge_row || ring == 0) ? 1 : 2 * ring;
+
+            for (int bx = bx0 - ring; bx <= bx0 + ring; bx += step) {
+                if (bx < 0 || bx >= index->buckets_x) continue;
+                scan_bucket(index, map, bx, by, ox, oy, faction_id, k, max_dist,
+                            out_cells, out_dists, &found);
+            }
+        }
+    }
+    return found;
+}
+
+static void scan_bucket(SpatialIndex *index, Map *map, int bx, int by, int ox, int oy,
+                        int faction_id, int k, int max_dist,
+                        int *cells, int *dists, int *found) {
+    if (enemy_count(index, by * index->buckets_x + bx, faction_id) == 0) return;
+
+    int lower = bucket_distance(bx, by, ox, oy);
+    if (max_dist >= 0 && lower > max_dist) return;
+    if (*found == k && lower > dists[k - 1]) return;
+
+    int x0 = bx * SPATIAL_BUCKET_SIZE;
+    int y0 = by * SPATIAL_BUCKET_SIZE;
+    int x1 = (x0 + SPATIAL_BUCKET_SIZE > index->width) ? index->width : x0 + SPATIAL_BUCKET_SIZE;
+    int y1 = (y0 + SPATIAL_BUCKET_SIZE > index->height) ? index->height : y0 + SPATIAL_BUCKET_SIZE;
+
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            int c = map_get_cell(map, x, y);
+            if (!is_enemy_at(map, c, x, y, faction_id)) continue;
+
+            int d = abs(x - ox) + abs(y - oy);
+            if (max_dist >= 0 && d > max_dist) continue;
+
+            // Keep the k best sorted by (distance, cell index)
+            int slot = *found;
+            if (slot == k) {
+                if (d > dists[k - 1] || (d == dists[k - 1] && c > cells[k - 1])) continue;
+                slot = k - 1;
+            } else {
+                (*found)++;
+            }
+            while (slot > 0 && (dists[slot - 1] > d ||
+                                (dists[slot - 1] == d && cells[slot - 1] > c))) {
+                dists[slot] = dists[slot - 1];
+                cells[slot] = cells[slot - 1];
+                slot--;
+            }
+            dists[slot] = d;
+            cells[slot] = c;
+        }
+    }
+}
+
+// Manhattan distance from (ox, oy) to the nearest cell of a bucket
+static int bucket_distance(int bx, int by, int ox, int oy) {
+    int x0 = bx * SPATIAL_BUCKET_SIZE;
+    int y0 = by * SPATIAL_BUCKET_SIZE;
+    int x1 = x0 + SPATIAL_BUCKET_SIZE - 1;
+    int y1 = y0 + SPATIAL_BUCKET_SIZE - 1;
+    int dx = (ox < x0) ? x0 - ox : (ox > x1) ? ox - x1 : 0;
+    int dy = (oy < y0) ? y0 - oy : (oy > y1) ? oy - y1 : 0;
+    return dx + dy;
+}
+
+static int enemy_count(SpatialIndex *index, int bucket, int faction_id) {
+    return index->total[bucket] - index->counts[bucket * MAX_FACTIONS + faction_id];
+}
+
+static bool is_enemy_at(Map *map, int cell, int x, int y, int faction_id) {
+    return map->occupant[cell] != 0 && !bitboard_test(map->occupancy_layer[faction_id], x, y);
+}
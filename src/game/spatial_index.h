@@ -0,0 +1,40 @@
+#ifndef SPATIAL_INDEX_H_
+#define SPATIAL_INDEX_H_
+
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Side length, in cells, of one spatial bucket
+#define SPATIAL_BUCKET_SIZE 8
+
+// Per-faction unit counts over a coarse grid of buckets. The map updates it
+// on every occupant change, so queries only visit buckets that can contain
+// an enemy and stop as soon as no unvisited bucket can beat the answer.
+typedef struct SpatialIndex {
+    int width;
+    int height;
+    int buckets_x;
+    int buckets_y;
+    uint8_t *total;   // units per bucket
+    uint8_t *counts;  // units per bucket and faction: [bucket * MAX_FACTIONS + faction]
+} SpatialIndex;
+
+// Lifecycle
+SpatialIndex *spatial_index_create(int width, int height);
+void spatial_index_free(SpatialIndex *index);
+void spatial_index_clear(SpatialIndex *index);
+
+// Maintenance (called by the map when occupants change)
+void spatial_index_add(SpatialIndex *index, int x, int y, int faction_id);
+void spatial_index_remove(SpatialIndex *index, int x, int y, int faction_id);
+
+// Queries. Distances are Manhattan; ties are broken by lower cell index.
+// max_dist < 0 means unlimited.
+int spatial_index_nearest_enemy(SpatialIndex *index, Map *map, Actor *actor, int max_dist);
+int spatial_index_k_nearest_enemies(SpatialIndex *index, Map *map, Actor *actor,
+                                    int k, int max_dist, int *out);
+int spatial_index_enemies_within(SpatialIndex *index, Map *map, int cell,
+                                 int faction_id, int range, int *out, int max_out);
+
+#endif
@@ -2,12 +2,13 @@
 #include <stdlib.h>
 #include <string.h>
 
-Structure *structure_create(Texture2D sprite, const char *name, bool passable, bool lootable) {
+Structure *structure_create(SpriteId sprite, const char *name, bool passable, bool lootable) {
     Structure *s = malloc(sizeof(Structure));
     if (!s) return NULL;
     s->sprite = sprite;
     s->passable = passable;
     s->lootable = lootable;
+    s->cell = -1;
     if (name) {
         strncpy(s->name, name, sizeof(s->name) - 1);
         s->name[sizeof(s->name) - 1] = '\0';
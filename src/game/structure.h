@@ -4,7 +4,7 @@
 #include "types.h"
 #include <stdbool.h>
 
-Structure *structure_create(Texture2D sprite, const char *name, bool passable, bool lootable);
+Structure *structure_create(SpriteId sprite, const char *name, bool passable, bool lootable);
 void structure_free(Structure *s);
 
 #endif
@@ -6,29 +6,34 @@
 #include "game/structure.h"
 #include "game/actor.h"
 #include "game/map.h"
+#include "game/flow_field.h"
 #include "game/terrain.h"
 
+// Forward declarations for internal helper functions
+static bool is_warg_lair(Structure *s);
+
 // Place lair structures only. Returns number of lairs placed.
-int structure_generation_place_warg_lairs(Point *mapArr, GridConfig *grid_config,
-                                          Terrain *terrains, int terrain_count,
-                                          StructureSprites structure_sprites) {
-    if (mapArr == NULL || grid_config == NULL || terrains == NULL) return 0;
+int structure_generation_place_warg_lairs(Map *map, Rng *rng) {
+    if (map == NULL) return 0;
 
-    int num_lairs = (rand() % 3) + 4; // 4..6
+    int num_lairs = rng_range(rng, 3) + 4; // 4..6
     int lairs_placed = 0;
     int attempts = 0;
 
     while (lairs_placed < num_lairs && attempts < 1000) {
         attempts++;
-        Point *candidate = map_get_random_cell(mapArr, grid_config);
-        if (candidate == NULL) continue;
-        if (candidate->terrain.id != terrains[TERRAIN_PLAINS].id) continue;
-        if (candidate->occupant != NULL || candidate->structure != NULL) continue;
+        int candidate = map_get_random_cell(map, rng);
+        if (candidate == MAP_NO_CELL) continue;
+        if (map_get_terrain_type(map, candidate) != TERRAIN_PLAINS) continue;
+        if (map_is_cell_occupied(map, candidate) || map_get_structure(map, candidate) != NULL) continue;
 
         // Place lair structure only
-        Structure *lair = structure_create(structure_sprites.warg_lair, "Warg Lair", true, false);
+        Structure *lair = structure_create(SPRITE_STRUCTURE_WARG_LAIR, "Warg Lair", true, false);
         if (lair == NULL) continue;
-        map_place_structure(mapArr, grid_config, candidate->x, candidate->y, lair);
+        if (!map_place_structure(map, map_cell_x(map, candidate), map_cell_y(map, candidate), lair)) {
+            structure_free(lair);
+            continue;
+        }
 
         lairs_placed++;
     }
@@ -37,11 +42,9 @@ int structure_generation_place_warg_lairs(Point *mapArr, GridConfig *grid_config
 }
 
 // Spawn wargs around already placed lairs. Returns allocated actor array and writes count.
-Actor *structure_generation_spawn_wargs_around_lairs(Point *mapArr, GridConfig *grid_config,
-                                                     UnitSprites unit_sprites,
-                                                     Faction *gaia_faction,
+Actor *structure_generation_spawn_wargs_around_lairs(Map *map, Rng *rng, Faction *gaia_faction,
                                                      int *out_warg_count) {
-    if (mapArr == NULL || grid_config == NULL || gaia_faction == NULL || out_warg_count == NULL) {
+    if (map == NULL || gaia_faction == NULL || out_warg_count == NULL) {
         if (out_warg_count) *out_warg_count = 0;
         return NULL;
     }
@@ -50,51 +53,54 @@ Actor *structure_generation_spawn_wargs_around_lairs(Point *mapArr, GridConfig *
 
     // Count lairs to estimate maximum possible wargs
     int lair_count = 0;
-    for (int y = 0; y < grid_config->max_grid_cells_y; y++) {
-        for (int x = 0; x < grid_config->max_grid_cells_x; x++) {
-            Point *p = map_get_cell(mapArr, grid_config, x, y);
-            if (p && p->structure && strcmp(p->structure->name, "Warg Lair") == 0) {
-                lair_count++;
-            }
+    for (int i = 0; i < map->structure_count; i++) {
+        Structure *s = map->structures[i];
+        if (is_warg_lair(s)) {
+            lair_count++;
         }
     }
 
     int max_possible_wargs = lair_count * 3;
     Actor *gaia_wargs = NULL;
     int gaia_warg_count = 0;
-    if (max_possible_wargs > 0) {
-        gaia_wargs = malloc(sizeof(Actor) * max_possible_wargs);
-        if (gaia_wargs == NULL) {
-            *out_warg_count = 0;
-            return NULL;
-        }
+    if (max_possible_wargs == 0) {
+        *out_warg_count = 0;
+        return NULL;
+    }
+    gaia_wargs = malloc(sizeof(Actor) * max_possible_wargs);
+    if (gaia_wargs == NULL) {
+        *out_warg_count = 0;
+        return NULL;
     }
 
-    // For each lair, try to spawn 2..3 wargs around it
-    for (int y = 0; y < grid_config->max_grid_cells_y; y++) {
-        for (int x = 0; x < grid_config->max_grid_cells_x; x++) {
-            Point *p = map_get_cell(mapArr, grid_config, x, y);
-            if (p == NULL || p->structure == NULL) continue;
-            if (strcmp(p->structure->name, "Warg Lair") != 0) continue;
-
-            ActorTemplate warg_template;
-            actor_get_default_warg_template(&warg_template);
-            int to_spawn = (rand() % 2) + 2; // 2..3
-            int spawned = 0;
-            for (int o = 0; o < 8 && spawned < to_spawn; o++) {
-                int nx = p->x + offsets[o][0];
-                int ny = p->y + offsets[o][1];
-                if (!map_is_valid_coords(grid_config, nx, ny)) continue;
-                Point *dest = map_get_cell(mapArr, grid_config, nx, ny);
-                if (dest == NULL) continue;
-                if (!map_can_unit_enter_cell(dest, NULL)) continue;
-
-                actor_init_from_template(&gaia_wargs[gaia_warg_count], gaia_faction, unit_sprites.warg, &warg_template);
-                dest->occupant = &gaia_wargs[gaia_warg_count];
-                gaia_warg_count++;
-                spawned++;
-                if (gaia_warg_count >= max_possible_wargs) break;
-            }
+    // Gaia's distance field towards the factions already on the map keeps
+    // wargs out of their first-turn reach; the AI reuses it afterwards
+    FlowField *field = flow_field_for_faction(map, gaia_faction->id);
+
+    // For each lair, in the order they were placed, try to spawn 2..3 wargs around it
+    for (int i = 0; i < map->structure_count; i++) {
+        Structure *s = map->structures[i];
+        if (!is_warg_lair(s)) continue;
+        int cell = s->cell;
+
+        int px = map_cell_x(map, cell);
+        int py = map_cell_y(map, cell);
+
+        ActorTemplate warg_template;
+        actor_get_default_warg_template(&warg_template);
+        int to_spawn = rng_range(rng, 2) + 2; // 2..3
+        int spawned = 0;
+        for (int o = 0; o < 8 && spawned < to_spawn; o++) {
+            int dest = map_get_cell(map, px + offsets[o][0], py + offsets[o][1]);
+            if (dest == MAP_NO_CELL) continue;
+            if (!map_can_unit_enter_cell(map, dest, NULL)) continue;
+            if (field != NULL && flow_field_distance(field, dest) <= warg_template.movement) continue;
+
+            actor_init_from_template(&gaia_wargs[gaia_warg_count], gaia_faction, SPRITE_UNIT_WARG, &warg_template);
+            map_move_actor(map, &gaia_wargs[gaia_warg_count], dest);
+            gaia_warg_count++;
+            spawned++;
+            if (gaia_warg_count >= max_possible_wargs) break;
         }
     }
 
@@ -108,3 +114,11 @@ Actor *structure_generation_spawn_wargs_around_lairs(Point *mapArr, GridConfig *
 
     return gaia_wargs;
 }
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static bool is_warg_lair(Structure *s) {
+    return s != NULL && strcmp(s->name, "Warg Lair") == 0;
+}
@@ -1,92 +1,76 @@
 #include "game/terrain.h"
 #include <string.h>
 
-// Helper to load and resize textures
-static Texture2D load_terrain_texture(const char *path, int cell_size) {
-    Image img = LoadImage(path);
-    ImageResize(&img, cell_size, cell_size);
-    Texture2D texture = LoadTextureFromImage(img);
-    UnloadImage(img);
-    return texture;
-}
-
-void terrain_init_all(Terrain *terrains, int cell_size) {
+void terrain_init_all(Terrain *terrains) {
     // Initialize None terrain (no texture)
     terrains[TERRAIN_NONE].id = -1;
-    terrains[TERRAIN_NONE].color = WHITE;
+    terrains[TERRAIN_NONE].sprite = SPRITE_NONE;
     terrains[TERRAIN_NONE].passable = false;
-    terrains[TERRAIN_NONE].deep_version = NULL;
+    terrains[TERRAIN_NONE].move_cost = 0;
+    terrains[TERRAIN_NONE].deep_version = TERRAIN_NONE;
     strcpy(terrains[TERRAIN_NONE].name, "None");
     
     // Initialize DeepForest
     terrains[TERRAIN_DEEP_FOREST].id = 41;
-    terrains[TERRAIN_DEEP_FOREST].color = BLACK;
     terrains[TERRAIN_DEEP_FOREST].passable = false;
-    terrains[TERRAIN_DEEP_FOREST].deep_version = &terrains[TERRAIN_NONE];
-    terrains[TERRAIN_DEEP_FOREST].sprite = load_terrain_texture("../../resources/terrain/deep_forest_ter.png", cell_size);
+    terrains[TERRAIN_DEEP_FOREST].move_cost = 0;
+    terrains[TERRAIN_DEEP_FOREST].deep_version = TERRAIN_NONE;
+    terrains[TERRAIN_DEEP_FOREST].sprite = SPRITE_TERRAIN_DEEP_FOREST;
     strcpy(terrains[TERRAIN_DEEP_FOREST].name, "Deep Forest");
     
     // Initialize DeepSea
     terrains[TERRAIN_DEEP_SEA].id = 21;
-    terrains[TERRAIN_DEEP_SEA].color = DARKBLUE;
     terrains[TERRAIN_DEEP_SEA].passable = false;
-    terrains[TERRAIN_DEEP_SEA].deep_version = &terrains[TERRAIN_NONE];
-    terrains[TERRAIN_DEEP_SEA].sprite = load_terrain_texture("../../resources/terrain/deep_sea_ter.png", cell_size);
+    terrains[TERRAIN_DEEP_SEA].move_cost = 0;
+    terrains[TERRAIN_DEEP_SEA].deep_version = TERRAIN_NONE;
+    terrains[TERRAIN_DEEP_SEA].sprite = SPRITE_TERRAIN_DEEP_SEA;
     strcpy(terrains[TERRAIN_DEEP_SEA].name, "Deep Sea");
     
     // Initialize Plains
     terrains[TERRAIN_PLAINS].id = 0;
-    terrains[TERRAIN_PLAINS].color = GREEN;
     terrains[TERRAIN_PLAINS].passable = true;
-    terrains[TERRAIN_PLAINS].deep_version = &terrains[TERRAIN_NONE];
-    terrains[TERRAIN_PLAINS].sprite = load_terrain_texture("../../resources/terrain/plains_ter.png", cell_size);
+    terrains[TERRAIN_PLAINS].move_cost = 1;
+    terrains[TERRAIN_PLAINS].deep_version = TERRAIN_NONE;
+    terrains[TERRAIN_PLAINS].sprite = SPRITE_TERRAIN_PLAINS;
     strcpy(terrains[TERRAIN_PLAINS].name, "Plains");
     
     // Initialize Mountains
     terrains[TERRAIN_MOUNTAINS].id = 1;
-    terrains[TERRAIN_MOUNTAINS].color = LIGHTGRAY;
     terrains[TERRAIN_MOUNTAINS].passable = false;
-    terrains[TERRAIN_MOUNTAINS].deep_version = &terrains[TERRAIN_NONE];
-    terrains[TERRAIN_MOUNTAINS].sprite = load_terrain_texture("../../resources/terrain/mountain_ter2.png", cell_size);
+    terrains[TERRAIN_MOUNTAINS].move_cost = 0;
+    terrains[TERRAIN_MOUNTAINS].deep_version = TERRAIN_NONE;
+    terrains[TERRAIN_MOUNTAINS].sprite = SPRITE_TERRAIN_MOUNTAINS;
     strcpy(terrains[TERRAIN_MOUNTAINS].name, "Mountains");
     
     // Initialize Sea
     terrains[TERRAIN_SEA].id = 2;
-    terrains[TERRAIN_SEA].color = BLUE;
     terrains[TERRAIN_SEA].passable = false;
-    terrains[TERRAIN_SEA].deep_version = &terrains[TERRAIN_DEEP_SEA];
-    terrains[TERRAIN_SEA].sprite = load_terrain_texture("../../resources/terrain/sea_ter.png", cell_size);
+    terrains[TERRAIN_SEA].move_cost = 0;
+    terrains[TERRAIN_SEA].deep_version = TERRAIN_DEEP_SEA;
+    terrains[TERRAIN_SEA].sprite = SPRITE_TERRAIN_SEA;
     strcpy(terrains[TERRAIN_SEA].name, "Sea");
     
     // Initialize Arctic/Hills
     terrains[TERRAIN_ARCTIC].id = 3;
-    terrains[TERRAIN_ARCTIC].color = WHITE;
     terrains[TERRAIN_ARCTIC].passable = true;
-    terrains[TERRAIN_ARCTIC].deep_version = &terrains[TERRAIN_MOUNTAINS];
-    terrains[TERRAIN_ARCTIC].sprite = load_terrain_texture("../../resources/terrain/arctic_ter.png", cell_size);
+    terrains[TERRAIN_ARCTIC].move_cost = 1;
+    terrains[TERRAIN_ARCTIC].deep_version = TERRAIN_MOUNTAINS;
+    terrains[TERRAIN_ARCTIC].sprite = SPRITE_TERRAIN_ARCTIC;
     strcpy(terrains[TERRAIN_ARCTIC].name, "Hills");
     
     // Initialize Forest
     terrains[TERRAIN_FOREST].id = 4;
-    terrains[TERRAIN_FOREST].color = DARKGREEN;
     terrains[TERRAIN_FOREST].passable = true;
-    terrains[TERRAIN_FOREST].deep_version = &terrains[TERRAIN_DEEP_FOREST];
-    terrains[TERRAIN_FOREST].sprite = load_terrain_texture("../../resources/terrain/forest_ter2.png", cell_size);
+    terrains[TERRAIN_FOREST].move_cost = 1;
+    terrains[TERRAIN_FOREST].deep_version = TERRAIN_DEEP_FOREST;
+    terrains[TERRAIN_FOREST].sprite = SPRITE_TERRAIN_FOREST;
     strcpy(terrains[TERRAIN_FOREST].name, "Forest");
     
     // Initialize Player Base
     terrains[TERRAIN_PLAYER_BASE].id = 6;
-    terrains[TERRAIN_PLAYER_BASE].color = ORANGE;
     terrains[TERRAIN_PLAYER_BASE].passable = true;
-    terrains[TERRAIN_PLAYER_BASE].deep_version = &terrains[TERRAIN_NONE];
-    terrains[TERRAIN_PLAYER_BASE].sprite = load_terrain_texture("../../resources/terrain/base_ter.png", cell_size);
+    terrains[TERRAIN_PLAYER_BASE].move_cost = 1;
+    terrains[TERRAIN_PLAYER_BASE].deep_version = TERRAIN_NONE;
+    terrains[TERRAIN_PLAYER_BASE].sprite = SPRITE_TERRAIN_PLAYER_BASE;
     strcpy(terrains[TERRAIN_PLAYER_BASE].name, "Base");
 }
-
-void terrain_unload_all(Terrain *terrains, int count) {
-    for (int i = 0; i < count; i++) {
-        if (terrains[i].sprite.id > 0) {
-            UnloadTexture(terrains[i].sprite);
-        }
-    }
-}
@@ -2,7 +2,6 @@
 #define TERRAIN_H_
 
 #include "types.h"
-#include "raylib.h"
 
 // Terrain indices for array access
 typedef enum {
@@ -18,10 +17,7 @@ typedef enum {
     TERRAIN_COUNT
 } TerrainType;
 
-// Initialize all terrains at once
-void terrain_init_all(Terrain *terrains, int cell_size);
-
-// Cleanup all terrain textures
-void terrain_unload_all(Terrain *terrains, int count);
+// Initialize all terrains at once (pure data; sprites are ids)
+void terrain_init_all(Terrain *terrains);
 
 #endif
@@ -0,0 +1,13 @@
+#include "game/zobrist.h"
+
+// Fixed, so hashes agree between runs and machines
+#define ZOBRIST_SEED 0x5A0B2157C0FFEE11ULL
+
+uint64_t zobrist_key(ZobristKind kind, uint32_t slot, uint32_t value) {
+    // SplitMix64 finaliser over kind, slot and value; slots stay below 2^27
+    uint64_t z = ((((uint64_t)kind << 59) | ((uint64_t)slot << 32) | value) ^ ZOBRIST_SEED) *
+                 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,20 @@
+#ifndef ZOBRIST_H_
+#define ZOBRIST_H_
+
+#include <stdint.h>
+
+// Keys for the incremental state hash (see map_hash). A hash is the XOR of
+// one key per part of the state, so a change swaps the part's old key out
+// and its new key in. Keys are derived from the slot and value on the fly,
+// one SplitMix64 round each, so large maps need no key tables.
+typedef enum {
+    ZOBRIST_TERRAIN,    // slot: cell, value: terrain type
+    ZOBRIST_OCCUPANT,   // slot: cell, value: actor handle
+    ZOBRIST_STRUCTURE,  // slot: cell, value: structure handle
+    ZOBRIST_ACTOR,      // slot: actor handle, value: hit points and turn flags
+    ZOBRIST_TURN        // slot: turn number, value: faction to move
+} ZobristKind;
+
+uint64_t zobrist_key(ZobristKind kind, uint32_t slot, uint32_t value);
+
+#endif
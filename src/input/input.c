@@ -1,6 +1,6 @@
 #include "input/input.h"
 #include "raylib.h"
-#include "core/utils.h"
+#include "input/utils.h"
 #include "main.h"
 #include "game/map.h"
 #include "game/actor.h"
@@ -9,19 +9,26 @@
 #include <stdlib.h>
 
 // Forward declarations for internal helper functions
-static Point *mouse_to_cell(GridConfig *grid_config, Point *map);
-static void handle_cell_selection(GridConfig *grid_config, Point *map, 
-                                   Point *selected_cell, Point **focused_cell);
+static int mouse_to_cell(GridConfig *grid_config, Map *map);
+static void handle_cell_selection(Map *map, int selected_cell, int *focused_cell);
 
 void input_init(InputState *state) {
-    state->selected_cell = NULL;
-    state->focused_cell = NULL;
+    state->selected_cell = MAP_NO_CELL;
+    state->focused_cell = MAP_NO_CELL;
     state->left_click = false;
     state->right_click = false;
     state->end_turn_requested = false;
+    state->toggle_profiler = false;
+    state->toggle_trace = false;
+    state->toggle_danger = false;
+    state->undo_requested = false;
+    state->redo_requested = false;
+    state->replay_faster = false;
+    state->replay_slower = false;
+    state->replay_pause = false;
 }
 
-void input_update(InputState *state, GridConfig *grid_config, Point *map) {
+void input_update(InputState *state, GridConfig *grid_config, Map *map) {
     // Get cell under mouse
     state->selected_cell = mouse_to_cell(grid_config, map);
     
@@ -45,66 +52,92 @@ void input_update(InputState *state, GridConfig *grid_config, Point *map) {
         }
     }
     
+    state->toggle_profiler = IsKeyPressed(KEY_F3);
+    state->toggle_trace = IsKeyPressed(KEY_F4);
+    state->toggle_danger = IsKeyPressed(KEY_D);
+    state->undo_requested = IsKeyPressed(KEY_Z);
+    state->redo_requested = IsKeyPressed(KEY_Y);
+    state->replay_faster = IsKeyPressed(KEY_EQUAL);
+    state->replay_slower = IsKeyPressed(KEY_MINUS);
+    state->replay_pause = IsKeyPressed(KEY_SPACE);
+
     // Could add keyboard shortcuts here, e.g.:
     // if (IsKeyPressed(KEY_SPACE)) state->end_turn_requested = true;
 }
 
-void input_handle_selection(InputState *state, GridConfig *grid_config, Point *map) {
+void input_handle_selection(InputState *state, GridConfig *grid_config, Map *map) {
+    (void)grid_config;
     if (!state->left_click) return;
-    if (state->selected_cell == NULL) return;
+    if (state->selected_cell == MAP_NO_CELL) return;
     
     // Don't process selection if clicking on UI elements
     if (state->end_turn_requested) return;
     
-    handle_cell_selection(grid_config, map, state->selected_cell, &state->focused_cell);
+    handle_cell_selection(map, state->selected_cell, &state->focused_cell);
 }
 
-void input_handle_movement(InputState *state, GridConfig *grid_config, Point *map) {
+void input_handle_movement(InputState *state, GridConfig *grid_config, Map *map, CommandLog *commands) {
+    (void)grid_config;
     if (!state->right_click) return;
-    if (state->selected_cell == NULL) return;
-    if (state->focused_cell == NULL) return;
+    if (state->selected_cell == MAP_NO_CELL) return;
+    if (state->focused_cell == MAP_NO_CELL) return;
     
-    Point *focused = state->focused_cell;
-    Point *selected = state->selected_cell;
+    int focused = state->focused_cell;
+    int selected = state->selected_cell;
+    Actor *focused_actor = map_get_occupant(map, focused);
+    Actor *selected_actor = map_get_occupant(map, selected);
     
     // Check if right-clicking on an enemy (attack)
-    if (focused->occupant != NULL &&
-        selected->occupant != NULL &&
-        actor_is_enemy(focused->occupant, selected->occupant) &&
-        focused->occupant->owner->has_turn &&
-        focused->occupant->can_act) {
+    if (focused_actor != NULL &&
+        selected_actor != NULL &&
+        actor_is_enemy(focused_actor, selected_actor) &&
+        focused_actor->owner->has_turn &&
+        focused_actor->can_act) {
         
         // Check if enemy is in attack range
-        if (combat_can_attack(grid_config, map, focused, selected)) {
+        if (combat_can_attack(map, focused, selected)) {
             printf("\n=== COMBAT ===\n");
-            CombatResult result = combat_execute_at_cells(grid_config, map, focused, selected);
+            command_log_attack(commands, map, focused, selected);
             printf("=== END COMBAT ===\n\n");
             
             // Clear focus after combat
-            state->focused_cell = NULL;
-            map_clear_range_flags(map, grid_config);
+            state->focused_cell = MAP_NO_CELL;
+            map_clear_range_flags(map);
             return;
         }
     }
     
     // Check if movement is valid (existing code)
-    if (focused->occupant != NULL &&
-        selected->in_range &&
-        selected->occupant == NULL &&
-        focused->occupant->can_move &&
-        focused->occupant->owner->has_turn) {
+    if (focused_actor != NULL &&
+        map_is_in_range(map, selected) &&
+        selected_actor == NULL &&
+        focused_actor->can_move &&
+        focused_actor->owner->has_turn) {
         
         // Perform movement
-        selected->occupant = focused->occupant;
-        focused->occupant = NULL;
-        selected->occupant->can_move = false;
+        command_log_move(commands, map, focused_actor, selected);
         
         // Clear focus after moving
-        state->focused_cell = NULL;
+        state->focused_cell = MAP_NO_CELL;
     }
     
     // Always flush flags on right click
-    map_clear_range_flags(map, grid_config);
+    map_clear_range_flags(map);
+}
+
+void input_handle_undo(InputState *state, Map *map, CommandLog *commands) {
+    bool changed = false;
+    if (state->undo_requested) {
+        changed = command_log_undo(commands, map);
+    } else if (state->redo_requested) {
+        changed = command_log_redo(commands, map);
+    }
+
+    // The shown ranges belong to a position that is gone
+    if (changed) {
+        state->focused_cell = MAP_NO_CELL;
+        map_clear_range_flags(map);
+    }
 }
 
 bool input_is_mouse_over_end_turn_button(RenderContext *ctx) {
@@ -129,39 +162,38 @@ bool input_is_mouse_over_end_turn_button(RenderContext *ctx) {
 // Internal helper functions
 // ============================================================================
 
-static Point *mouse_to_cell(GridConfig *grid_config, Point *map) {
+static int mouse_to_cell(GridConfig *grid_config, Map *map) {
     int x = (safe_mouse_x(grid_config) - grid_config->grid_offset_x) / 
             grid_config->grid_cell_size;
     int y = (safe_mouse_y(grid_config) - grid_config->grid_offset_y) / 
             grid_config->grid_cell_size;
     
-    return map + grid_config->max_grid_cells_x * y + x;
+    return map_get_cell(map, x, y);
 }
 
-static void handle_cell_selection(GridConfig *grid_config, Point *map, 
-                                   Point *selected_cell, Point **focused_cell) {
+static void handle_cell_selection(Map *map, int selected_cell, int *focused_cell) {
     // Flush previous range indicators
-    cell_flag_flush(map, grid_config);
+    map_clear_range_flags(map);
     
     // Update focused cell
     *focused_cell = selected_cell;
     
     // If there's an occupant, show their ranges
-    if (selected_cell->occupant != NULL) {
-        Actor *occupant = selected_cell->occupant;
+    Actor *occupant = map_get_occupant(map, selected_cell);
+    if (occupant != NULL) {
         
         // Only show ranges if it's their turn
         if (occupant->owner->has_turn) {
             // Show movement range if unit can still move
             if (occupant->can_move) {
-                map_calculate_movement_range(grid_config, map,
-                                   selected_cell, occupant->movement, true);
+                map_calculate_movement_range(map, selected_cell, occupant->movement, true);
             }
             
             // Show attack range if unit can still act
             if (occupant->can_act) {
-                map_calculate_attack_range(grid_config, map,
-                                selected_cell, occupant->attack_range, true);
+                map_calculate_attack_range(map, selected_cell, occupant->attack_range, true);
+                // Enemies it can reach and strike, moving first if it still may
+                map_calculate_strike_targets(map, selected_cell, occupant->attack_range, occupant->owner->id);
             }
         }
     }
@@ -3,16 +3,25 @@
 
 #include "types.h"
 #include "game/combat.h"
+#include "game/command_log.h"
 #include "render/rendering.h"
 #include <stdbool.h>
 
 // Input state structure - tracks what actions the player wants to take
 typedef struct {
-    Point *selected_cell;      // Cell currently under mouse
-    Point *focused_cell;       // Cell that has been clicked/selected
+    int selected_cell;         // Cell currently under mouse (MAP_NO_CELL if none)
+    int focused_cell;          // Cell that has been clicked/selected (MAP_NO_CELL if none)
     bool left_click;           // True if left mouse button was just pressed
     bool right_click;          // True if right mouse button was just pressed
     bool end_turn_requested;   // True if player wants to end turn
+    bool toggle_profiler;      // True on the frame F3 was pressed
+    bool toggle_trace;         // True on the frame F4 was pressed
+    bool toggle_danger;        // True on the frame D was pressed
+    bool undo_requested;       // True on the frame Z was pressed
+    bool redo_requested;       // True on the frame Y was pressed
+    bool replay_faster;        // True on the frame = was pressed
+    bool replay_slower;        // True on the frame - was pressed
+    bool replay_pause;         // True on the frame Space was pressed
 } InputState;
 
 // Initialize input state
@@ -20,13 +29,16 @@ void input_init(InputState *state);
 
 // Update input state based on current frame's input
 // Returns the cell currently under the mouse cursor
-void input_update(InputState *state, GridConfig *grid_config, Point *map);
+void input_update(InputState *state, GridConfig *grid_config, Map *map);
 
 // Handle left click selection logic
-void input_handle_selection(InputState *state, GridConfig *grid_config, Point *map);
+void input_handle_selection(InputState *state, GridConfig *grid_config, Map *map);
 
-// Handle right click movement logic
-void input_handle_movement(InputState *state, GridConfig *grid_config, Point *map);
+// Handle right click movement logic; moves and attacks go into `commands`
+void input_handle_movement(InputState *state, GridConfig *grid_config, Map *map, CommandLog *commands);
+
+// Take back or replay the player's last action this turn
+void input_handle_undo(InputState *state, Map *map, CommandLog *commands);
 
 // Check if mouse is over the end turn button
 bool input_is_mouse_over_end_turn_button(RenderContext *ctx);
@@ -1,4 +1,5 @@
-#include "core/utils.h"
+#include "input/utils.h"
+#include "raylib.h"
 #include <stdlib.h>
 
 int safe_mouse_x(GridConfig * grid_config) {
@@ -21,16 +22,6 @@ int safe_mouse_y(GridConfig * grid_config) {
   return mouse_pos;
 }
 
-// Helper function moved from main.c — used elsewhere (e.g., input.c)
-void cell_flag_flush(Point *cell_arr, GridConfig *grid) {
-  for (int y = 0; y < grid->max_grid_cells_y; y++) {
-    for (int x = 0; x < grid->max_grid_cells_x; x++) {
-      cell_arr[x + y * grid->max_grid_cells_x].in_range = false;
-      cell_arr[x + y * grid->max_grid_cells_x].in_attack_range = false;
-    }
-  }
-}
-
 GridConfig *grid_init(int g_off_x, int g_off_y, int g_cell_size,
                       int max_cell_x, int max_cell_y) {
   GridConfig *grid = malloc(sizeof(GridConfig));
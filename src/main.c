@@ -8,109 +8,230 @@
 #include "main.h"
 #include "types.h"
 #include "render/rendering.h"
-#include "core/utils.h"
+#include "render/art.h"
+#include "input/utils.h"
 #include "input/input.h"
 #include "game/map.h"
-#include "game/actor.h"
-#include "game/structure.h"
-#include "game/combat.h"
 #include "game/game_logic.h"
+#include "game/match.h"
+#include "game/replay.h"
 #include "ui/menu.h"
-#include "game/terrain.h"
-#include "game/biome_config.h"
-#include "render/unit_sprites.h"
-#include "render/structure_sprites.h"
-#include "game/faction_init.h"
-#include "game/structure_generation.h"
-#include "game/spawning.h"
-#include "game/actions.h"
-
-int main(void) {
+#include "game/map_io.h"
+#include "core/parallel.h"
+#include "core/profiler.h"
+#include "game/map_generation.h"
+
+typedef struct LaunchOptions {
+  MatchSettings match;       // map size, seed, generator and threads
+  const char *save_map_path; // write the generated terrain here
+  const char *trace_path;    // record a Chrome trace from startup, NULL to wait for F4
+  const char *record_path;   // every match is recorded here
+  const char *replay_path;   // play this recording back instead of a new match
+} LaunchOptions;
+
+// Windowed playback: recorded actions at an adjustable pace, turns in between
+typedef struct ReplayPlayback {
+  double speed;    // actions per second
+  double due;      // actions owed to the clock
+  bool paused;
+  bool finished;
+  int turns;       // turns whose checksum matched
+} ReplayPlayback;
+
+#define REPLAY_MIN_SPEED 1.0
+#define REPLAY_MAX_SPEED 4096.0
+
+static bool parse_launch_options(int argc, char **argv, LaunchOptions *options) {
+  match_settings_default(&options->match);
+  options->match.seed = (uint64_t)time(NULL);
+  options->save_map_path = NULL;
+  options->trace_path = NULL;
+  options->record_path = REPLAY_DEFAULT_PATH;
+  options->replay_path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    bool has_value = (i + 1 < argc);
+    if (strcmp(argv[i], "--map-size") == 0 && has_value) {
+      int w, h;
+      if (sscanf(argv[++i], "%dx%d", &w, &h) != 2 ||
+          w <= 0 || h <= 0 || w > MAX_MAP_SIDE || h > MAX_MAP_SIDE) {
+        fprintf(stderr, "Error: --map-size expects WxH with sides 1..%d\n", MAX_MAP_SIDE);
+        return false;
+      }
+      options->match.map_width = w;
+      options->match.map_height = h;
+    } else if (strcmp(argv[i], "--load-map") == 0 && has_value) {
+      options->match.load_map_path = argv[++i];
+    } else if (strcmp(argv[i], "--save-map") == 0 && has_value) {
+      options->save_map_path = argv[++i];
+    } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+      char *end;
+      options->match.seed = strtoull(argv[++i], &end, 10);
+      if (*argv[i] == '\0' || *end != '\0') {
+        fprintf(stderr, "Error: --seed expects an unsigned integer\n");
+        return false;
+      }
+    } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+      options->match.threads = atoi(argv[++i]);
+      if (options->match.threads <= 0) {
+        fprintf(stderr, "Error: --threads expects a positive count\n");
+        return false;
+      }
+    } else if (strcmp(argv[i], "--generator") == 0 && has_value) {
+      if (!map_generation_parse_generator(argv[++i], &options->match.generator)) {
+        fprintf(stderr, "Error: --generator expects cores or noise\n");
+        return false;
+      }
+    } else if (strcmp(argv[i], "--ai") == 0 && has_value) {
+      if (!game_parse_ai_mode(argv[++i], &options->match.ai_mode)) {
+        fprintf(stderr, "Error: --ai expects greedy, mcts or alphabeta\n");
+        return false;
+      }
+    } else if (strcmp(argv[i], "--ai-budget") == 0 && has_value) {
+      options->match.ai_search.budget_ms = atoi(argv[++i]);
+      if (options->match.ai_search.budget_ms <= 0) {
+        fprintf(stderr, "Error: --ai-budget expects a positive number of milliseconds\n");
+        return false;
+      }
+    } else if (strcmp(argv[i], "--ai-threads") == 0 && has_value) {
+      options->match.ai_search.threads = atoi(argv[++i]);
+      if (options->match.ai_search.threads <= 0) {
+        fprintf(stderr, "Error: --ai-threads expects a positive count\n");
+        return false;
+      }
+    } else if (strcmp(argv[i], "--trace") == 0 && has_value) {
+      options->trace_path = argv[++i];
+    } else if (strcmp(argv[i], "--record") == 0 && has_value) {
+      options->record_path = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && has_value) {
+      options->replay_path = argv[++i];
+    } else {
+      fprintf(stderr, "Usage: %s [--map-size WxH] [--load-map file] [--save-map file] [--seed N] [--threads N] [--generator cores|noise] [--ai greedy|mcts|alphabeta] [--ai-budget ms] [--ai-threads N] [--trace file] [--record file] [--replay file]\n",
+              argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Plays what the clock owes; turns passing in between cost nothing
+static void advance_replay(ReplayPlayback *playback, Replay *replay, Match *match, InputState *input) {
+  if (input->replay_faster && playback->speed < REPLAY_MAX_SPEED) playback->speed *= 2.0;
+  if (input->replay_slower && playback->speed > REPLAY_MIN_SPEED) playback->speed /= 2.0;
+  if (input->replay_pause) playback->paused = !playback->paused;
+  if (input->replay_faster || input->replay_slower || input->replay_pause) {
+    printf("Replay: %.0f actions/s%s\n", playback->speed, playback->paused ? ", paused" : "");
+  }
+  if (playback->paused || playback->finished) return;
+
+  playback->due += GetFrameTime() * playback->speed;
+  while (playback->due >= 1.0) {
+    ReplayStep step = replay_step(replay, match);
+    if (step == REPLAY_STEP_ACTION) {
+      playback->due -= 1.0;
+    } else if (step == REPLAY_STEP_TURN) {
+      playback->turns++;
+    } else {
+      if (step == REPLAY_STEP_END) {
+        printf("Replay finished: all %d turns matched the recording%s\n", playback->turns,
+               replay_is_complete(replay) ? "" : ", which stops early");
+      }
+      playback->finished = true;
+      break;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
   const int screenWidth = 1600;
   const int screenHeight = 1000;
-  srand(time(NULL));
 
+  LaunchOptions options;
+  if (!parse_launch_options(argc, argv, &options)) {
+    return 1;
+  }
+  Replay *replay = NULL;
+  if (options.replay_path != NULL) {
+    replay = replay_open(options.replay_path);
+    if (replay == NULL) {
+      return 1;
+    }
+    int threads = options.match.threads;
+    options.match = *replay_settings(replay);
+    options.match.threads = threads;
+  }
+  printf("Match seed: %llu, generator: %s\n", (unsigned long long)options.match.seed,
+         map_generation_generator_name(options.match.generator));
+  parallel_set_thread_count(options.match.threads);
+
+  // Start tracing before anything is loaded so startup shows up too
+  const char *trace_path = (options.trace_path != NULL) ? options.trace_path : DEFAULT_TRACE_PATH;
+#ifdef PROFILER_ENABLED
+  if (options.trace_path != NULL) {
+    trace_start(trace_path);
+  }
+#else
+  if (options.trace_path != NULL) {
+    fprintf(stderr, "Warning: --trace needs a build with PROFILER_ENABLED, ignoring it\n");
+  }
+  (void)trace_path;
+#endif
+
+  PROFILE_BEGIN("window_init");
   InitWindow(screenWidth, screenHeight, "WaterEmblemProto");
   SetTargetFPS(60);
+  PROFILE_END();
 
   // Show title screen
   MenuState menu_state;
   menu_init(&menu_state);
   
-  while (!WindowShouldClose() && menu_state.is_active) {
+  while (replay == NULL && !WindowShouldClose() && menu_state.is_active) {
     menu_update(&menu_state);
     menu_render(&menu_state, screenWidth, screenHeight);
     
     if (menu_get_selected(&menu_state) == MENU_QUIT) {
+      trace_stop();
+      replay_free(replay);
       CloseWindow();
       return 0;
     }
   }
 
-  // Initialize grid configuration
-  GridConfig *grid_config = grid_init(GRID_OFFSET_X, GRID_OFFSET_Y, GRID_CELL_SIZE,
-                                      MAX_GRID_CELLS_X, MAX_GRID_CELLS_Y);
-
-  // Load all terrains
-  Terrain terrains[TERRAIN_COUNT];
-  terrain_init_all(terrains, GRID_CELL_SIZE);
+  PROFILE_INIT();
 
-  // Create biome configurations
-  BiomeConfig biome_configs[3];
-  int num_biomes = biome_config_get_default(biome_configs, 3, terrains);
+  // Build the match: map, factions, troops, lairs and game state
+  PROFILE_BEGIN("match_create");
+  Match *match = (replay != NULL) ? replay_create_match(replay) : match_create(&options.match);
+  PROFILE_END();
+  if (match == NULL) {
+    trace_stop();
+    replay_free(replay);
+    CloseWindow();
+    return 1;
+  }
+  Map *map = match->map;
+  GameState *game_state = match->state;
+  if (options.save_map_path != NULL) {
+    map_io_save(map, options.save_map_path);
+  }
+  // A failed recording leaves the match playable
+  ReplayWriter *recorder = NULL;
+  if (replay == NULL) {
+    recorder = replay_record_start(match, &options.match, options.record_path);
+  }
+  ReplayPlayback playback = {4.0, 0.0, false, false, 0};
 
-  // Initialize map
-  Point *mapArr = map_create(grid_config, terrains[TERRAIN_PLAINS]);
-  int layers = 7;
-  map_generate_all_biomes(grid_config, mapArr, biome_configs, num_biomes, layers);
-  map_generate_deep_ter(mapArr, grid_config);
+  // Initialize grid configuration from the map that is actually in play
+  GridConfig *grid_config = grid_init(GRID_OFFSET_X, GRID_OFFSET_Y, GRID_CELL_SIZE,
+                                      map->width, map->height);
 
-  // Initialize rendering
+  // Initialize rendering and load the art every sprite id refers to
   RenderContext render_ctx;
   render_init(&render_ctx, grid_config);
-
-  // Initialize factions
-  Faction factions[3];
-  int num_factions = faction_init_default(factions, 3);
-
-  // Load unit sprites
-  UnitSprites unit_sprites = unit_sprites_load(GRID_CELL_SIZE);
-  // Load structure sprites
-  StructureSprites structure_sprites = structure_sprites_load(GRID_CELL_SIZE);
-  // Load action icons (skills)
-  actions_load_icons();
-
-  // Create units
-  ActorTemplate DEFAULT_MILITIA_TEMPLATE;
-  actor_get_default_militia_template(&DEFAULT_MILITIA_TEMPLATE);
-  Actor *dark_troops = actor_array_create_from_template(DARK_TROOP_NUM, &factions[DARKUS], 
-                                         unit_sprites.darkus_militia, &DEFAULT_MILITIA_TEMPLATE);
-  Actor *vent_troops = actor_array_create_from_template(VENT_TROOP_NUM, &factions[VENTUS], 
-                                         unit_sprites.ventus_militia, &DEFAULT_MILITIA_TEMPLATE);
-  // Assign actor arrays to their owning factions before placing them
-  factions[DARKUS].actors = dark_troops;
-  factions[DARKUS].actor_count = DARK_TROOP_NUM;
-
-  factions[VENTUS].actors = vent_troops;
-  factions[VENTUS].actor_count = VENT_TROOP_NUM;
-  // Place faction troops into their corners
-  spawning_place_faction_in_corner(mapArr, grid_config, &factions[DARKUS], 0, 4, 16);
-  spawning_place_faction_in_corner(mapArr, grid_config, &factions[VENTUS], 2, 4, 16);
-
-  // Place Warg Lairs first, then spawn Gaia wargs around those lairs
-  int lairs = structure_generation_place_warg_lairs(mapArr, grid_config, terrains, TERRAIN_COUNT, structure_sprites);
-  int gaia_warg_count = 0;
-  Actor *gaia_wargs = NULL;
-  if (lairs > 0) {
-    gaia_wargs = structure_generation_spawn_wargs_around_lairs(mapArr, grid_config, unit_sprites, &factions[GAIA], &gaia_warg_count);
-    if (gaia_wargs != NULL && gaia_warg_count > 0) {
-      factions[GAIA].actors = gaia_wargs;
-      factions[GAIA].actor_count = gaia_warg_count;
-    }
-  }
-
-  // Initialize game state
-  GameState *game_state = game_state_create(factions, num_factions);
+  PROFILE_BEGIN("art_load");
+  art_load(GRID_CELL_SIZE);
+  PROFILE_END();
 
   // Initialize input
   InputState input_state;
@@ -119,54 +240,89 @@ int main(void) {
 
   // Main game loop
   while (!WindowShouldClose()) {
+    // Frames are marked at the top so AI frames, which skip rendering, count too
+    PROFILE_FRAME();
     Faction *current_faction = game_get_current_faction(game_state);
+
+    // Replays only watch: units can be inspected, the recording does the rest
+    if (replay != NULL) {
+      input_update(&input_state, grid_config, map);
+      input_handle_selection(&input_state, grid_config, map);
+      advance_replay(&playback, replay, match, &input_state);
+      render_game(&render_ctx, map, input_state.focused_cell,
+                  game_get_current_faction(game_state), false);
+      continue;
+    }
     
     if (game_is_over(game_state)) {
-      render_game(&render_ctx, mapArr, input_state.focused_cell, 
+      render_game(&render_ctx, map, input_state.focused_cell, 
                        current_faction, false);
       continue;
     }
 
-    input_update(&input_state, grid_config, mapArr);
+    PROFILE_BEGIN("input_update");
+    input_update(&input_state, grid_config, map);
+    PROFILE_END();
+    if (input_state.toggle_danger) {
+      render_ctx.show_danger = !render_ctx.show_danger;
+    }
+#ifdef PROFILER_ENABLED
+    if (input_state.toggle_profiler) {
+      render_ctx.show_profiler = !render_ctx.show_profiler;
+    }
+    if (input_state.toggle_trace) {
+      if (trace_is_recording()) {
+        trace_stop();
+        printf("Trace written to %s\n", trace_path);
+      } else if (trace_start(trace_path)) {
+        printf("Recording trace to %s (F4 to stop)\n", trace_path);
+      }
+    }
+#endif
     
     // If it's an AI faction's turn, process AI actions automatically
     if (!game_is_player_turn(game_state) && !game_is_over(game_state)) {
-      game_process_ai_turn(game_state, mapArr, grid_config);
+      PROFILE_BEGIN("ai_turn");
+      game_process_ai_turn(game_state, map);
+      PROFILE_END();
       continue; // skip player input/render frame; AI processing and turn advancement handled
     }
     button_is_pressed = IsMouseButtonDown(MOUSE_BUTTON_LEFT) && 
                         input_is_mouse_over_end_turn_button(&render_ctx);
     
+    PROFILE_BEGIN("input_handle");
     if (input_state.left_click) {
-      input_handle_selection(&input_state, grid_config, mapArr);
+      input_handle_selection(&input_state, grid_config, map);
     }
 
     if (input_state.right_click) {
-      input_handle_movement(&input_state, grid_config, mapArr);
+      input_handle_movement(&input_state, grid_config, map, game_state->commands);
+    }
+    if (input_state.undo_requested || input_state.redo_requested) {
+      input_handle_undo(&input_state, map, game_state->commands);
     }
+    PROFILE_END();
 
     if (input_state.end_turn_requested) {
       game_end_current_turn(game_state);
     }
 
     // renders only after first click to avoid null focused_cell
-    render_game(&render_ctx, mapArr, input_state.focused_cell,
+    render_game(&render_ctx, map, input_state.focused_cell,
              current_faction, button_is_pressed);
   }
 
   // Cleanup
-  map_free(mapArr);
-  factions_free_actors(factions, num_factions);
-  // Unload any action icons we loaded earlier
-  actions_unload_icons();
-  game_state_free(game_state);
-  unit_sprites_unload(&unit_sprites);
-  structure_sprites_unload(&structure_sprites);
-  terrain_unload_all(terrains, TERRAIN_COUNT);
+  if (trace_is_recording()) {
+    trace_stop();
+    printf("Trace written to %s\n", trace_path);
+  }
+  replay_record_stop(recorder);
+  replay_free(replay);
+  match_free(match);
+  art_unload();
   free(grid_config);
 
-  // troop_groups removed; no extra cleanup required
-
   CloseWindow();
   return 0;
 }
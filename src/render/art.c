@@ -0,0 +1,104 @@
+#include "render/art.h"
+#include "game/terrain.h"
+#include "game/faction_init.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    SpriteId sprite;
+    const char *path;
+    bool fit_cell; // resized to one grid cell
+} ArtFile;
+
+static const ArtFile ART_FILES[] = {
+    {SPRITE_TERRAIN_PLAINS,       "../../resources/terrain/plains_ter.png",        true},
+    {SPRITE_TERRAIN_MOUNTAINS,    "../../resources/terrain/mountain_ter2.png",     true},
+    {SPRITE_TERRAIN_SEA,          "../../resources/terrain/sea_ter.png",           true},
+    {SPRITE_TERRAIN_ARCTIC,       "../../resources/terrain/arctic_ter.png",        true},
+    {SPRITE_TERRAIN_FOREST,       "../../resources/terrain/forest_ter2.png",       true},
+    {SPRITE_TERRAIN_DEEP_FOREST,  "../../resources/terrain/deep_forest_ter.png",   true},
+    {SPRITE_TERRAIN_DEEP_SEA,     "../../resources/terrain/deep_sea_ter.png",      true},
+    {SPRITE_TERRAIN_PLAYER_BASE,  "../../resources/terrain/base_ter.png",          true},
+    {SPRITE_UNIT_DARKUS_MILITIA,  "../../resources/units/darkus_militia.png",      true},
+    {SPRITE_UNIT_VENTUS_MILITIA,  "../../resources/units/ventus_militia.png",      true},
+    {SPRITE_UNIT_WARG,            "../../resources/units/warg.png",                true},
+    {SPRITE_STRUCTURE_WARG_LAIR,  "../../resources/structures/warg_lair.png",      true},
+    {SPRITE_ICON_SPEAR_STRIKE,    "../../resources/actions/spear_strike_icon.png", false},
+};
+
+static Texture2D textures[SPRITE_COUNT];
+
+// Forward declarations for internal helper functions
+static Texture2D load_cell_texture(const char *path, int cell_size);
+
+// ============================================================================
+// Textures
+// ============================================================================
+
+void art_load(int cell_size) {
+    for (size_t i = 0; i < sizeof(ART_FILES) / sizeof(ART_FILES[0]); i++) {
+        const ArtFile *file = &ART_FILES[i];
+        textures[file->sprite] = file->fit_cell ? load_cell_texture(file->path, cell_size)
+                                                : LoadTexture(file->path);
+    }
+}
+
+void art_unload(void) {
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        if (textures[i].id > 0) UnloadTexture(textures[i]);
+        textures[i] = (Texture2D){0};
+    }
+}
+
+Texture2D art_texture(SpriteId sprite) {
+    if (sprite <= SPRITE_NONE || sprite >= SPRITE_COUNT) return (Texture2D){0};
+    return textures[sprite];
+}
+
+// ============================================================================
+// Colors
+// ============================================================================
+
+Color art_terrain_color(int terrain_type) {
+    switch (terrain_type) {
+        case TERRAIN_PLAINS:      return GREEN;
+        case TERRAIN_MOUNTAINS:   return LIGHTGRAY;
+        case TERRAIN_SEA:         return BLUE;
+        case TERRAIN_ARCTIC:      return WHITE;
+        case TERRAIN_FOREST:      return DARKGREEN;
+        case TERRAIN_DEEP_FOREST: return BLACK;
+        case TERRAIN_DEEP_SEA:    return DARKBLUE;
+        case TERRAIN_PLAYER_BASE: return ORANGE;
+        default:                  return WHITE;
+    }
+}
+
+Color art_faction_primary(int faction_id) {
+    switch (faction_id) {
+        case DARKUS: return PURPLE;
+        case VENTUS: return GREEN;
+        case GAIA:   return BROWN;
+        default:     return GRAY;
+    }
+}
+
+Color art_faction_secondary(int faction_id) {
+    switch (faction_id) {
+        case DARKUS: return DARKGRAY;
+        case VENTUS: return WHITE;
+        case GAIA:   return BLACK;
+        default:     return DARKGRAY;
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static Texture2D load_cell_texture(const char *path, int cell_size) {
+    Image img = LoadImage(path);
+    ImageResize(&img, cell_size, cell_size);
+    Texture2D texture = LoadTextureFromImage(img);
+    UnloadImage(img);
+    return texture;
+}
@@ -0,0 +1,22 @@
+#ifndef ART_H_
+#define ART_H_
+
+#include "raylib.h"
+#include "types.h"
+
+// Resolves the sprite ids held by game state into textures and colors.
+// Load after InitWindow and unload before CloseWindow.
+void art_load(int cell_size);
+void art_unload(void);
+
+// Texture for a sprite id; an empty texture (id 0) when there is none
+Texture2D art_texture(SpriteId sprite);
+
+// Fill drawn under a terrain's sprite
+Color art_terrain_color(int terrain_type);
+
+// Faction colors, by faction id
+Color art_faction_primary(int faction_id);
+Color art_faction_secondary(int faction_id);
+
+#endif
@@ -0,0 +1,56 @@
+#include "render/profiler_overlay.h"
+#include "core/profiler.h"
+#include "raylib.h"
+
+#define OVERLAY_BAR_WIDTH 2
+#define OVERLAY_GRAPH_HEIGHT 80
+#define OVERLAY_GRAPH_MS 33.3   // frame time at the top of the graph
+#define OVERLAY_BUDGET_MS 16.7  // 60 FPS line
+#define OVERLAY_TOP_ZONES 6
+#define OVERLAY_FONT 18
+
+void profiler_overlay_draw(int x, int y) {
+    int width = PROFILER_FRAMES * OVERLAY_BAR_WIDTH;
+    int height = OVERLAY_GRAPH_HEIGHT + (3 + OVERLAY_TOP_ZONES) * (OVERLAY_FONT + 2) + 12;
+    DrawRectangle(x, y, width + 12, height, (Color){0, 0, 0, 190});
+
+    // Frame-time graph, newest frame on the right
+    int graph_x = x + 6;
+    int graph_y = y + 6;
+    int frames = profiler_frame_count();
+    for (int age = 0; age < frames; age++) {
+        double ms = profiler_frame_ms(age);
+        double scaled = ms / OVERLAY_GRAPH_MS;
+        if (scaled > 1.0) scaled = 1.0;
+        int bar_height = (int)(scaled * OVERLAY_GRAPH_HEIGHT);
+        if (bar_height < 1) bar_height = 1;
+        Color color = (ms <= OVERLAY_BUDGET_MS) ? GREEN : (ms <= OVERLAY_GRAPH_MS) ? ORANGE : RED;
+        DrawRectangle(graph_x + width - (age + 1) * OVERLAY_BAR_WIDTH,
+                      graph_y + OVERLAY_GRAPH_HEIGHT - bar_height,
+                      OVERLAY_BAR_WIDTH, bar_height, color);
+    }
+    int budget_y = graph_y + OVERLAY_GRAPH_HEIGHT -
+                   (int)(OVERLAY_BUDGET_MS / OVERLAY_GRAPH_MS * OVERLAY_GRAPH_HEIGHT);
+    DrawLine(graph_x, budget_y, graph_x + width, budget_y, (Color){255, 255, 255, 120});
+
+    // Percentiles and the latest frame
+    double p50, p95, p99;
+    profiler_percentiles(&p50, &p95, &p99);
+    int text_y = graph_y + OVERLAY_GRAPH_HEIGHT + 6;
+    DrawText(TextFormat("frame %.2f ms   p50 %.2f   p95 %.2f   p99 %.2f", profiler_frame_ms(0),
+                        p50, p95, p99),
+             graph_x, text_y, OVERLAY_FONT, RAYWHITE);
+    text_y += OVERLAY_FONT + 2;
+
+    // Zones by average inclusive time per frame
+    DrawText(TextFormat("%-20s %8s %8s", "zone", "avg ms", "max ms"), graph_x, text_y + 4,
+             OVERLAY_FONT, LIGHTGRAY);
+    text_y += OVERLAY_FONT + 6;
+    ProfilerZoneStat zones[OVERLAY_TOP_ZONES];
+    int count = profiler_top_zones(zones, OVERLAY_TOP_ZONES);
+    for (int i = 0; i < count; i++) {
+        DrawText(TextFormat("%-20s %8.2f %8.2f", zones[i].name, zones[i].avg_ms, zones[i].max_ms),
+                 graph_x, text_y, OVERLAY_FONT, RAYWHITE);
+        text_y += OVERLAY_FONT + 2;
+    }
+}
@@ -0,0 +1,8 @@
+#ifndef PROFILER_OVERLAY_H_
+#define PROFILER_OVERLAY_H_
+
+// Frame-time graph, p50/p95/p99 and the most expensive zones, drawn at
+// (x, y). Call between BeginDrawing and EndDrawing.
+void profiler_overlay_draw(int x, int y);
+
+#endif
@@ -1,16 +1,22 @@
 #include "render/rendering.h"
+#include "render/art.h"
+#include "render/profiler_overlay.h"
+#include "core/profiler.h"
 #include "types.h"
+#include "game/map.h"
+#include "game/flow_field.h"
 #include <stddef.h>
 
-static void render_map(RenderContext *ctx, Point *map, Point *focused_cell);
-static bool cell_is_focused(Point *cell, Point *focused_cell);
+// Danger-zone reach: a militia's movement, the most any unit has
+#define DANGER_ZONE_DISTANCE 4
 
-static bool cell_is_focused(Point *cell, Point *focused_cell) {
-    if (focused_cell == NULL) return false;
-    return (cell->x == focused_cell->x && cell->y == focused_cell->y);
+static void render_map(RenderContext *ctx, Map *map, int focused_cell, const FlowField *danger);
+static bool cell_is_focused(int cell, int focused_cell);
+
+static bool cell_is_focused(int cell, int focused_cell) {
+    if (focused_cell == MAP_NO_CELL) return false;
+    return cell == focused_cell;
 }
-void render_debug_info(RenderContext *ctx, Point *map);
-void render_cell_info(RenderContext *ctx, Point *focused_cell);
 static void render_ui(RenderContext *ctx, const char *faction_name, Faction *current_faction, bool button_pressed);
 static void render_map_border(RenderContext *ctx);
 
@@ -20,23 +26,41 @@ void render_init(RenderContext *ctx, GridConfig* grid) {
     ctx->grid_cell_size = grid->grid_cell_size;
     ctx->grid_cells_x = grid->max_grid_cells_x;
     ctx->grid_cells_y = grid->max_grid_cells_y;
+    ctx->show_profiler = false;
+    ctx->show_danger = false;
 }
 
 
 // New function to render game with full button state
-void render_game(RenderContext *ctx, Point *map, Point *focused_cell, 
+void render_game(RenderContext *ctx, Map *map, int focused_cell, 
                      Faction *current_faction, bool button_pressed) {
+    PROFILE_BEGIN("render_game");
     BeginDrawing();
     ClearBackground(RAYWHITE);
     
     render_debug_info(ctx, map);
-    render_map(ctx, map, focused_cell);
+    PROFILE_BEGIN("render_map");
+    // The AI's own distance field, so the overlay costs nothing extra on AI turns
+    const FlowField *danger = ctx->show_danger ? flow_field_for_faction(map, current_faction->id) : NULL;
+    render_map(ctx, map, focused_cell, danger);
+    PROFILE_END();
     render_map_border(ctx);
-    render_cell_info(ctx, focused_cell);
+    render_cell_info(ctx, map, focused_cell);
+    PROFILE_BEGIN("render_ui");
     render_ui(ctx, current_faction->name, current_faction, button_pressed);
-    render_actions(ctx, (focused_cell != NULL) ? focused_cell->occupant : NULL);
-    
+    render_actions(ctx, (focused_cell != MAP_NO_CELL) ? map_get_occupant(map, focused_cell) : NULL);
+    PROFILE_END();
+
+#ifdef PROFILER_ENABLED
+    if (ctx->show_profiler) {
+        profiler_overlay_draw(ctx->grid_offset_x, ctx->grid_offset_y);
+    }
+#endif
+
+    PROFILE_BEGIN("present");
     EndDrawing();
+    PROFILE_END();
+    PROFILE_END();
 }
 
 
@@ -63,77 +87,99 @@ static void render_map_border(RenderContext *ctx) {
 }
 
 // Private helper function (not in header, only used internally)
-static void render_map(RenderContext *ctx, Point *map, Point *focused_cell) {
-    int total_cells = ctx->grid_cells_x * ctx->grid_cells_y;
-    
-    for (int i = 0; i < total_cells; i++) {
-        Point *cell = &map[i];
-        int x_pos = ctx->grid_offset_x + cell->x * ctx->grid_cell_size;
-        int y_pos = ctx->grid_offset_y + cell->y * ctx->grid_cell_size;
+static void render_map(RenderContext *ctx, Map *map, int focused_cell, const FlowField *danger) {
+    int draw_calls = 0;
+    for (int i = 0; i < map->cell_count; i++) {
+        if (!map_is_valid_cell(map, i)) continue; // unused slot of an edge chunk
+
+        int x_pos = ctx->grid_offset_x + map_cell_x(map, i) * ctx->grid_cell_size;
+        int y_pos = ctx->grid_offset_y + map_cell_y(map, i) * ctx->grid_cell_size;
+        Terrain *terrain = &map->terrains[map->terrain[i]];
         
         // Draw terrain
         // Possibly add default error texture if terrain sprite is NULL
         DrawRectangle(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size, 
-                     cell->terrain.color);
-        DrawTexture(cell->terrain.sprite, x_pos, y_pos, WHITE);
+                     art_terrain_color(map->terrain[i]));
+        DrawTexture(art_texture(terrain->sprite), x_pos, y_pos, WHITE);
         
         // Draw structure (if present) and occupant after tint so they remain on top
 
         // Apply move/attack tints over the terrain (transparent fill)
-        if (!cell_is_focused(cell, focused_cell)) {
-            if (cell->in_range) {
+        if (!cell_is_focused(i, focused_cell)) {
+            if (bitboard_test(map->range_layer, map_cell_x(map, i), map_cell_y(map, i))) {
                 Color move_tint = (Color){0, 0, 255, 120};
                 DrawRectangle(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size, move_tint);
+                draw_calls++;
             }
-            if (cell->in_attack_range) {
+            if (bitboard_test(map->attack_layer, map_cell_x(map, i), map_cell_y(map, i))) {
                 Color attack_tint = (Color){255, 0, 0, 120};
                 DrawRectangle(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size, attack_tint);
+                draw_calls++;
+            }
+            if (bitboard_test(map->target_layer, map_cell_x(map, i), map_cell_y(map, i))) {
+                Color target_outline = (Color){255, 0, 0, 255};
+                DrawRectangleLines(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size, target_outline);
+                draw_calls++;
             }
         }
 
+        // Danger zone: an enemy that close can walk up and strike a unit here
+        if (danger != NULL && flow_field_distance(danger, i) <= DANGER_ZONE_DISTANCE) {
+            Color danger_tint = (Color){255, 140, 0, 90};
+            DrawRectangle(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size, danger_tint);
+            draw_calls++;
+        }
+
         // Draw selection tint (transparent yellow) if this is the focused cell
-        if (focused_cell != NULL && cell->x == focused_cell->x && cell->y == focused_cell->y) {
+        if (cell_is_focused(i, focused_cell)) {
             Color select_tint = (Color){255, 255, 0, 120};
             DrawRectangle(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size, select_tint);
+            draw_calls++;
         }
 
         // Draw structure (if present)
-        if (cell->structure != NULL) {
-            DrawTexture(cell->structure->sprite, x_pos, y_pos, WHITE);
+        if (map->structure[i] != 0) {
+            DrawTexture(art_texture(map_get_structure(map, i)->sprite), x_pos, y_pos, WHITE);
+            draw_calls++;
         }
         
         // Draw occupant
-        if (cell->occupant != NULL) {
-            DrawTexture(cell->occupant->sprite, x_pos, y_pos, WHITE);
+        Actor *occupant = (map->occupant[i] != 0) ? map_get_occupant(map, i) : NULL;
+        if (occupant != NULL) {
+            DrawTexture(art_texture(occupant->sprite), x_pos, y_pos, WHITE);
+            draw_calls++;
         }
         
         // Draw grid lines
         DrawRectangleLines(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size, GRAY);
+        draw_calls += 3; // terrain fill, terrain sprite and grid lines
         
         // Draw highlights
-        if (cell->occupant != NULL) {
+        if (occupant != NULL) {
             DrawRectangleLines(x_pos, y_pos, ctx->grid_cell_size, ctx->grid_cell_size,
-                             cell->occupant->owner->prim_color);
+                             art_faction_primary(occupant->owner->id));
+            draw_calls++;
         }
         // range/attack tints are drawn above terrain but below units/structures
     }
+    PROFILE_COUNTER("draw_calls", draw_calls);
 }
 
-void render_debug_info(RenderContext *ctx, Point *map) {
+void render_debug_info(RenderContext *ctx, Map *map) {
     int mouse_x = GetMouseX();
     int mouse_y = GetMouseY();
     // Use your safe_mouse functions here
     DrawText(TextFormat("MOUSE: %d %d", mouse_x, mouse_y), 40, 20, 20, DARKGRAY);
 }
 
-void render_cell_info(RenderContext *ctx, Point *focused_cell) {
-    if (focused_cell == NULL) return;
+void render_cell_info(RenderContext *ctx, Map *map, int focused_cell) {
+    if (focused_cell == MAP_NO_CELL) return;
     
     int info_x = ctx->grid_cells_x * ctx->grid_cell_size + ctx->grid_offset_x + 20;
     int info_y = ctx->grid_offset_y;
     
-    if (focused_cell->occupant != NULL) {
-        Actor *occupant = focused_cell->occupant;
+    Actor *occupant = map_get_occupant(map, focused_cell);
+    if (occupant != NULL) {
         DrawText(TextFormat("NAME: %s\nFAC: %s\nLVL: %d\nHP: %d/%d\nPATK: %d\nPDEF: %d\nMATK: %d\nMDEF: %d\nLCK: %d\nRNG: %d",
                            occupant->name, occupant->owner->name, 
                            occupant->level, occupant->curr_health, occupant->max_health,
@@ -149,15 +195,15 @@ void render_cell_info(RenderContext *ctx, Point *focused_cell) {
     info_y += 300;
     DrawLine(info_x, info_y, info_x + ctx->grid_cell_size * 8, info_y, BLACK);
     DrawText(TextFormat("TRN: %s\nPASS: %s",
-                       focused_cell->terrain.name,
-                       focused_cell->terrain.passable ? "Yes" : "No"),
+                       map_get_terrain(map, focused_cell)->name,
+                       map_get_terrain(map, focused_cell)->passable ? "Yes" : "No"),
                 info_x + 5, info_y + 5, 26, BLACK);
 
     info_y += 100;
     DrawLine(info_x, info_y, info_x + ctx->grid_cell_size * 8, info_y, BLACK);
 
-    if (focused_cell->structure != NULL) {
-        Structure *structure = focused_cell->structure;
+    Structure *structure = map_get_structure(map, focused_cell);
+    if (structure != NULL) {
         DrawText(TextFormat("STRCT: %s\nPASS: %s\nLOOT: %s",
                            structure->name, 
                            structure->passable ? "Yes" : "No",
@@ -199,13 +245,13 @@ static void render_ui(RenderContext *ctx, const char *faction_name,
     if (current_faction != NULL) {
         if (button_pressed) {
             // When pressed, use secondary color for background and primary for border
-            button_color = current_faction->sec_color;
-            border_color = current_faction->prim_color;
+            button_color = art_faction_secondary(current_faction->id);
+            border_color = art_faction_primary(current_faction->id);
             text_color = border_color;
         } else {
             // Normal state: primary color for background, darker version for border
-            button_color = current_faction->prim_color;
-            border_color = current_faction->sec_color;
+            button_color = art_faction_primary(current_faction->id);
+            border_color = art_faction_secondary(current_faction->id);
             text_color = border_color;
         }
     } else {
@@ -253,12 +299,12 @@ void render_actions(RenderContext *ctx, Actor *actor) {
         DrawRectangleLines(bx, by, box_w, box_h, GRAY);
 
         if (actor != NULL && i < actor->skill_count) {
-            Skill *s = &actor->skills[i];
-            if (s->icon.id) {
-                Rectangle src = (Rectangle){0, 0, (float)s->icon.width, (float)s->icon.height};
+            Texture2D icon = art_texture(actor->skills[i].icon);
+            if (icon.id) {
+                Rectangle src = (Rectangle){0, 0, (float)icon.width, (float)icon.height};
                 Rectangle dst = (Rectangle){(float)bx, (float)by, (float)box_w, (float)box_h};
                 Vector2 origin = (Vector2){0.0f, 0.0f};
-                DrawTexturePro(s->icon, src, dst, origin, 0.0f, WHITE);
+                DrawTexturePro(icon, src, dst, origin, 0.0f, WHITE);
             } else {
                 // No icon: draw a simple inner placeholder
                 DrawRectangle(bx + 4, by + 4, box_w - 8, box_h - 8, (Color){150,150,150,200});
@@ -12,13 +12,15 @@ typedef struct {
     int grid_cell_size;
     int grid_cells_x;
     int grid_cells_y;
+    bool show_profiler; // frame profiler overlay (PROFILER_ENABLED builds)
+    bool show_danger;   // tint cells an enemy of the current faction can strike next turn
 } RenderContext;
 
 void render_init(RenderContext *ctx, GridConfig * grid);
-void render_debug_info(RenderContext *ctx, Point *map);
-void render_cell_info(RenderContext *ctx, Point *focused_cell);
-void render_combat_forecast(Point *attacker_cell, Point *defender_cell);
-void render_game(RenderContext *ctx, Point *map, Point *focused_cell, 
+void render_debug_info(RenderContext *ctx, Map *map);
+void render_cell_info(RenderContext *ctx, Map *map, int focused_cell);
+void render_combat_forecast(Map *map, int attacker_cell, int defender_cell);
+void render_game(RenderContext *ctx, Map *map, int focused_cell, 
                      Faction *current_faction, bool button_pressed);
 void render_actions(RenderContext *ctx, Actor *actor);
 #endif
@@ -1,8 +1,30 @@
 #ifndef TYPES_H_
 #define TYPES_H_
 
-#include "raylib.h"
 #include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_FACTIONS 8
+
+// Art is referenced by id only; the renderer decides what each id looks like,
+// so game state never holds textures or colors
+typedef enum {
+  SPRITE_NONE = 0,
+  SPRITE_TERRAIN_PLAINS,
+  SPRITE_TERRAIN_MOUNTAINS,
+  SPRITE_TERRAIN_SEA,
+  SPRITE_TERRAIN_ARCTIC,
+  SPRITE_TERRAIN_FOREST,
+  SPRITE_TERRAIN_DEEP_FOREST,
+  SPRITE_TERRAIN_DEEP_SEA,
+  SPRITE_TERRAIN_PLAYER_BASE,
+  SPRITE_UNIT_DARKUS_MILITIA,
+  SPRITE_UNIT_VENTUS_MILITIA,
+  SPRITE_UNIT_WARG,
+  SPRITE_STRUCTURE_WARG_LAIR,
+  SPRITE_ICON_SPEAR_STRIKE,
+  SPRITE_COUNT
+} SpriteId;
 
 typedef struct Coord {
   int x;
@@ -18,23 +40,22 @@ typedef struct Skill {
   int range;
   Coord *area_of_effect; // Array of relative coordinates defining the AoE
   int aoe_size;          // Number of coordinates in the AoE array
-  Texture2D icon;        // Icon representing the skill
+  SpriteId icon;         // Icon representing the skill
 } Skill;
 struct Terrain;
 typedef struct Terrain Terrain;
 
 struct Terrain {
   int id;
-  Color color;
-  Texture2D sprite;
+  SpriteId sprite;
   bool passable;
-  Terrain * deep_version;
-  char name[10];
+  int move_cost; // movement points spent entering this terrain
+  int deep_version; // TerrainType index of the deep variant (TERRAIN_NONE if none)
+  char name[16];
 };
 
 typedef struct Faction {
-  Color prim_color;
-  Color sec_color;
+  int id; // index into the match's faction array
   bool has_turn;
   bool playable;
   char name[10];
@@ -44,8 +65,12 @@ typedef struct Faction {
 } Faction;
 
 typedef struct Actor {
-  Texture2D sprite;
+  SpriteId sprite;
   Faction *owner;
+  int id;   // map occupant handle, 0 until placed on a map
+  int cell; // current map cell, -1 while off the map
+  uint64_t *hash;    // map hash its hit points and flags are folded into, NULL until placed
+  uint64_t hash_key; // its current part of *hash
   bool can_move;
   bool can_act;
 
@@ -74,24 +99,72 @@ typedef struct Actor {
 } Actor;
 
 typedef struct Structure {
-  Texture2D sprite;
+  SpriteId sprite;
   bool passable; // can units enter this tile when structure present
   bool lootable; // can be looted
   char name[16];
+  int cell; // where map_place_structure put it, -1 while off the map
 } Structure;
 
-typedef struct Point {
-  int x;
-  int y;
-  Actor *occupant;
-  bool in_range;
-  bool in_attack_range;
-  Structure *structure;
-  Terrain terrain;
-} Point;
+struct ReachMap;
+struct PathFinder;
+struct FlowField;
+struct InfluenceMap;
+struct SpatialIndex;
+struct Bitboard;
+
+// The battlefield, stored as parallel per-cell arrays. Cells are grouped into
+// square chunks, each a contiguous run of slots, and addressed by index; use
+// the map_* accessors instead of computing indices by hand.
+typedef struct Map {
+  int width;
+  int height;
+  int chunks_x;
+  int chunks_y;
+  int chunk_count;
+  int cell_count; // storage slots (chunk_count * MAP_CHUNK_CELLS), not all on the map
+
+  uint8_t *terrain;     // TerrainType index into `terrains`
+  uint16_t *occupant;   // actor handle, 0 when empty
+  uint16_t *structure;  // structure handle, 0 when none
+
+  // One-bit-per-cell layers
+  struct Bitboard *range_layer;                  // movement range of the selection
+  struct Bitboard *attack_layer;                 // attack range of the selection
+  struct Bitboard *strike_layer;                 // cells the selection can strike after moving
+  struct Bitboard *target_layer;                 // enemies standing in strike_layer
+  struct Bitboard *passable_layer;               // terrain and structures allow entry
+  struct Bitboard *occupancy_layer[MAX_FACTIONS]; // cells held by each faction
+
+  Terrain *terrains;    // shared terrain table (TERRAIN_COUNT entries)
+
+  // Handle tables: handle h refers to entry h - 1
+  Actor **actors;
+  int actor_count;
+  int actor_capacity;
+  Structure **structures;
+  int structure_count;
+  int structure_capacity;
+
+  struct ReachMap *reach; // scratch for range searches
+  struct PathFinder *paths; // scratch for A* queries
+  struct FlowField *flow[MAX_FACTIONS]; // distance fields towards each faction's enemies, built on first use
+  struct SpatialIndex *spatial; // per-faction unit buckets for enemy queries
+  struct InfluenceMap *influence; // per-faction threat and support, built on first use
+
+  // Zobrist hash (see map_hash): occupants, structures and the state of
+  // placed actors in one word, terrain cached per chunk
+  uint64_t hash;
+  uint64_t *terrain_hash;
+  bool *terrain_stale;  // chunk repainted since its terrain_hash was taken
+
+  // Change journal (see map_change_count)
+  int *change_log;        // ring of cells whose occupant or structure changed
+  uint64_t change_count;  // changes recorded so far
+} Map;
 
 typedef struct {
-  Terrain terrain;
+  int terrain;   // TerrainType painted by this biome
   int max_cores; // Maximum number of biome cores
   int max_range; // Maximum spread range
 } BiomeConfig;
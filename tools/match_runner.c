@@ -0,0 +1,316 @@
+#include "game/match.h"
+#include "game/faction_init.h"
+#include "game/map.h"
+#include "game/map_generation.h"
+#include "game/replay.h"
+#include "core/rng.h"
+#include "core/log.h"
+#include "core/parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Headless AI-vs-AI batch runner: plays full matches on worker threads,
+// one match per task, and summarizes the outcomes.
+
+#define RUNNER_DRAW -1   // winner index for matches stopped at the turn cap
+#define RUNNER_FAILED -2 // winner index for matches that could not be set up
+
+typedef struct RunnerOptions {
+    int matches;
+    uint64_t seed;      // batch seed; match i plays on rng_mix(seed, i)
+    int threads;        // worker threads, one match each at a time
+    int turn_cap;
+    const char *record_dir; // write a replay of match i to record_dir/match_i.replay
+    MatchSettings match;
+} RunnerOptions;
+
+// One slot per match, written only by the task that plays it
+typedef struct MatchResult {
+    uint64_t seed;
+    int winner;         // faction id, RUNNER_DRAW or RUNNER_FAILED
+    int turns;
+    AiSearchStats search;
+} MatchResult;
+
+typedef struct RunnerBatch {
+    const RunnerOptions *options;
+    MatchResult *results;
+} RunnerBatch;
+
+// Forward declarations for internal helper functions
+static bool parse_options(int argc, char **argv, RunnerOptions *options);
+static int parse_faction(const char *name);
+static void print_usage(const char *program);
+static void play_match(void *ctx, int index);
+static void print_summary(const RunnerOptions *options, const MatchResult *results, double seconds);
+static double now_seconds(void);
+
+int main(int argc, char **argv) {
+    RunnerOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    MatchResult *results = calloc((size_t)options.matches, sizeof(MatchResult));
+    if (results == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for match results\n");
+        return 1;
+    }
+
+    // Parallelism comes from running many matches at once, so everything
+    // inside a match (generation, lair scans) stays on its worker thread
+    log_set_enabled(false);
+    parallel_set_thread_count(1);
+
+    RunnerBatch batch = {&options, results};
+    double start = now_seconds();
+    parallel_for(options.matches, options.threads, play_match, &batch);
+    double seconds = now_seconds() - start;
+
+    print_summary(&options, results, seconds);
+
+    int failed = 0;
+    for (int i = 0; i < options.matches; i++) {
+        if (results[i].winner == RUNNER_FAILED) failed++;
+    }
+    free(results);
+    return (failed > 0) ? 1 : 0;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static bool parse_options(int argc, char **argv, RunnerOptions *options) {
+    options->matches = 1000;
+    options->seed = 1;
+    options->threads = parallel_cpu_count();
+    options->turn_cap = 200;
+    options->record_dir = NULL;
+    match_settings_default(&options->match);
+    options->match.threads = 1;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = (i + 1 < argc);
+        if (strcmp(argv[i], "--matches") == 0 && has_value) {
+            options->matches = atoi(argv[++i]);
+            if (options->matches <= 0) {
+                fprintf(stderr, "Error: --matches expects a positive count\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            char *end;
+            options->seed = strtoull(argv[++i], &end, 10);
+            if (*argv[i] == '\0' || *end != '\0') {
+                fprintf(stderr, "Error: --seed expects an unsigned integer\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            options->threads = atoi(argv[++i]);
+            if (options->threads <= 0) {
+                fprintf(stderr, "Error: --threads expects a positive count\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--turn-cap") == 0 && has_value) {
+            options->turn_cap = atoi(argv[++i]);
+            if (options->turn_cap <= 0) {
+                fprintf(stderr, "Error: --turn-cap expects a positive count\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--record") == 0 && has_value) {
+            options->record_dir = argv[++i];
+        } else if (strcmp(argv[i], "--troops") == 0 && has_value) {
+            options->match.troops = atoi(argv[++i]);
+            if (options->match.troops <= 0) {
+                fprintf(stderr, "Error: --troops expects a positive count\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--map-size") == 0 && has_value) {
+            int w, h;
+            if (sscanf(argv[++i], "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0 ||
+                w > MAX_MAP_SIDE || h > MAX_MAP_SIDE) {
+                fprintf(stderr, "Error: --map-size expects WxH with sides 1..%d\n", MAX_MAP_SIDE);
+                return false;
+            }
+            options->match.map_width = w;
+            options->match.map_height = h;
+        } else if (strcmp(argv[i], "--generator") == 0 && has_value) {
+            if (!map_generation_parse_generator(argv[++i], &options->match.generator)) {
+                fprintf(stderr, "Error: --generator expects cores or noise\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--ai") == 0 && has_value) {
+            if (!game_parse_ai_mode(argv[++i], &options->match.ai_mode)) {
+                fprintf(stderr, "Error: --ai expects greedy, mcts or alphabeta\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--ai-faction") == 0 && has_value) {
+            options->match.ai_faction = parse_faction(argv[++i]);
+            if (options->match.ai_faction == -1) {
+                fprintf(stderr, "Error: --ai-faction expects darkus, ventus or gaia\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--ai-budget") == 0 && has_value) {
+            options->match.ai_search.budget_ms = atoi(argv[++i]);
+            if (options->match.ai_search.budget_ms < 0) {
+                fprintf(stderr, "Error: --ai-budget expects milliseconds (0 for no deadline)\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--ai-playouts") == 0 && has_value) {
+            options->match.ai_search.max_playouts = atoi(argv[++i]);
+            if (options->match.ai_search.max_playouts < 0) {
+                fprintf(stderr, "Error: --ai-playouts expects a count (0 for no cap)\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--ai-depth") == 0 && has_value) {
+            options->match.ai_search.max_depth = atoi(argv[++i]);
+            if (options->match.ai_search.max_depth < 0) {
+                fprintf(stderr, "Error: --ai-depth expects a ply count (0 for no cap)\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--ai-threads") == 0 && has_value) {
+            options->match.ai_search.threads = atoi(argv[++i]);
+            if (options->match.ai_search.threads <= 0) {
+                fprintf(stderr, "Error: --ai-threads expects a positive count\n");
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    const AiSearchSettings *search = &options->match.ai_search;
+    if (search->budget_ms == 0) {
+        if (options->match.ai_mode == AI_MODE_MCTS && search->max_playouts == 0) {
+            fprintf(stderr, "Error: --ai-budget 0 needs an --ai-playouts cap\n");
+            return false;
+        }
+        if (options->match.ai_mode == AI_MODE_ALPHABETA && search->max_depth == 0) {
+            fprintf(stderr, "Error: --ai-budget 0 needs an --ai-depth cap\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+// Faction id for a lower-case faction name, or -1
+static int parse_faction(const char *name) {
+    if (strcmp(name, "darkus") == 0) return DARKUS;
+    if (strcmp(name, "ventus") == 0) return VENTUS;
+    if (strcmp(name, "gaia") == 0) return GAIA;
+    return -1;
+}
+
+static void print_usage(const char *program) {
+    fprintf(stderr, "Usage: %s [--matches N] [--seed N] [--threads N] [--turn-cap N] [--troops N] "
+                    "[--map-size WxH] [--generator cores|noise] [--ai greedy|mcts|alphabeta] "
+                    "[--ai-faction darkus|ventus|gaia] [--ai-budget ms] [--ai-playouts N] [--ai-depth N] "
+                    "[--ai-threads N] [--record dir]\n", program);
+}
+
+// Each match builds and frees everything it touches; the batch options are
+// only read, and each task writes only its own result slot
+static void play_match(void *ctx, int index) {
+    RunnerBatch *batch = ctx;
+    const RunnerOptions *options = batch->options;
+    MatchResult *result = &batch->results[index];
+
+    MatchSettings settings = options->match;
+    settings.seed = rng_mix(options->seed, (uint64_t)index);
+    result->seed = settings.seed;
+
+    Match *match = match_create(&settings);
+    if (match == NULL) {
+        fprintf(stderr, "Error: Match %d (seed %llu) could not be set up\n", index,
+                (unsigned long long)settings.seed);
+        result->winner = RUNNER_FAILED;
+        return;
+    }
+
+    match_set_all_ai(match);
+    ReplayWriter *recorder = NULL;
+    if (options->record_dir != NULL) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/match_%d.replay", options->record_dir, index);
+        recorder = replay_record_start(match, &settings, path);
+    }
+    Faction *winner = match_play_ai(match, options->turn_cap);
+    replay_record_stop(recorder);
+    result->winner = (winner != NULL) ? winner->id : RUNNER_DRAW;
+    result->turns = match_turns_played(match, options->turn_cap);
+    result->search = match->state->ai_stats;
+    match_free(match);
+}
+
+static void print_summary(const RunnerOptions *options, const MatchResult *results, double seconds) {
+    // Faction names come from the default setup every match uses
+    Faction factions[MATCH_FACTIONS];
+    int num_factions = faction_init_default(factions, MATCH_FACTIONS);
+
+    int wins[MATCH_FACTIONS] = {0};
+    int draws = 0;
+    int failed = 0;
+    long long total_turns = 0;
+    for (int i = 0; i < options->matches; i++) {
+        const MatchResult *r = &results[i];
+        if (r->winner == RUNNER_FAILED) {
+            failed++;
+            continue;
+        }
+        if (r->winner == RUNNER_DRAW) {
+            draws++;
+        } else if (r->winner >= 0 && r->winner < num_factions) {
+            wins[r->winner]++;
+        }
+        total_turns += r->turns;
+    }
+    int played = options->matches - failed;
+
+    AiSearchStats search = {0};
+    for (int i = 0; i < options->matches; i++) {
+        search.playouts += results[i].search.playouts;
+        search.nodes += results[i].search.nodes;
+        search.tt_probes += results[i].search.tt_probes;
+        search.tt_hits += results[i].search.tt_hits;
+        search.depth_sum += results[i].search.depth_sum;
+        search.seconds += results[i].search.seconds;
+        search.searches += results[i].search.searches;
+    }
+
+    printf("Matches: %d (batch seed %llu, %dx%d, %s, turn cap %d, %d threads)\n",
+           options->matches, (unsigned long long)options->seed, options->match.map_width,
+           options->match.map_height, map_generation_generator_name(options->match.generator),
+           options->turn_cap, options->threads);
+    for (int f = 0; f < num_factions; f++) {
+        printf("  %-10s %8d wins %6.1f%%\n", factions[f].name, wins[f],
+               played > 0 ? 100.0 * wins[f] / played : 0.0);
+    }
+    printf("  %-10s %8d      %6.1f%%\n", "Draw (cap)", draws,
+           played > 0 ? 100.0 * draws / played : 0.0);
+    if (failed > 0) {
+        printf("  %-10s %8d\n", "Failed", failed);
+    }
+    printf("Average turns: %.1f\n", played > 0 ? (double)total_turns / played : 0.0);
+    if (search.searches > 0 && options->match.ai_mode == AI_MODE_MCTS) {
+        printf("AI mcts: %d decisions, %lld playouts, %.0f playouts/s while searching\n",
+               search.searches, search.playouts,
+               search.seconds > 0.0 ? search.playouts / search.seconds : 0.0);
+    }
+    if (search.searches > 0 && options->match.ai_mode == AI_MODE_ALPHABETA) {
+        printf("AI alphabeta: %d decisions, %lld nodes, %.0f nodes/s while searching, "
+               "average depth %.1f, TT hit rate %.1f%%\n",
+               search.searches, search.nodes, search.seconds > 0.0 ? search.nodes / search.seconds : 0.0,
+               (double)search.depth_sum / search.searches,
+               search.tt_probes > 0 ? 100.0 * search.tt_hits / search.tt_probes : 0.0);
+    }
+    printf("Elapsed: %.2f s, %.1f matches/s\n", seconds,
+           seconds > 0.0 ? options->matches / seconds : 0.0);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
@@ -0,0 +1,143 @@
+#include "game/replay.h"
+#include "game/map_generation.h"
+#include "core/log.h"
+#include "core/parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Headless replay player: plays a recorded match back as fast as the
+// simulation allows, checks every turn's checksum and times the playback.
+// Reproduces bug reports without a window and benchmarks the simulation on
+// real games.
+
+typedef struct PlaybackResult {
+    int actions;
+    int turns;
+    ReplayStep last;    // REPLAY_STEP_END or REPLAY_STEP_DIVERGED
+    int turn_number;    // the match's turn when playback stopped
+    char winner[20];    // empty while undecided
+    double setup_seconds;
+    double play_seconds;
+} PlaybackResult;
+
+// Forward declarations for internal helper functions
+static bool play(Replay *replay, PlaybackResult *result);
+static double now_seconds(void);
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    int repeat = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+            if (repeat <= 0) {
+                fprintf(stderr, "Error: --repeat expects a positive count\n");
+                return 1;
+            }
+        } else if (path == NULL && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL) {
+        fprintf(stderr, "Usage: %s file.replay [--repeat N]\n", argv[0]);
+        return 1;
+    }
+
+    Replay *replay = replay_open(path);
+    if (replay == NULL) return 1;
+
+    log_set_enabled(false);
+    parallel_set_thread_count(1);
+
+    const MatchSettings *settings = replay_settings(replay);
+    printf("Replay: seed %llu, %s, %d troops, AI %s\n", (unsigned long long)settings->seed,
+           map_generation_generator_name(settings->generator), settings->troops,
+           game_ai_mode_name(settings->ai_mode));
+    if (settings->load_map_path != NULL) {
+        printf("  on saved terrain %s\n", settings->load_map_path);
+    } else {
+        printf("  on a generated %dx%d map\n", settings->map_width, settings->map_height);
+    }
+
+    // Every run plays the same records; the fastest one is reported
+    PlaybackResult best = {0};
+    for (int run = 0; run < repeat; run++) {
+        PlaybackResult result;
+        if (!play(replay, &result)) {
+            replay_free(replay);
+            return 1;
+        }
+        if (run == 0 || result.play_seconds < best.play_seconds) best = result;
+        if (result.last == REPLAY_STEP_DIVERGED) break;
+    }
+
+    printf("Played: %d actions over %d faction turns, ", best.actions, best.turns);
+    if (best.winner[0] != '\0') {
+        printf("%s won on turn %d\n", best.winner, best.turn_number);
+    } else {
+        printf("undecided on turn %d\n", best.turn_number);
+    }
+    if (!replay_is_complete(replay)) {
+        printf("  the recording stops early; the game may have crashed or been killed\n");
+    }
+    if (best.last == REPLAY_STEP_DIVERGED) {
+        printf("Checksums: DIVERGED after %d matching turns\n", best.turns);
+    } else {
+        printf("Checksums: all %d turns match\n", best.turns);
+    }
+    printf("Time: %.2f ms match setup, %.3f ms playback (best of %d), %.0f actions/s, %.0f turns/s\n",
+           best.setup_seconds * 1e3, best.play_seconds * 1e3, repeat,
+           best.play_seconds > 0.0 ? best.actions / best.play_seconds : 0.0,
+           best.play_seconds > 0.0 ? best.turns / best.play_seconds : 0.0);
+
+    replay_free(replay);
+    return (best.last == REPLAY_STEP_DIVERGED) ? 1 : 0;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+// One run from match setup to the last record. Returns false when the
+// match cannot be set up.
+static bool play(Replay *replay, PlaybackResult *result) {
+    memset(result, 0, sizeof(*result));
+
+    double start = now_seconds();
+    Match *match = replay_create_match(replay);
+    if (match == NULL) return false;
+    result->setup_seconds = now_seconds() - start;
+
+    start = now_seconds();
+    for (;;) {
+        ReplayStep step = replay_step(replay, match);
+        if (step == REPLAY_STEP_ACTION) {
+            result->actions++;
+        } else if (step == REPLAY_STEP_TURN) {
+            result->turns++;
+        } else {
+            result->last = step;
+            break;
+        }
+    }
+    result->play_seconds = now_seconds() - start;
+
+    GameState *state = match->state;
+    if (game_is_over(state) && state->winner != NULL) {
+        snprintf(result->winner, sizeof(result->winner), "%s", state->winner->name);
+    }
+    result->turn_number = state->turn_number;
+    match_free(match);
+    return true;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}